@@ -0,0 +1,178 @@
+#include "AliasTable.h"
+#include "GameCard.h"
+#include <cmath>
+#include <typeinfo>
+
+// Constructor implementations
+AliasTable::AliasTable() : liveWeight(0.0), builtWeight(0.0), liveCount(0) {}
+
+AliasTable::AliasTable(const vector<double>& itemWeights) : AliasTable() {
+    build(itemWeights);
+}
+
+// Core functionality implementations
+void AliasTable::build(const vector<double>& itemWeights) {
+    if (itemWeights.size() >= (size_t(1) << 32)) {
+        throw runtime_error("Too many entries for an alias table");
+    }
+    double total = 0.0;
+    size_t positive = 0;
+    for (double weight : itemWeights) {
+        if (!(weight >= 0.0) || isinf(weight)) {
+            throw runtime_error("Draw weights must be finite and not negative");
+        }
+        total += weight;
+        positive += weight > 0.0;
+    }
+    if (positive == 0) {
+        throw runtime_error("At least one card must have a positive draw weight");
+    }
+    weights = itemWeights;
+    removed.assign(weights.size(), false);
+    // Zero-weight entries can never be picked, so they count as removed already
+    for (size_t i = 0; i < weights.size(); i++) {
+        removed[i] = weights[i] == 0.0;
+    }
+    liveWeight = total;
+    liveCount = positive;
+    buildColumns();
+}
+
+void AliasTable::build(const vector<Card*>& cards, DrawWeighting weighting) {
+    vector<double> cardWeights(cards.size());
+    if (weighting == WEIGHT_BY_RARITY) {
+        // Few card classes appear in a deck, so ask dynamic_cast once per class
+        vector<pair<const type_info*, bool>> knownTypes;
+        for (size_t i = 0; i < cards.size(); i++) {
+            const type_info* type = &typeid(*cards[i]);
+            int known = -1;
+            for (size_t k = 0; k < knownTypes.size(); k++) {
+                if (knownTypes[k].first == type) known = static_cast<int>(k);
+            }
+            if (known < 0) {
+                knownTypes.push_back({type, dynamic_cast<const GameCard*>(cards[i]) != nullptr});
+                known = static_cast<int>(knownTypes.size()) - 1;
+            }
+            int rarity = knownTypes[known].second ? static_cast<const GameCard*>(cards[i])->getRarity() : 1;
+            cardWeights[i] = ldexp(1.0, 1 - rarity);
+        }
+    } else {
+        for (size_t i = 0; i < cards.size(); i++) {
+            cardWeights[i] = weightOf(*cards[i], weighting);
+        }
+    }
+    build(cardWeights);
+}
+
+size_t AliasTable::sample(mt19937_64& rng) const {
+    if (liveCount == 0) {
+        throw runtime_error("Cannot sample from an empty alias table");
+    }
+    size_t columns = threshold.size();
+    while (true) {
+        // High half of the random number picks the column, low half the coin
+        uint64_t bits = rng();
+        size_t column = static_cast<size_t>(((bits >> 32) * columns) >> 32);
+        size_t index = static_cast<uint32_t>(bits) < threshold[column] ? column : alias[column];
+        if (!removed[index]) {
+            return index;
+        }
+    }
+}
+
+void AliasTable::remove(size_t index) {
+    if (index >= weights.size()) {
+        throw runtime_error("Alias table index out of range");
+    }
+    if (removed[index]) {
+        throw runtime_error("Alias table entry was already removed");
+    }
+    removed[index] = true;
+    liveWeight -= weights[index];
+    weights[index] = 0.0;
+    liveCount--;
+    // Retries land on removed entries with chance 1 - live/built; keep that under half
+    if (liveCount > 0 && liveWeight < builtWeight / 2) {
+        buildColumns();
+    }
+}
+
+size_t AliasTable::size() const {
+    return weights.size();
+}
+
+size_t AliasTable::getLiveCount() const {
+    return liveCount;
+}
+
+double AliasTable::getLiveWeight() const {
+    return liveWeight;
+}
+
+bool AliasTable::isRemoved(size_t index) const {
+    if (index >= weights.size()) {
+        throw runtime_error("Alias table index out of range");
+    }
+    return removed[index];
+}
+
+double AliasTable::weightOf(const Card& card, DrawWeighting weighting) {
+    switch (weighting) {
+        case WEIGHT_UNIFORM:
+            return 1.0;
+        case WEIGHT_BY_RARITY: {
+            const GameCard* game = dynamic_cast<const GameCard*>(&card);
+            return ldexp(1.0, 1 - (game ? game->getRarity() : 1));
+        }
+        case WEIGHT_BY_VALUE:
+            return max(0, card.getValue());
+    }
+    throw runtime_error("Unknown draw weighting");
+}
+
+const char* AliasTable::weightingName(DrawWeighting weighting) {
+    switch (weighting) {
+        case WEIGHT_UNIFORM: return "uniform";
+        case WEIGHT_BY_RARITY: return "rarity";
+        case WEIGHT_BY_VALUE: return "value";
+    }
+    return "unknown";
+}
+
+// Private helper implementations
+void AliasTable::buildColumns() {
+    // Vose's method: columns below the average weight borrow from ones above it
+    size_t n = weights.size();
+    threshold.assign(n, 0);
+    alias.resize(n);
+    vector<double> scaled(n);
+    vector<uint32_t> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    liveWeight = 0.0;
+    for (double weight : weights) {
+        liveWeight += weight;
+    }
+    for (size_t i = 0; i < n; i++) {
+        scaled[i] = weights[i] * n / liveWeight;
+        alias[i] = static_cast<uint32_t>(i);
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+    while (!small.empty() && !large.empty()) {
+        uint32_t less = small.back();
+        small.pop_back();
+        uint32_t more = large.back();
+        threshold[less] = static_cast<uint32_t>(min(scaled[less] * 4294967296.0, 4294967295.0));
+        alias[less] = more;
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) {
+            large.pop_back();
+            small.push_back(more);
+        }
+    }
+    // Whatever is left is 1 up to rounding; keep it whole. A leftover column
+    // that is removed keeps its own index and is retried on a hit.
+    for (uint32_t i : large) threshold[i] = UINT32_MAX;
+    for (uint32_t i : small) threshold[i] = UINT32_MAX;
+    builtWeight = liveWeight;
+}
@@ -0,0 +1,57 @@
+#ifndef ALIASTABLE_H
+#define ALIASTABLE_H
+
+#include "Card.h"
+#include <vector>
+#include <cstdint>
+#include <random>
+
+// How likely each card is to be picked by a weighted draw
+enum DrawWeighting {
+    WEIGHT_UNIFORM,
+    WEIGHT_BY_RARITY,    // Each rarity step halves the chance; cards without one count as rarity 1
+    WEIGHT_BY_VALUE      // Proportional to getValue(); cards worth 0 or less are never picked
+};
+
+// Walker alias table: after an O(n) build, picks an index with probability
+// proportional to its weight in O(1) with one random number. Removing an
+// index zeroes its weight in place and picks that land on it are retried;
+// once half the weight has been removed the table rebuilds itself from what
+// is left, so removals stay O(1) amortized.
+class AliasTable {
+private:
+    vector<uint32_t> threshold;   // Chance of keeping column i, scaled to 2^32
+    vector<uint32_t> alias;       // Where column i sends the rest of its picks
+    vector<double> weights;       // Current weights; removed entries are 0
+    vector<bool> removed;
+    double liveWeight;
+    double builtWeight;           // Total weight when the columns were last built
+    size_t liveCount;
+
+public:
+    // Constructors
+    AliasTable();
+    AliasTable(const vector<double>& itemWeights);
+
+    void build(const vector<double>& itemWeights);
+    void build(const vector<Card*>& cards, DrawWeighting weighting);
+
+    // Index of a live entry, with replacement
+    size_t sample(mt19937_64& rng) const;
+
+    // Takes an entry out of later samples; indexes of other entries do not change
+    void remove(size_t index);
+
+    size_t size() const;
+    size_t getLiveCount() const;
+    double getLiveWeight() const;
+    bool isRemoved(size_t index) const;
+
+    static double weightOf(const Card& card, DrawWeighting weighting);
+    static const char* weightingName(DrawWeighting weighting);
+
+private:
+    void buildColumns();
+};
+
+#endif // ALIASTABLE_H
@@ -0,0 +1,151 @@
+#include "AutosaveService.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+// Constructor implementation with validation
+AutosaveService::AutosaveService(const string& file, chrono::milliseconds saveInterval, int threshold)
+    : filename(file), interval(saveInterval), changeThreshold(threshold), pendingChanges(0),
+      flushRequested(false), stopping(false), writerWaiting(false), changesQueued(0), changesSaved(0),
+      savesCompleted(0), changesCoalesced(0), lastSaveFailed(false) {
+    if (file.empty()) {
+        throw runtime_error("Filename cannot be empty");
+    }
+    if (saveInterval.count() <= 0) {
+        throw runtime_error("Autosave interval must be positive");
+    }
+    if (threshold < 1) {
+        throw runtime_error("Autosave change threshold must be at least 1");
+    }
+    writer = thread(&AutosaveService::writerLoop, this);
+}
+
+// Destructor implementation
+AutosaveService::~AutosaveService() {
+    stop();
+}
+
+// Core functionality implementations
+void AutosaveService::notifyChanged(const DeckSnapshot& snapshot) {
+    // A replaced snapshot is released after the lock is dropped
+    optional<DeckSnapshot> replaced(snapshot);
+    lock_guard<mutex> guard(lock);
+    if (stopping) {
+        throw runtime_error("Autosave service has been stopped");
+    }
+    if (pending) {
+        changesCoalesced++;
+    } else {
+        firstPendingChange = chrono::steady_clock::now();
+    }
+    swap(pending, replaced);
+    pendingChanges++;
+    changesQueued++;
+    if (pendingChanges >= changeThreshold && writerWaiting) {
+        wake.notify_one();
+    }
+}
+
+bool AutosaveService::flush() {
+    unique_lock<mutex> guard(lock);
+    long long target = changesQueued;
+    if (changesSaved >= target) {
+        return !lastSaveFailed;
+    }
+    flushRequested = true;
+    wake.notify_one();
+    saved.wait(guard, [&]() { return changesSaved >= target; });
+    return !lastSaveFailed;
+}
+
+void AutosaveService::stop() {
+    {
+        lock_guard<mutex> guard(lock);
+        if (stopping && !writer.joinable()) {
+            return;
+        }
+        stopping = true;
+    }
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+// Accessor implementations
+string AutosaveService::getFilename() const {
+    return filename;
+}
+
+long long AutosaveService::getSavesCompleted() const {
+    lock_guard<mutex> guard(lock);
+    return savesCompleted;
+}
+
+long long AutosaveService::getChangesCoalesced() const {
+    lock_guard<mutex> guard(lock);
+    return changesCoalesced;
+}
+
+string AutosaveService::getLastError() const {
+    lock_guard<mutex> guard(lock);
+    return lastError;
+}
+
+// Private helper implementations
+void AutosaveService::writerLoop() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        if (!pending) {
+            if (stopping) {
+                return;
+            }
+            writerWaiting = true;
+            wake.wait(guard);
+            writerWaiting = false;
+            continue;
+        }
+
+        auto due = firstPendingChange + interval;
+        if (!stopping && !flushRequested && pendingChanges < changeThreshold &&
+            chrono::steady_clock::now() < due) {
+            writerWaiting = true;
+            wake.wait_until(guard, due);
+            writerWaiting = false;
+            continue;
+        }
+
+        // Take the snapshot out of the pending slot so the foreground can
+        // queue the next one while this one is written
+        optional<DeckSnapshot> current;
+        swap(current, pending);
+        pendingChanges = 0;
+        flushRequested = false;
+        long long sequence = changesQueued;
+
+        guard.unlock();
+        string error;
+        try {
+            writeSnapshot(*current);
+        } catch (const exception& e) {
+            error = e.what();
+        }
+        current.reset();
+        guard.lock();
+
+        lastSaveFailed = !error.empty();
+        if (error.empty()) {
+            savesCompleted++;
+        } else {
+            lastError = error;
+        }
+        changesSaved = sequence;
+        saved.notify_all();
+    }
+}
+
+void AutosaveService::writeSnapshot(const DeckSnapshot& snapshot) {
+    string temporary = filename + ".tmp";
+    snapshot.saveToBinary(temporary);
+    fs::rename(temporary, filename);
+}
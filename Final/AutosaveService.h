@@ -0,0 +1,74 @@
+#ifndef AUTOSAVESERVICE_H
+#define AUTOSAVESERVICE_H
+
+#include "VersionedDeck.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <optional>
+
+// Saves deck snapshots on a background thread. The foreground only swaps the
+// latest snapshot into a pending slot (an O(1) copy) and returns; the writer
+// thread takes it out of the slot and serializes it, so a new change can be
+// queued while the previous one is still being written. Changes that arrive
+// while one is pending replace it, so a burst of edits costs a single save.
+// A save happens once changeThreshold changes are pending or interval has
+// passed since the first of them. The file is written beside the target and
+// renamed over it, so a crash never leaves a half-written autosave.
+class AutosaveService {
+private:
+    string filename;
+    chrono::milliseconds interval;
+    int changeThreshold;
+
+    mutable mutex lock;
+    condition_variable wake;        // Signals the writer
+    condition_variable saved;       // Signals flush() callers
+    thread writer;
+
+    optional<DeckSnapshot> pending;
+    int pendingChanges;
+    chrono::steady_clock::time_point firstPendingChange;
+    bool flushRequested;
+    bool stopping;
+    bool writerWaiting;             // Only a waiting writer needs a wake-up call
+    long long changesQueued;        // Sequence number of the latest change
+    long long changesSaved;         // Latest change the writer has finished with
+    long long savesCompleted;
+    long long changesCoalesced;
+    bool lastSaveFailed;            // Whether the latest write threw
+    string lastError;
+
+public:
+    // Constructor
+    AutosaveService(const string& file, chrono::milliseconds saveInterval = chrono::seconds(30),
+                    int threshold = 10);
+
+    // Destructor writes any pending change before stopping the writer
+    ~AutosaveService();
+
+    AutosaveService(const AutosaveService&) = delete;
+    AutosaveService& operator=(const AutosaveService&) = delete;
+
+    // Queues the deck's new state; never waits for the disk
+    void notifyChanged(const DeckSnapshot& snapshot);
+
+    // Blocks until every queued change has been written. Returns false when
+    // that write failed; getLastError() says why.
+    bool flush();
+    void stop();
+
+    // Accessors
+    string getFilename() const;
+    long long getSavesCompleted() const;
+    long long getChangesCoalesced() const;
+    string getLastError() const;
+
+private:
+    void writerLoop();
+    void writeSnapshot(const DeckSnapshot& snapshot);
+};
+
+#endif // AUTOSAVESERVICE_H
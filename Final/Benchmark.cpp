@@ -0,0 +1,140 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+
+// Constructor
+BenchmarkSuite::BenchmarkSuite(string filterText) : filter(filterText) {}
+
+// Core functionality implementations
+void BenchmarkSuite::measure(const string& name, long long size, const function<double()>& body) {
+    if (!isSelected(name)) {
+        return;
+    }
+    if (size < 1) {
+        throw runtime_error("Benchmark size must be positive");
+    }
+
+    int reps = repetitionsFor(size);
+    vector<double> samples;
+    samples.reserve(reps);
+    for (int i = 0; i < reps; i++) {
+        samples.push_back(body());
+    }
+    sort(samples.begin(), samples.end());
+    double median = samples[samples.size() / 2];
+
+    BenchResult result;
+    result.name = name;
+    result.size = size;
+    result.repetitions = reps;
+    result.medianMs = median * 1e3;
+    result.nsPerItem = median * 1e9 / static_cast<double>(size);
+    results.push_back(result);
+
+    cerr << left << setw(28) << name << right << setw(10) << size
+         << setw(14) << fixed << setprecision(2) << result.nsPerItem << " ns/item" << endl;
+}
+
+bool BenchmarkSuite::isSelected(const string& name) const {
+    return filter.empty() || name.find(filter) != string::npos;
+}
+
+int BenchmarkSuite::repetitionsFor(long long size) const {
+    // Small inputs are noisy, so repeat them more; huge inputs run a few times only
+    long long reps = 2000000 / size;
+    return static_cast<int>(max(3LL, min(101LL, reps)));
+}
+
+// Reporting implementations
+void BenchmarkSuite::printTable(ostream& os) const {
+    os << left << setw(28) << "Benchmark" << right << setw(10) << "Size"
+       << setw(6) << "Reps" << setw(14) << "Median ms" << setw(14) << "ns/item" << endl;
+    os << string(72, '-') << endl;
+    for (const auto& r : results) {
+        os << left << setw(28) << r.name << right << setw(10) << r.size
+           << setw(6) << r.repetitions
+           << setw(14) << fixed << setprecision(3) << r.medianMs
+           << setw(14) << fixed << setprecision(2) << r.nsPerItem << endl;
+    }
+}
+
+void BenchmarkSuite::writeJson(ostream& os) const {
+    os << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        os << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+           << ", \"repetitions\": " << r.repetitions
+           << ", \"median_ms\": " << fixed << setprecision(4) << r.medianMs
+           << ", \"ns_per_item\": " << fixed << setprecision(4) << r.nsPerItem << "}";
+        os << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+int BenchmarkSuite::compareToBaseline(const string& baselineFile, double threshold, ostream& os) const {
+    map<string, double> baseline = loadBaseline(baselineFile);
+    int regressions = 0;
+
+    os << "\nComparison against baseline " << baselineFile
+       << " (threshold +" << fixed << setprecision(0) << threshold * 100 << "%):" << endl;
+    for (const auto& r : results) {
+        auto it = baseline.find(resultKey(r.name, r.size));
+        if (it == baseline.end() || it->second <= 0.0) {
+            os << "  NEW        " << r.name << " @ " << r.size << endl;
+            continue;
+        }
+        double ratio = r.nsPerItem / it->second;
+        string status = "ok";
+        if (ratio > 1.0 + threshold) {
+            status = "REGRESSION";
+            regressions++;
+        } else if (ratio < 1.0 - threshold) {
+            status = "improved";
+        }
+        os << "  " << left << setw(11) << status << r.name << " @ " << r.size
+           << ": " << fixed << setprecision(2) << it->second << " -> " << r.nsPerItem
+           << " ns/item (" << setprecision(2) << ratio << "x)" << endl;
+    }
+    return regressions;
+}
+
+const vector<BenchResult>& BenchmarkSuite::getResults() const {
+    return results;
+}
+
+// Private helper implementations
+map<string, double> BenchmarkSuite::loadBaseline(const string& filename) {
+    ifstream file(filename);
+    if (!file) {
+        throw runtime_error("Could not open baseline file: " + filename);
+    }
+
+    // Reads the flat format produced by writeJson: one benchmark object per line
+    map<string, double> baseline;
+    string line;
+    while (getline(file, line)) {
+        size_t namePos = line.find("\"name\": \"");
+        size_t sizePos = line.find("\"size\": ");
+        size_t nsPos = line.find("\"ns_per_item\": ");
+        if (namePos == string::npos || sizePos == string::npos || nsPos == string::npos) {
+            continue;
+        }
+        namePos += 9;
+        size_t nameEnd = line.find('"', namePos);
+        if (nameEnd == string::npos) {
+            continue;
+        }
+        string name = line.substr(namePos, nameEnd - namePos);
+        long long size = stoll(line.substr(sizePos + 8));
+        double ns = stod(line.substr(nsPos + 15));
+        baseline[resultKey(name, size)] = ns;
+    }
+    return baseline;
+}
+
+string BenchmarkSuite::resultKey(const string& name, long long size) {
+    return name + "@" + to_string(size);
+}
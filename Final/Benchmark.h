@@ -0,0 +1,82 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+// Stream buffer that discards everything written to it
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+// Redirects cout to a null sink for as long as it is alive
+class CoutSilencer {
+private:
+    NullBuffer sink;
+    streambuf* previous;
+
+public:
+    CoutSilencer() : previous(cout.rdbuf(&sink)) {}
+    ~CoutSilencer() { cout.rdbuf(previous); }
+};
+
+// Simple wall-clock stopwatch
+class Stopwatch {
+private:
+    chrono::steady_clock::time_point start;
+
+public:
+    Stopwatch() : start(chrono::steady_clock::now()) {}
+    void reset() { start = chrono::steady_clock::now(); }
+    double elapsedSeconds() const {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+struct BenchResult {
+    string name;
+    long long size;      // Number of items processed per repetition
+    int repetitions;
+    double medianMs;     // Median time of one repetition
+    double nsPerItem;    // Median time divided by size
+};
+
+class BenchmarkSuite {
+private:
+    vector<BenchResult> results;
+    string filter;
+
+public:
+    // Constructor
+    BenchmarkSuite(string filterText = "");
+
+    // Runs body repeatedly; body returns the seconds spent in the measured region
+    void measure(const string& name, long long size, const function<double()>& body);
+
+    // Whether a benchmark name passes the --filter option
+    bool isSelected(const string& name) const;
+
+    // Reporting
+    void printTable(ostream& os) const;
+    void writeJson(ostream& os) const;
+
+    // Compares against a baseline file; returns the number of regressions found
+    int compareToBaseline(const string& baselineFile, double threshold, ostream& os) const;
+
+    const vector<BenchResult>& getResults() const;
+
+private:
+    int repetitionsFor(long long size) const;
+    static map<string, double> loadBaseline(const string& filename);
+    static string resultKey(const string& name, long long size);
+};
+
+#endif // BENCHMARK_H
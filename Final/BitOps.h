@@ -0,0 +1,40 @@
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <cstdint>
+
+// Bit scans on 64-bit words. GCC and Clang use their builtins; other compilers
+// get a plain loop. The word must not be zero.
+inline int highestSetBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(word);
+#else
+    int bit = 0;
+    while (word >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+inline int lowestSetBit(uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    int bit = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// Branch hint for paths that are rarely taken
+#if defined(__GNUC__) || defined(__clang__)
+#define CARDGAME_UNLIKELY(condition) __builtin_expect(!!(condition), 0)
+#else
+#define CARDGAME_UNLIKELY(condition) (condition)
+#endif
+
+#endif // BITOPS_H
@@ -0,0 +1,61 @@
+#include "BoosterGenerator.h"
+
+// Constructor
+BoosterGenerator::BoosterGenerator(const Deck& poolDeck, DrawWeighting drawWeighting, uint64_t seed)
+    : pool(&poolDeck), weighting(drawWeighting), builtGeneration(UINT64_MAX), rng(seed) {}
+
+// Core functionality implementations
+int BoosterGenerator::pickIndex() {
+    refresh();
+    return static_cast<int>(table.sample(rng));
+}
+
+Card* BoosterGenerator::drawCopy() {
+    return pool->getCard(pickIndex())->clone();
+}
+
+void BoosterGenerator::openPack(Deck& pack, int count) {
+    if (count < 0) {
+        throw runtime_error("Pack size cannot be negative");
+    }
+    if (pack.getCurrentSize() + count > pack.getMaxSize()) {
+        throw runtime_error("Pack deck does not have room for the cards");
+    }
+    for (int i = 0; i < count; i++) {
+        pack.addCard(drawCopy());
+    }
+}
+
+// Accessor and mutator implementations
+void BoosterGenerator::setWeighting(DrawWeighting drawWeighting) {
+    if (drawWeighting != weighting) {
+        weighting = drawWeighting;
+        builtGeneration = UINT64_MAX;
+    }
+}
+
+DrawWeighting BoosterGenerator::getWeighting() const {
+    return weighting;
+}
+
+double BoosterGenerator::chanceOf(int index) {
+    if (index < 0 || index >= pool->getCurrentSize()) {
+        throw runtime_error("Card index out of range");
+    }
+    refresh();
+    return AliasTable::weightOf(*pool->getCard(index), weighting) / table.getLiveWeight();
+}
+
+// Private helper implementations
+void BoosterGenerator::refresh() {
+    uint64_t generation = pool->getGeneration();
+    if (generation == builtGeneration) {
+        return;
+    }
+    if (pool->isEmpty()) {
+        throw runtime_error("Cannot open packs from an empty pool");
+    }
+    vector<Card*> cards(pool->view().begin(), pool->view().end());
+    table.build(cards, weighting);
+    builtGeneration = generation;
+}
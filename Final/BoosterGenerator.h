@@ -0,0 +1,41 @@
+#ifndef BOOSTERGENERATOR_H
+#define BOOSTERGENERATOR_H
+
+#include "Deck.h"
+#include "AliasTable.h"
+#include <random>
+#include <cstdint>
+
+// Opens booster packs from a pool deck: every card in a pack is an
+// independent weighted pick from the pool, copied, so the pool never runs
+// out. The alias table over the pool is built on first use and rebuilt only
+// when the pool's generation moves, making each pick O(1). The pool must
+// outlive the generator. Not thread-safe.
+class BoosterGenerator {
+private:
+    const Deck* pool;
+    DrawWeighting weighting;
+    AliasTable table;
+    uint64_t builtGeneration;
+    mt19937_64 rng;
+
+public:
+    // Constructor
+    BoosterGenerator(const Deck& poolDeck, DrawWeighting drawWeighting = WEIGHT_BY_RARITY,
+                     uint64_t seed = random_device{}());
+
+    // Core functionality
+    int pickIndex();                     // Pool position of one weighted pick
+    Card* drawCopy();                    // New copy of one weighted pick; the caller owns it
+    void openPack(Deck& pack, int count); // Adds count picked copies to pack
+
+    // Accessors and mutators
+    void setWeighting(DrawWeighting drawWeighting);
+    DrawWeighting getWeighting() const;
+    double chanceOf(int index);          // Probability that one pick lands on this pool position
+
+private:
+    void refresh();
+};
+
+#endif // BOOSTERGENERATOR_H
@@ -1,11 +1,25 @@
 #include "Card.h"
+#include "MemoryReport.h"
+
+atomic<uint64_t> Card::valueEpoch(0);
 
 // Constructor implementation
-Card::Card(string name, int value) {
+Card::Card(string name, int value) : cachedValue(VALUE_UNCACHED) {
     setName(name);
     setValue(value);
 }
 
+Card::Card(const Card& other)
+    : cardName(other.cardName), cardValue(other.cardValue),
+      cachedValue(other.cachedValue.load(memory_order_relaxed)) {}
+
+Card& Card::operator=(const Card& other) {
+    cardName = other.cardName;
+    cardValue = other.cardValue;
+    invalidateValue();      // The assigned card may be a different type
+    return *this;
+}
+
 // Mutator implementations with validation
 void Card::setName(string name) {
     if (name.empty()) {
@@ -19,13 +33,38 @@ void Card::setValue(int value) {
         throw runtime_error("Card value cannot be negative");
     }
     cardValue = value;
+    invalidateValue();
 }
 
-// Accessor implementation
+// Accessor implementations
 string Card::getName() const {
     return cardName;
 }
 
+int Card::getBaseValue() const {
+    return cardValue;
+}
+
+uint64_t Card::getValueEpoch() {
+    return valueEpoch.load(memory_order_relaxed);
+}
+
+// Memory accounting
+void Card::addMemoryUsage(CardMemory& usage) const {
+    usage.objectBytes = sizeof(Card);
+    usage.addString(cardName);
+}
+
+// Cache helper implementations
+void Card::invalidateValue() {
+    // Only a value someone has read can be part of an aggregate, so unread
+    // cards (including ones still being constructed) skip the shared counter
+    if (cachedValue.load(memory_order_relaxed) != VALUE_UNCACHED) {
+        cachedValue.store(VALUE_UNCACHED, memory_order_relaxed);
+        valueEpoch.fetch_add(1, memory_order_relaxed);
+    }
+}
+
 // Operator overloading implementations
 ostream& operator<<(ostream& os, const Card& card) {
     os << "Card: " << card.cardName << " (Value: " << card.cardValue << ")";
@@ -4,17 +4,30 @@
 #include <string>
 #include <iostream>
 #include <stdexcept>
+#include <atomic>
+#include <cstdint>
 
 using namespace std;
 
+struct CardMemory;
+
 class Card {
 protected:
     string cardName;
     int cardValue;
 
+private:
+    // Last getValue() result, or VALUE_UNCACHED. Atomic so cards shared
+    // read-only between threads may fill it concurrently.
+    mutable atomic<int64_t> cachedValue;
+    static atomic<uint64_t> valueEpoch;
+    static const int64_t VALUE_UNCACHED = INT64_MIN;   // Outside the range of int
+
 public:
     // Constructor
     Card(string name = "", int value = 0);
+    Card(const Card& other);
+    Card& operator=(const Card& other);
     
     // Virtual destructor
     virtual ~Card() = default;
@@ -23,14 +36,41 @@ public:
     virtual void display() const = 0;
     virtual int getValue() const = 0;
     
+    // Returns a new copy of the most-derived card; the caller owns it
+    virtual Card* clone() const = 0;
+    
+    // Adds this card's size and the heap its fields own; overrides call the
+    // parent's version first, then set objectBytes and add their own fields
+    virtual void addMemoryUsage(CardMemory& usage) const;
+    
     // Accessor and mutator functions with validation
     void setName(string name);
     void setValue(int value);
     string getName() const;
+    int getBaseValue() const;   // Value before any subclass adjustments
+    
+    // Bumped whenever a card whose value had been read changes, so cached
+    // aggregates over many cards can tell they are stale
+    static uint64_t getValueEpoch();
     
     // Operator overloading (BOTH required)
     friend ostream& operator<<(ostream& os, const Card& card);
     friend istream& operator>>(istream& is, Card& card);
+
+protected:
+    // getValue() overrides return cachedValueOr([&] { return ...; }); setters
+    // of anything a subclass's value depends on call invalidateValue()
+    template<typename Compute>
+    int cachedValueOr(Compute compute) const {
+        int64_t value = cachedValue.load(memory_order_relaxed);
+        if (value == VALUE_UNCACHED) {
+            value = compute();
+            cachedValue.store(value, memory_order_relaxed);
+        }
+        return static_cast<int>(value);
+    }
+    
+    void invalidateValue();
 };
 
 #endif // CARD_H
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include "CardCatalog.h"
+#include "PlayingCard.h"
+#include "GameCard.h"
+#include "SpecialCard.h"
+#include <limits>
+#include <cstring>
+#include <cstdint>
+
+// Core functionality implementations
+uint32_t CardCatalog::intern(const CardDefinition& definition) {
+    string key = keyOf(definition);
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        return it->second;
+    }
+    if (definitions.size() >= numeric_limits<uint32_t>::max()) {
+        throw runtime_error("Card catalog is full");
+    }
+    uint32_t id = static_cast<uint32_t>(definitions.size());
+    definitions.push_back(definition);
+    lookup.emplace(move(key), id);
+    return id;
+}
+
+CardInstance CardCatalog::instanceOf(const Card& card) {
+    CardDefinition definition;
+    CardInstance instance = {0, 0, 1, 0, false};
+    definition.name = card.getName();
+    definition.baseValue = card.getBaseValue();
+
+    if (const GameCard* game = dynamic_cast<const GameCard*>(&card)) {
+        definition.kind = KIND_GAME;
+        definition.rarity = game->getRarity();
+        definition.edition = game->getEdition();
+        instance.serialNumber = game->getSerialNumber();
+        instance.foiled = game->isFoiled();
+    }
+    if (const PlayingCard* playing = dynamic_cast<const PlayingCard*>(&card)) {
+        if (definition.kind != KIND_GAME) {
+            definition.kind = KIND_PLAYING;
+        }
+        definition.suit = playing->getSuit();
+        definition.faceCard = playing->isFaceCard();
+        definition.manufacturer = playing->getManufacturer();
+        instance.condition = static_cast<uint8_t>(playing->getCondition());
+    } else if (const SpecialCard<string>* special = dynamic_cast<const SpecialCard<string>*>(&card)) {
+        definition.kind = KIND_OTHER;
+        definition.effect = special->getSpecialEffect();
+        definition.cardType = special->getCardType();
+        definition.powerLevel = special->getPowerLevel();
+        if (special->getDurability() > numeric_limits<uint16_t>::max()) {
+            throw runtime_error("Durability is too large for the card catalog");
+        }
+        instance.durability = static_cast<uint16_t>(special->getDurability());
+    } else {
+        throw runtime_error("Card type cannot be stored in the card catalog");
+    }
+
+    instance.definition = intern(definition);
+    return instance;
+}
+
+const CardDefinition& CardCatalog::getDefinition(uint32_t id) const {
+    if (id >= definitions.size()) {
+        throw runtime_error("Unknown card definition");
+    }
+    return definitions[id];
+}
+
+int CardCatalog::getValue(const CardInstance& instance) const {
+    const CardDefinition& definition = getDefinition(instance.definition);
+    switch (definition.kind) {
+        case KIND_PLAYING:
+            return static_cast<int>(definition.baseValue * (instance.condition / 10.0));
+        case KIND_GAME:
+            return static_cast<int>(definition.baseValue * (instance.condition / 10.0)) *
+                   definition.rarity * (instance.foiled ? 3 : 1);
+        default:
+            return static_cast<int>(definition.baseValue * instance.durability * definition.powerLevel);
+    }
+}
+
+Card* CardCatalog::materialize(const CardInstance& instance) const {
+    const CardDefinition& definition = getDefinition(instance.definition);
+    switch (definition.kind) {
+        case KIND_PLAYING:
+            return new PlayingCard(definition.name, definition.baseValue, definition.suit,
+                                   definition.faceCard, instance.condition, definition.manufacturer);
+        case KIND_GAME: {
+            GameCard* card = new GameCard(definition.name, definition.baseValue, definition.suit,
+                                          definition.faceCard, definition.rarity, instance.foiled,
+                                          definition.edition, instance.serialNumber);
+            card->setCondition(instance.condition);
+            card->setManufacturer(definition.manufacturer);
+            return card;
+        }
+        default:
+            return new SpecialCard<string>(definition.name, definition.baseValue, definition.effect,
+                                           instance.durability, definition.cardType, definition.powerLevel);
+    }
+}
+
+size_t CardCatalog::size() const {
+    return definitions.size();
+}
+
+size_t CardCatalog::memoryUsage() const {
+    size_t bytes = definitions.capacity() * sizeof(CardDefinition);
+    for (const auto& definition : definitions) {
+        for (const string* text : {&definition.name, &definition.suit, &definition.manufacturer,
+                                   &definition.edition, &definition.effect, &definition.cardType}) {
+            if (text->capacity() > 15) {
+                bytes += text->capacity() + 1;
+            }
+        }
+    }
+    // Hash nodes hold a key string, the id and a next pointer
+    for (const auto& entry : lookup) {
+        bytes += sizeof(entry) + sizeof(void*) + entry.first.capacity() + 1;
+    }
+    bytes += lookup.bucket_count() * sizeof(void*);
+    return bytes;
+}
+
+// Private helper implementations
+string CardCatalog::keyOf(const CardDefinition& definition) {
+    const char separator = '\x1f';
+    string key;
+    key += static_cast<char>('0' + definition.kind);
+    for (const string* text : {&definition.name, &definition.suit, &definition.manufacturer,
+                               &definition.edition, &definition.effect, &definition.cardType}) {
+        key += separator;
+        key += *text;
+    }
+    // to_string keeps only six decimals, so the power level goes in by its exact bits
+    uint64_t powerBits;
+    memcpy(&powerBits, &definition.powerLevel, sizeof(powerBits));
+    key += separator + to_string(definition.baseValue) + separator + to_string(definition.rarity) +
+           separator + (definition.faceCard ? "1" : "0") + separator + to_string(powerBits);
+    return key;
+}
@@ -0,0 +1,63 @@
+#ifndef CARDCATALOG_H
+#define CARDCATALOG_H
+
+#include "Card.h"
+#include "CardTraits.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// Attributes every copy of a card shares. Stored once per distinct card.
+struct CardDefinition {
+    CardKind kind = KIND_OTHER;     // KIND_OTHER holds SpecialCard<string>
+    string name;
+    int baseValue = 0;
+    string suit;                    // Playing and game cards
+    bool faceCard = false;
+    string manufacturer;
+    int rarity = 0;                 // Game cards
+    string edition;
+    string effect;                  // Special cards
+    string cardType;
+    double powerLevel = 1.0;
+};
+
+// Per-copy state of a card: a handle to its definition plus what differs
+// between copies. Twelve bytes, against a heap object of 100-200 bytes.
+struct CardInstance {
+    uint32_t definition;
+    int32_t serialNumber;           // Game cards
+    uint16_t durability;            // Special cards
+    uint8_t condition;              // Playing and game cards
+    bool foiled;                    // Game cards
+};
+
+// Interns card definitions so identical cards across many decks share one
+// copy of their names and attributes (the flyweight pattern). Instances can
+// be valued directly or turned back into full Card objects when a Deck needs
+// them. Not thread-safe.
+class CardCatalog {
+private:
+    vector<CardDefinition> definitions;
+    unordered_map<string, uint32_t> lookup;    // Encoded definition -> id
+
+public:
+    // Returns the id of an equal definition, adding it if it is new
+    uint32_t intern(const CardDefinition& definition);
+
+    // Splits a card into its shared definition and per-copy state
+    CardInstance instanceOf(const Card& card);
+
+    const CardDefinition& getDefinition(uint32_t id) const;
+    int getValue(const CardInstance& instance) const;    // Same result as the full card's getValue()
+    Card* materialize(const CardInstance& instance) const;  // New card; the caller owns it
+
+    size_t size() const;
+    size_t memoryUsage() const;     // Approximate bytes held by the catalog
+
+private:
+    static string keyOf(const CardDefinition& definition);
+};
+
+#endif // CARDCATALOG_H
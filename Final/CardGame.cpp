@@ -1,12 +1,22 @@
 #include <iostream>
 #include <limits>
+#include <climits>
+#include <iomanip>
+#include <ctime>
 #include "Card.h"
 #include "PlayingCard.h"
 #include "SpecialCard.h"
 #include "GameCard.h"
 #include "Deck.h"
+#include "VersionedDeck.h"
 #include "Rules.h"
 #include "FileManager.h"
+#include "AutosaveService.h"
+#include "Stats.h"
+#include "MonteCarloEstimator.h"
+#include "HypergeometricOdds.h"
+#include "SessionTrace.h"
+#include "MemoryTracker.h"
 
 using namespace std;
 
@@ -15,8 +25,19 @@ int getValidInteger(const string& prompt, int min = INT_MIN, int max = INT_MAX);
 string getValidString(const string& prompt);
 bool getValidBoolean(const string& prompt);
 double getValidDouble(const string& prompt, double min = 0.0, double max = 100.0);
+CardPredicate getDrawPredicate();
+DeckSortKey getSortKey(const string& prompt);
+int replaySession(const string& traceFile);
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc == 3 && string(argv[1]) == "--replay") {
+        return replaySession(argv[2]);
+    }
+    if (argc != 1) {
+        cout << "Usage: CardGame [--replay TRACE_FILE]" << endl;
+        return 1;
+    }
+    
     try {
         // Create a deck with user input
         cout << "=== Welcome to the Card Game System ===" << endl;
@@ -26,12 +47,26 @@ int main() {
         string owner = getValidString("Enter owner name: ");
         int maxSize = getValidInteger("Enter maximum deck size: ", 1, 200);
         
-        Deck gameDeck(maxSize, deckName, owner);
+        VersionedDeck gameDeck(maxSize, deckName, owner);
         cout << "\nDeck created successfully!" << endl;
         cout << gameDeck << endl;
         
         FileManager fileManager("./saves/"); // Create instance with default save directory
         
+        // Saves in the background after 5 changes or 30 seconds, whichever comes first
+        AutosaveService autosave(fileManager.getSaveDirectory() + "autosave.dat", chrono::seconds(30), 5);
+        long long autosavedRevision = gameDeck.getRevision();
+        
+        // Every change is traced so the session can be replayed with CardGame --replay
+        unique_ptr<SessionRecorder> recorder;
+        try {
+            recorder.reset(new SessionRecorder(fileManager.getSaveDirectory() + "last_session.trace", gameDeck));
+            cout << "Recording this session to " << recorder->getFilename() << endl;
+        } catch (const runtime_error& e) {
+            cout << "Session recording is off: " << e.what() << endl;
+        }
+        long long tracedRevision = gameDeck.getRevision();
+        
         // Interactive menu
         int choice;
         do {
@@ -48,9 +83,15 @@ int main() {
                 cout << "9. Test Operator Overloading" << endl;
                 cout << "10. Display Deck Info" << endl;
                 cout << "11. Rules/Help" << endl;
-                cout << "12. Exit" << endl;
+                cout << "12. Session Statistics" << endl;
+                cout << "13. Draw Probability Calculator" << endl;
+                cout << "14. Undo Last Change" << endl;
+                cout << "15. Redo" << endl;
+                cout << "16. Sort Deck" << endl;
+                cout << "17. Memory Report" << endl;
+                cout << "18. Exit" << endl;
                 
-                choice = getValidInteger("Enter your choice: ", 1, 12);
+                choice = getValidInteger("Enter your choice: ", 1, 18);
                 
                 switch(choice) {
                     case 1: {
@@ -69,6 +110,7 @@ int main() {
                         
                         PlayingCard* card = new PlayingCard(name, value, suit, face, condition, manufacturer);
                         gameDeck.addCard(card);
+                        if (recorder) recorder->recordAddCard(*card);
                         cout << "Playing card added successfully!" << endl;
                         cout << *card << endl;
                         break;
@@ -86,6 +128,7 @@ int main() {
                         
                         SpecialCard<string>* card = new SpecialCard<string>(name, value, effect, durability, cardType, powerLevel);
                         gameDeck.addCard(card);
+                        if (recorder) recorder->recordAddCard(*card);
                         cout << "Special card added successfully!" << endl;
                         cout << *card << endl;
                         break;
@@ -110,6 +153,7 @@ int main() {
                         
                         GameCard* card = new GameCard(name, value, suit, face, rarity, foiled, edition, serialNumber);
                         gameDeck.addCard(card);
+                        if (recorder) recorder->recordAddCard(*card);
                         cout << "Game card added successfully!" << endl;
                         cout << *card << endl;
                         break;  // Add this break statement
@@ -117,7 +161,9 @@ int main() {
                     
                     case 4: {
                         cout << "\n=== Shuffling Deck ===" << endl;
-                        gameDeck.shuffle();
+                        uint64_t seed = SessionRecorder::freshSeed();
+                        gameDeck.shuffle(seed);
+                        if (recorder) recorder->recordShuffle(seed);
                         cout << "Deck shuffled successfully!" << endl;
                         break;
                     }
@@ -130,7 +176,8 @@ int main() {
                     
                     case 6: {
                         cout << "\n=== Drawing Card ===" << endl;
-                        Card* drawnCard = gameDeck.drawCard();
+                        shared_ptr<Card> drawnCard = gameDeck.drawCard();
+                        if (recorder) recorder->recordDraw();
                         cout << "Card drawn: ";
                         drawnCard->display();
                         cout << "Card value: " << drawnCard->getValue() << endl;
@@ -139,10 +186,10 @@ int main() {
                         bool keepCard = getValidBoolean("Keep this card? (1 to keep, 0 to return to deck): ");
                         if (!keepCard) {
                             gameDeck.addCard(drawnCard);
+                            if (recorder) recorder->recordReturnDrawn();
                             cout << "Card returned to deck." << endl;
                         } else {
-                            cout << "Card kept. Don't forget to manage its memory!" << endl;
-                            delete drawnCard; // Clean up for demo purposes
+                            cout << "Card kept. Use Undo (option 14) to put it back." << endl;
                         }
                         break;
                     }
@@ -152,7 +199,7 @@ int main() {
                         int fileChoice;
                         do {
                             fileManager.displayFileMenu();
-                            fileChoice = getValidInteger("Enter your choice: ", 1, 7);
+                            fileChoice = getValidInteger("Enter your choice: ", 1, 10);
                             
                             switch(fileChoice) {
                                 case 1: {
@@ -160,7 +207,10 @@ int main() {
                                     break;
                                 }
                                 case 2: {
-                                    if (fileManager.loadSelectedDeck(gameDeck)) {
+                                    Deck loadedDeck;
+                                    if (fileManager.loadSelectedDeck(loadedDeck)) {
+                                        gameDeck.adoptDeck(loadedDeck);
+                                        if (recorder) recorder->recordLoad(gameDeck);
                                         cout << "Current deck replaced with loaded deck." << endl;
                                         cout << gameDeck << endl;
                                     } else {
@@ -169,7 +219,7 @@ int main() {
                                     break;
                                 }
                                 case 3: {
-                                    fileManager.saveNewDeck(gameDeck);
+                                    fileManager.saveNewDeck(gameDeck.snapshot());
                                     break;
                                 }
                                 case 4: {
@@ -188,18 +238,32 @@ int main() {
                                     break;
                                 }
                                 case 7: {
+                                    fileManager.loadAllDecks();
+                                    break;
+                                }
+                                case 8: {
+                                    fileManager.setDeduplicatedSaves(!fileManager.getDeduplicatedSaves());
+                                    cout << "Deduplicated saves "
+                                         << (fileManager.getDeduplicatedSaves() ? "enabled" : "disabled") << "." << endl;
+                                    break;
+                                }
+                                case 9: {
+                                    fileManager.findDecksWithCard();
+                                    break;
+                                }
+                                case 10: {
                                     cout << "Returning to main menu..." << endl;
                                     break;
                                 }
                             }
                             
-                            if (fileChoice != 7) {
+                            if (fileChoice != 10) {
                                 cout << "\nPress Enter to continue...";
                                 cin.ignore();
                                 cin.get();
                             }
                             
-                        } while (fileChoice != 7);
+                        } while (fileChoice != 10);
                         break;
                     }
                     case 8: {
@@ -208,6 +272,7 @@ int main() {
                         
                         try {
                             gameDeck.loadFromBinary(filename);
+                            if (recorder) recorder->recordLoad(gameDeck);
                             cout << "Deck loaded successfully from " << filename << endl;
                             cout << gameDeck << endl;
                         } catch (const runtime_error& e) {
@@ -235,6 +300,7 @@ int main() {
                             // Add the card to deck
                             PlayingCard* cardPtr = new PlayingCard(testCard);
                             gameDeck.addCard(cardPtr);
+                            if (recorder) recorder->recordAddCard(*cardPtr);
                             cout << "Card added to deck!" << endl;
                         } catch (const exception& e) {
                             cout << "Error during operator testing: " << e.what() << endl;
@@ -247,6 +313,7 @@ int main() {
                         cout << gameDeck << endl;
                         cout << "Current size: " << gameDeck.getCurrentSize() << endl;
                         cout << "Max size: " << gameDeck.getMaxSize() << endl;
+                        cout << "Total value: " << gameDeck.getTotalValue() << endl;
                         cout << "Is empty: " << (gameDeck.isEmpty() ? "Yes" : "No") << endl;
                         cout << "Is full: " << (gameDeck.isFull() ? "Yes" : "No") << endl;
                         break;
@@ -258,6 +325,102 @@ int main() {
                         break;
                     }   
                     case 12: {
+                        cout << "\n=== Session Statistics ===" << endl;
+                        StatsRegistry& stats = StatsRegistry::instance();
+                        stats.printReport(cout);
+                        cout << "Autosaves written: " << autosave.getSavesCompleted()
+                             << " (" << autosave.getChangesCoalesced() << " changes coalesced)" << endl;
+                        if (!autosave.getLastError().empty()) {
+                            cout << "Last autosave error: " << autosave.getLastError() << endl;
+                        }
+                        
+                        if (StatsRegistry::isEnabled() &&
+                            getValidBoolean("Write statistics to a JSON file? (1/0): ")) {
+                            string filename = getValidString("Enter JSON filename: ");
+                            ofstream out(filename);
+                            if (!out) {
+                                throw runtime_error("Could not open file for writing: " + filename);
+                            }
+                            stats.writeJson(out);
+                            cout << "Statistics written to " << filename << endl;
+                        }
+                        break;
+                    }
+                    case 13: {
+                        cout << "\n=== Draw Probability Calculator ===" << endl;
+                        if (gameDeck.isEmpty()) {
+                            throw runtime_error("Deck is empty - add some cards first");
+                        }
+                        CardPredicate predicate = getDrawPredicate();
+                        int draws = getValidInteger("Number of cards to draw: ", 1, gameDeck.getCurrentSize());
+                        int atLeast = getValidInteger("Chance of drawing at least how many matching cards? ", 1, draws);
+                        
+                        vector<CardTraits> traits = CardTraits::fromSnapshot(gameDeck.snapshot());
+                        HypergeometricOdds odds(traits);
+                        MonteCarloEstimator estimator(traits);
+                        ProbabilityEstimate estimate = estimator.estimate(predicate, draws, atLeast, 0.002,
+                                                                          static_cast<uint64_t>(time(0)));
+                        cout << fixed << setprecision(2);
+                        cout << "Exact probability: "
+                             << odds.probabilityAtLeast(predicate, draws, atLeast) * 100 << "%" << endl;
+                        cout << "Simulated probability: " << estimate.probability * 100 << "% (95% CI "
+                             << estimate.lower * 100 << "% - " << estimate.upper * 100 << "%, "
+                             << estimate.trials << " shuffles)" << endl;
+                        cout.unsetf(ios::fixed);
+                        cout << setprecision(6);
+                        break;
+                    }
+                    case 14: {
+                        if (gameDeck.undo()) {
+                            if (recorder) recorder->recordUndo();
+                            cout << "\nLast change undone." << endl;
+                            cout << gameDeck << endl;
+                        } else {
+                            cout << "\nNothing to undo." << endl;
+                        }
+                        break;
+                    }
+                    case 15: {
+                        if (gameDeck.redo()) {
+                            if (recorder) recorder->recordRedo();
+                            cout << "\nChange redone." << endl;
+                            cout << gameDeck << endl;
+                        } else {
+                            cout << "\nNothing to redo." << endl;
+                        }
+                        break;
+                    }
+                    case 16: {
+                        cout << "\n=== Sorting Deck ===" << endl;
+                        vector<DeckSortKey> keys;
+                        keys.push_back(getSortKey("Sort by"));
+                        cout << "0. No second key" << endl;
+                        int second = getValidInteger("Then by (0-5): ", 0, 5);
+                        if (second != 0) {
+                            keys.push_back(static_cast<DeckSortKey>(second - 1));
+                        }
+                        gameDeck.sortBy(keys);
+                        if (recorder) recorder->recordSort(keys);
+                        cout << "Deck sorted by " << DeckSorter::keyName(keys[0]);
+                        if (keys.size() > 1) cout << ", then " << DeckSorter::keyName(keys[1]);
+                        cout << ". The highest card is now on top." << endl;
+                        break;
+                    }
+                    case 17: {
+                        cout << "\n=== Memory Report ===" << endl;
+                        // Measured on a plain Deck holding copies of the current cards
+                        Deck plain(max(1, gameDeck.getMaxSize()), gameDeck.getDeckName(), gameDeck.getOwner());
+                        gameDeck.copyTo(plain);
+                        plain.memoryReport().print(cout);
+                        if (MemoryTracker::enabled()) {
+                            MemoryCounters counters = MemoryTracker::current();
+                            cout << "\nWhole program: " << counters.liveBytes << " bytes in " << counters.liveBlocks
+                                 << " live blocks (peak " << counters.peakBytes << " bytes, "
+                                 << counters.allocations << " allocations so far)" << endl;
+                        }
+                        break;
+                    }
+                    case 18: {
                         cout << "\nThank you for using the Card Game System!" << endl;
                         break;
                     }
@@ -275,7 +438,26 @@ int main() {
                 cout << "Exception: " << e.what() << endl;
             }
             
-        } while (choice != 12);
+            if (gameDeck.getRevision() != autosavedRevision) {
+                autosave.notifyChanged(gameDeck.snapshot());
+                autosavedRevision = gameDeck.getRevision();
+            }
+            if (recorder && gameDeck.getRevision() != tracedRevision) {
+                try {
+                    recorder->checkpoint(gameDeck);
+                } catch (const runtime_error& e) {
+                    cout << "Session recording stopped: " << e.what() << endl;
+                    recorder.reset();
+                }
+                tracedRevision = gameDeck.getRevision();
+            }
+            
+        } while (choice != 18);
+        
+        // Write the last pending change before exiting
+        if (!autosave.flush()) {
+            cout << "Final autosave failed: " << autosave.getLastError() << endl;
+        }
         
     } catch (const runtime_error& e) {
         cout << "Fatal Runtime Error: " << e.what() << endl;
@@ -360,4 +542,48 @@ double getValidDouble(const string& prompt, double min, double max) {
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
         }
     }
-}
\ No newline at end of file
+}
+
+CardPredicate getDrawPredicate() {
+    cout << "Count cards that are:" << endl;
+    cout << "1. A given suit" << endl;
+    cout << "2. Face cards" << endl;
+    cout << "3. Face cards of a given suit" << endl;
+    cout << "4. Foiled" << endl;
+    cout << "5. At least a given rarity" << endl;
+    cout << "6. Worth at least a given value" << endl;
+    int choice = getValidInteger("Enter your choice: ", 1, 6);
+    
+    switch (choice) {
+        case 1: return CardFilters::suit(getValidString("Enter suit (Hearts/Diamonds/Clubs/Spades): "));
+        case 2: return CardFilters::faceCard();
+        case 3: return CardFilters::both(CardFilters::faceCard(),
+                    CardFilters::suit(getValidString("Enter suit (Hearts/Diamonds/Clubs/Spades): ")));
+        case 4: return CardFilters::foiled();
+        case 5: return CardFilters::minRarity(getValidInteger("Enter minimum rarity (1-10): ", 1, 10));
+        default: return CardFilters::minValue(getValidInteger("Enter minimum value: ", 0, INT_MAX));
+    }
+}
+
+DeckSortKey getSortKey(const string& prompt) {
+    cout << "1. Value" << endl;
+    cout << "2. Suit" << endl;
+    cout << "3. Rarity" << endl;
+    cout << "4. Condition" << endl;
+    cout << "5. Name" << endl;
+    return static_cast<DeckSortKey>(getValidInteger(prompt + " (1-5): ", 1, 5) - 1);
+}
+int replaySession(const string& traceFile) {
+    try {
+        SessionReplayer replayer(traceFile);
+        ReplayReport report = replayer.replay(true);
+        cout << "Replayed " << report.operations << " operations from " << traceFile
+             << " in " << report.seconds * 1000.0 << " ms" << endl;
+        cout << report.checkpoints << " checkpoints matched; final deck has "
+             << report.finalSize << " cards (state hash " << hex << report.finalHash << dec << ")" << endl;
+        return 0;
+    } catch (const exception& e) {
+        cout << "Replay failed: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,417 @@
+#include "CardNameIndex.h"
+#include <algorithm>
+#include <cctype>
+
+// Constructor
+CardNameIndex::CardNameIndex() : freeEntries(NONE), cardCount(0), nameCount(0) {
+    clear();
+}
+
+// Maintenance implementations
+void CardNameIndex::build(const vector<Card*>& cards) {
+    clear();
+    // Inserting in name order creates each subtree's nodes and entries together,
+    // so completions read neighbouring memory
+    vector<pair<string, const Card*>> sorted;
+    sorted.reserve(cards.size());
+    for (const Card* card : cards) {
+        sorted.emplace_back(normalize(card->getName()), card);
+    }
+    stable_sort(sorted.begin(), sorted.end(),
+                [](const pair<string, const Card*>& a, const pair<string, const Card*>& b) {
+                    return a.first < b.first;
+                });
+    entries.reserve(sorted.size());
+    for (const auto& item : sorted) {
+        uint32_t node = insertKey(item.first);
+        if (nodes[node].firstEntry == NONE) nameCount++;
+        entries.push_back({item.second, nodes[node].firstEntry});
+        nodes[node].firstEntry = static_cast<uint32_t>(entries.size() - 1);
+        for (uint32_t n = node; n != NONE; n = nodes[n].parent) {
+            nodes[n].subtreeCards++;
+        }
+        indexGrams(node, item.first);
+    }
+    cardCount = sorted.size();
+}
+
+void CardNameIndex::add(const Card* card) {
+    string key = normalize(card->getName());
+    uint32_t node = insertKey(key);
+    if (nodes[node].firstEntry == NONE) nameCount++;
+
+    uint32_t entry;
+    if (freeEntries != NONE) {
+        entry = freeEntries;
+        freeEntries = entries[entry].next;
+    } else {
+        entry = static_cast<uint32_t>(entries.size());
+        entries.push_back({nullptr, NONE});
+    }
+    entries[entry] = {card, nodes[node].firstEntry};
+    nodes[node].firstEntry = entry;
+    for (uint32_t n = node; n != NONE; n = nodes[n].parent) {
+        nodes[n].subtreeCards++;
+    }
+    cardCount++;
+
+    indexGrams(node, key);
+}
+
+bool CardNameIndex::remove(const Card* card) {
+    uint32_t node = findNode(normalize(card->getName()), false);
+    if (node == NONE) return false;
+
+    uint32_t previous = NONE;
+    uint32_t entry = nodes[node].firstEntry;
+    while (entry != NONE && entries[entry].card != card) {
+        previous = entry;
+        entry = entries[entry].next;
+    }
+    if (entry == NONE) return false;
+
+    if (previous == NONE) {
+        nodes[node].firstEntry = entries[entry].next;
+    } else {
+        entries[previous].next = entries[entry].next;
+    }
+    entries[entry] = {nullptr, freeEntries};
+    freeEntries = entry;
+    if (nodes[node].firstEntry == NONE) nameCount--;
+    for (uint32_t n = node; n != NONE; n = nodes[n].parent) {
+        nodes[n].subtreeCards--;
+    }
+    cardCount--;
+    return true;
+}
+
+void CardNameIndex::clear() {
+    nodes.clear();
+    labels.clear();
+    entries.clear();
+    gramNodes.clear();
+    freeEntries = NONE;
+    cardCount = 0;
+    nameCount = 0;
+    newNode(0, 0, NONE, 0);
+}
+
+// Lookup implementations
+vector<const Card*> CardNameIndex::findExact(const string& name) const {
+    vector<const Card*> cards;
+    uint32_t node = findNode(normalize(name), false);
+    if (node == NONE) return cards;
+    for (uint32_t entry = nodes[node].firstEntry; entry != NONE; entry = entries[entry].next) {
+        cards.push_back(entries[entry].card);
+    }
+    return cards;
+}
+
+size_t CardNameIndex::countPrefix(const string& prefix) const {
+    uint32_t node = findNode(normalize(prefix), true);
+    return node == NONE ? 0 : nodes[node].subtreeCards;
+}
+
+vector<NameMatch> CardNameIndex::complete(const string& prefix, size_t limit) const {
+    vector<NameMatch> matches;
+    uint32_t node = findNode(normalize(prefix), true);
+    if (node != NONE && limit > 0) {
+        collect(node, limit, matches);
+    }
+    return matches;
+}
+
+vector<NameMatch> CardNameIndex::findSimilar(const string& name, int maxDistance, size_t limit) const {
+    if (maxDistance < 0 || maxDistance > MAX_DISTANCE) {
+        throw runtime_error("Edit distance must be between 0 and " + to_string(MAX_DISTANCE));
+    }
+    string key = normalize(name);
+    vector<NameMatch> matches;
+    if (limit == 0) return matches;
+
+    vector<uint32_t> grams;
+    gramsOf(key, grams);
+
+    // Every edit destroys at most three of the query's trigrams, so a match keeps
+    // all but 3k of them and is in at least one of the 3k+1 rarest lists. Those
+    // lists give the candidates; every further list is binary searched for the
+    // survivors only, dropping a name once it has missed more than 3k lists.
+    // Queries too short for that guarantee check every name instead.
+    vector<uint32_t> candidates;
+    size_t needed = static_cast<size_t>(3 * maxDistance + 1);
+    auto plausible = [&](uint32_t node) {
+        long long lengthGap = static_cast<long long>(nodes[node].depth) - static_cast<long long>(key.size());
+        return nodes[node].firstEntry != NONE && lengthGap <= maxDistance && -lengthGap <= maxDistance;
+    };
+    if (grams.size() >= needed) {
+        vector<const vector<uint32_t>*> lists;
+        static const vector<uint32_t> empty;
+        for (uint32_t gram : grams) {
+            auto it = gramNodes.find(gram);
+            lists.push_back(it == gramNodes.end() ? &empty : &it->second);
+        }
+        sort(lists.begin(), lists.end(),
+             [](const vector<uint32_t>* a, const vector<uint32_t>* b) { return a->size() < b->size(); });
+
+        vector<uint32_t> found;
+        vector<uint32_t> merged;
+        for (size_t i = 0; i < needed; i++) {
+            merged.resize(found.size() + lists[i]->size());
+            merge(found.begin(), found.end(), lists[i]->begin(), lists[i]->end(), merged.begin());
+            swap(found, merged);
+        }
+        vector<uint32_t> misses;
+        for (size_t i = 0; i < found.size();) {
+            size_t run = i;
+            while (run < found.size() && found[run] == found[i]) run++;
+            candidates.push_back(found[i]);
+            misses.push_back(static_cast<uint32_t>(needed - (run - i)));
+            i = run;
+        }
+        for (size_t list = needed; list < lists.size() && !candidates.empty(); list++) {
+            // Candidates ascend, so each search gallops on from where the last stopped
+            const vector<uint32_t>& posting = *lists[list];
+            size_t position = 0;
+            size_t kept = 0;
+            for (size_t c = 0; c < candidates.size(); c++) {
+                size_t step = 1;
+                while (position + step < posting.size() && posting[position + step] < candidates[c]) {
+                    position += step;
+                    step *= 2;
+                }
+                position = lower_bound(posting.begin() + position, posting.begin() + min(position + step, posting.size()),
+                                       candidates[c]) - posting.begin();
+                uint32_t missed = misses[c];
+                if (position == posting.size() || posting[position] != candidates[c]) missed++;
+                if (missed < needed) {
+                    candidates[kept] = candidates[c];
+                    misses[kept++] = missed;
+                }
+            }
+            candidates.resize(kept);
+            misses.resize(kept);
+        }
+    } else {
+        for (uint32_t node = 0; node < nodes.size(); node++) {
+            candidates.push_back(node);
+        }
+    }
+
+    for (uint32_t node : candidates) {
+        if (!plausible(node)) continue;
+        int distance = boundedDistance(key, keyOf(node), maxDistance);
+        if (distance <= maxDistance) {
+            matches.push_back(matchFor(node, distance));
+        }
+    }
+
+    sort(matches.begin(), matches.end(), [](const NameMatch& a, const NameMatch& b) {
+        if (a.distance != b.distance) return a.distance < b.distance;
+        return a.name < b.name;
+    });
+    if (matches.size() > limit) matches.resize(limit);
+    return matches;
+}
+
+size_t CardNameIndex::size() const {
+    return cardCount;
+}
+
+size_t CardNameIndex::distinctNames() const {
+    return nameCount;
+}
+
+size_t CardNameIndex::memoryUsage() const {
+    size_t bytes = nodes.capacity() * sizeof(Node) + labels.capacity() + entries.capacity() * sizeof(Entry);
+    bytes += gramNodes.bucket_count() * sizeof(void*);
+    for (const auto& list : gramNodes) {
+        bytes += sizeof(list) + sizeof(void*) + list.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+// Private helper implementations
+string CardNameIndex::normalize(const string& name) {
+    string key = name;
+    for (char& c : key) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return key;
+}
+
+void CardNameIndex::gramsOf(const string& key, vector<uint32_t>& grams) {
+    // Padding gives the first and last characters trigrams of their own
+    string padded = "\x01\x01" + key + "\x02\x02";
+    grams.clear();
+    for (size_t i = 0; i + 3 <= padded.size(); i++) {
+        grams.push_back((static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16) |
+                        (static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8) |
+                        static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 2])));
+    }
+    sort(grams.begin(), grams.end());
+    grams.erase(unique(grams.begin(), grams.end()), grams.end());
+}
+
+int CardNameIndex::boundedDistance(const string& a, const string& b, int limit) {
+    // Levenshtein distance, giving up with limit + 1 once a whole row exceeds limit
+    vector<int> previous(b.size() + 1);
+    vector<int> current(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) previous[j] = static_cast<int>(j);
+    for (size_t i = 1; i <= a.size(); i++) {
+        current[0] = static_cast<int>(i);
+        int rowBest = current[0];
+        for (size_t j = 1; j <= b.size(); j++) {
+            int substitute = previous[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1);
+            current[j] = min(substitute, min(previous[j], current[j - 1]) + 1);
+            rowBest = min(rowBest, current[j]);
+        }
+        if (rowBest > limit) return limit + 1;
+        swap(previous, current);
+    }
+    return min(previous[b.size()], limit + 1);
+}
+
+void CardNameIndex::indexGrams(uint32_t node, const string& key) {
+    // A name's trigrams are listed once, when its first card arrives. Lists stay
+    // sorted by node for binary search; nodes are mostly created in order, so
+    // this is nearly always an append.
+    if (nodes[node].gramsIndexed) return;
+    nodes[node].gramsIndexed = true;
+    vector<uint32_t> grams;
+    gramsOf(key, grams);
+    for (uint32_t gram : grams) {
+        vector<uint32_t>& list = gramNodes[gram];
+        if (list.empty() || list.back() < node) {
+            list.push_back(node);
+        } else {
+            list.insert(lower_bound(list.begin(), list.end(), node), node);
+        }
+    }
+}
+
+uint32_t CardNameIndex::newNode(uint32_t labelStart, uint32_t labelLength, uint32_t parent, uint32_t depth) {
+    nodes.push_back({labelStart, labelLength, parent, NONE, NONE, NONE, 0, depth, false});
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t CardNameIndex::insertKey(const string& key) {
+    uint32_t node = 0;
+    size_t i = 0;
+    while (i < key.size()) {
+        uint32_t previous = NONE;
+        uint32_t child = nodes[node].firstChild;
+        while (child != NONE && static_cast<unsigned char>(labels[nodes[child].labelStart]) < static_cast<unsigned char>(key[i])) {
+            previous = child;
+            child = nodes[child].nextSibling;
+        }
+
+        if (child == NONE || labels[nodes[child].labelStart] != key[i]) {
+            // No edge starts with this character: the rest of the key becomes a leaf
+            uint32_t start = static_cast<uint32_t>(labels.size());
+            labels.append(key, i, string::npos);
+            uint32_t leaf = newNode(start, static_cast<uint32_t>(key.size() - i), node,
+                                    static_cast<uint32_t>(key.size()));
+            nodes[leaf].nextSibling = child;
+            if (previous == NONE) {
+                nodes[node].firstChild = leaf;
+            } else {
+                nodes[previous].nextSibling = leaf;
+            }
+            return leaf;
+        }
+
+        uint32_t start = nodes[child].labelStart;
+        uint32_t length = nodes[child].labelLength;
+        uint32_t common = 1;
+        while (common < length && i + common < key.size() && labels[start + common] == key[i + common]) {
+            common++;
+        }
+
+        if (common < length) {
+            // The key leaves this edge part way along, so split it
+            uint32_t middle = newNode(start, common, node, nodes[node].depth + common);
+            nodes[middle].firstChild = child;
+            nodes[middle].nextSibling = nodes[child].nextSibling;
+            nodes[middle].subtreeCards = nodes[child].subtreeCards;
+            nodes[child].labelStart = start + common;
+            nodes[child].labelLength = length - common;
+            nodes[child].parent = middle;
+            nodes[child].nextSibling = NONE;
+            if (previous == NONE) {
+                nodes[node].firstChild = middle;
+            } else {
+                nodes[previous].nextSibling = middle;
+            }
+            child = middle;
+        }
+        node = child;
+        i += common;
+    }
+    return node;
+}
+
+uint32_t CardNameIndex::findNode(const string& key, bool allowPartial) const {
+    // With allowPartial the key may end inside an edge; that edge's node covers
+    // every name starting with the key
+    uint32_t node = 0;
+    size_t i = 0;
+    while (i < key.size()) {
+        uint32_t child = nodes[node].firstChild;
+        while (child != NONE && static_cast<unsigned char>(labels[nodes[child].labelStart]) < static_cast<unsigned char>(key[i])) {
+            child = nodes[child].nextSibling;
+        }
+        if (child == NONE || labels[nodes[child].labelStart] != key[i]) return NONE;
+
+        uint32_t start = nodes[child].labelStart;
+        uint32_t length = nodes[child].labelLength;
+        uint32_t matched = 0;
+        while (matched < length && i + matched < key.size() && labels[start + matched] == key[i + matched]) {
+            matched++;
+        }
+        if (matched < length) {
+            if (i + matched < key.size() || !allowPartial) return NONE;
+        }
+        node = child;
+        i += matched;
+    }
+    return node;
+}
+
+string CardNameIndex::keyOf(uint32_t node) const {
+    string key(nodes[node].depth, '\0');
+    for (uint32_t n = node; n != 0; n = nodes[n].parent) {
+        key.replace(nodes[n].depth - nodes[n].labelLength, nodes[n].labelLength,
+                    labels, nodes[n].labelStart, nodes[n].labelLength);
+    }
+    return key;
+}
+
+NameMatch CardNameIndex::matchFor(uint32_t node, int distance) const {
+    NameMatch match;
+    match.distance = distance;
+    for (uint32_t entry = nodes[node].firstEntry; entry != NONE; entry = entries[entry].next) {
+        match.count++;
+        match.card = entries[entry].card;
+    }
+    match.name = match.card->getName();
+    return match;
+}
+
+void CardNameIndex::collect(uint32_t node, size_t limit, vector<NameMatch>& out) const {
+    // Pre-order walk over sorted siblings yields names alphabetically; an explicit
+    // stack keeps long shared prefixes from deepening the call stack
+    vector<uint32_t> stack(1, node);
+    while (!stack.empty() && out.size() < limit) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        if (nodes[current].subtreeCards == 0) continue;
+        if (nodes[current].firstEntry != NONE) {
+            out.push_back(matchFor(current, 0));
+        }
+        size_t mark = stack.size();
+        for (uint32_t child = nodes[current].firstChild; child != NONE; child = nodes[child].nextSibling) {
+            if (nodes[child].subtreeCards > 0) stack.push_back(child);
+        }
+        reverse(stack.begin() + mark, stack.end());
+    }
+}
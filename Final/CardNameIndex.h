@@ -0,0 +1,92 @@
+#ifndef CARDNAMEINDEX_H
+#define CARDNAMEINDEX_H
+
+#include "Card.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+struct NameMatch {
+    string name;             // As one of the matching cards spells it
+    int distance = 0;        // Edits away from the query; 0 for completions
+    int count = 0;           // Cards with this name
+    const Card* card = nullptr;   // One of them
+};
+
+// Case-insensitive index of card names. Names sit in a compressed (radix)
+// trie whose nodes live in one array and whose edge labels are ranges of one
+// string, so completing a prefix walks only the prefix and then the first
+// names in alphabetical order, skipping subtrees whose card count is zero.
+// Typo-tolerant lookup uses trigrams: a name within k edits of the query
+// shares all but at most 3k of its trigrams, so candidates come from the 3k+1
+// rarest trigram lists and are confirmed with a bounded edit distance.
+// Removing a name leaves its trie node and trigram entries in place, to be
+// skipped until the next build.
+class CardNameIndex {
+public:
+    static const int MAX_DISTANCE = 3;
+
+private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    struct Node {
+        uint32_t labelStart;
+        uint32_t labelLength;
+        uint32_t parent;
+        uint32_t firstChild;     // Children are kept sorted by their first character
+        uint32_t nextSibling;
+        uint32_t firstEntry;     // Cards whose whole name ends here
+        uint32_t subtreeCards;
+        uint32_t depth;          // Name length at the end of this node's label
+        bool gramsIndexed;
+    };
+
+    struct Entry {
+        const Card* card;
+        uint32_t next;
+    };
+
+    vector<Node> nodes;                 // nodes[0] is the root
+    string labels;
+    vector<Entry> entries;
+    uint32_t freeEntries;
+    unordered_map<uint32_t, vector<uint32_t>> gramNodes;   // Trigram to nodes whose name contains it
+    size_t cardCount;
+    size_t nameCount;
+
+public:
+    // Constructor
+    CardNameIndex();
+
+    // Maintenance
+    void build(const vector<Card*>& cards);
+    void add(const Card* card);
+    bool remove(const Card* card);      // False if the card was not indexed
+    void clear();
+
+    // Lookups; all ignore case
+    vector<const Card*> findExact(const string& name) const;
+    size_t countPrefix(const string& prefix) const;                 // Cards whose name starts with it
+    vector<NameMatch> complete(const string& prefix, size_t limit) const;   // Alphabetical
+    vector<NameMatch> findSimilar(const string& name, int maxDistance, size_t limit) const;   // Closest first
+
+    size_t size() const;
+    size_t distinctNames() const;
+    size_t memoryUsage() const;
+
+private:
+    static string normalize(const string& name);
+    static void gramsOf(const string& key, vector<uint32_t>& grams);   // Sorted, without repeats
+    static int boundedDistance(const string& a, const string& b, int limit);
+
+    void indexGrams(uint32_t node, const string& key);
+    uint32_t newNode(uint32_t labelStart, uint32_t labelLength, uint32_t parent, uint32_t depth);
+    uint32_t insertKey(const string& key);
+    uint32_t findNode(const string& key, bool allowPartial) const;
+    string keyOf(uint32_t node) const;
+    NameMatch matchFor(uint32_t node, int distance) const;
+    void collect(uint32_t node, size_t limit, vector<NameMatch>& out) const;
+};
+
+#endif // CARDNAMEINDEX_H
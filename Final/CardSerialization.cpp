@@ -0,0 +1,161 @@
+#include "CardSerialization.h"
+#include "Stats.h"
+#include <fstream>
+
+// ByteWriter implementations
+void ByteWriter::reserve(size_t size) {
+    bytes.reserve(size);
+}
+
+size_t ByteWriter::size() const {
+    return bytes.size();
+}
+
+const char* ByteWriter::data() const {
+    return bytes.data();
+}
+
+void ByteWriter::saveToFile(const string& filename) const {
+    if (filename.empty()) {
+        throw runtime_error("Filename cannot be empty");
+    }
+    ofstream file(filename, ios::binary);
+    if (!file) {
+        throw runtime_error("Could not open file for writing: " + filename);
+    }
+    file.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+    if (!file.good()) {
+        throw runtime_error("Error occurred while writing to file");
+    }
+    STATS_COUNT(COUNTER_BYTES_WRITTEN, static_cast<uint64_t>(bytes.size()));
+}
+
+// Built-in card codecs
+void CardCodec<PlayingCard>::encode(const Card& card, ByteWriter& out) {
+    const PlayingCard& playing = static_cast<const PlayingCard&>(card);
+    out.write(playing.getName());
+    out.write<int32_t>(playing.getBaseValue());
+    out.write(playing.getSuit());
+    out.write(playing.isFaceCard());
+    out.write<int32_t>(playing.getCondition());
+    out.write(playing.getManufacturer());
+}
+
+Card* CardCodec<PlayingCard>::decode(ByteReader& in) {
+    string name = in.read<string>();
+    int32_t value = in.read<int32_t>();
+    string suit = in.read<string>();
+    bool face = in.read<bool>();
+    int32_t condition = in.read<int32_t>();
+    string manufacturer = in.read<string>();
+    return new PlayingCard(name, value, suit, face, condition, manufacturer);
+}
+
+void CardCodec<GameCard>::encode(const Card& card, ByteWriter& out) {
+    const GameCard& game = static_cast<const GameCard&>(card);
+    CardCodec<PlayingCard>::encode(card, out);
+    out.write<int32_t>(game.getRarity());
+    out.write(game.isFoiled());
+    out.write(game.getEdition());
+    out.write<int32_t>(game.getSerialNumber());
+}
+
+Card* CardCodec<GameCard>::decode(ByteReader& in) {
+    string name = in.read<string>();
+    int32_t value = in.read<int32_t>();
+    string suit = in.read<string>();
+    bool face = in.read<bool>();
+    int32_t condition = in.read<int32_t>();
+    string manufacturer = in.read<string>();
+    int32_t rarity = in.read<int32_t>();
+    bool foiled = in.read<bool>();
+    string edition = in.read<string>();
+    int32_t serial = in.read<int32_t>();
+
+    GameCard* card = new GameCard(name, value, suit, face, rarity, foiled, edition, serial);
+    try {
+        card->setCondition(condition);
+        card->setManufacturer(manufacturer);
+    } catch (...) {
+        delete card;
+        throw;
+    }
+    return card;
+}
+
+// CardTypeRegistry implementations
+CardTypeRegistry::CardTypeRegistry() {
+    registerType<PlayingCard>(1, "PlayingCard");
+    registerType<GameCard>(2, "GameCard");
+    registerType<SpecialCard<string>>(3, "SpecialCard<string>");
+    registerType<SpecialCard<int>>(4, "SpecialCard<int>");
+    registerType<SpecialCard<double>>(5, "SpecialCard<double>");
+}
+
+CardTypeRegistry& CardTypeRegistry::instance() {
+    static CardTypeRegistry registry;
+    return registry;
+}
+
+void CardTypeRegistry::registerType(uint16_t id, const type_info& type, const string& name,
+                                    Encoder encode, Decoder decode) {
+    if (entries.count(id)) {
+        throw runtime_error("Card type ID " + to_string(id) + " is already registered");
+    }
+    if (idsByType.count(type_index(type))) {
+        throw runtime_error("Card type " + name + " is already registered");
+    }
+    // Map nodes never move, so the entry's address stays valid
+    const Entry& entry = entries[id] = {id, name, encode, decode};
+    idsByType[type_index(type)] = id;
+    knownTypes.push_back({&type, &entry});
+}
+
+void CardTypeRegistry::encode(const Card& card, ByteWriter& out) const {
+    const type_info& type = typeid(card);
+    for (const auto& known : knownTypes) {
+        if (known.first == &type) {
+            out.write(known.second->id);
+            known.second->encode(card, out);
+            return;
+        }
+    }
+    auto it = idsByType.find(type_index(type));
+    if (it == idsByType.end()) {
+        throw runtime_error(string("Card type is not registered for saving: ") + type.name());
+    }
+    out.write(it->second);
+    entries.at(it->second).encode(card, out);
+}
+
+Card* CardTypeRegistry::decode(ByteReader& in) const {
+    uint16_t id = in.read<uint16_t>();
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        throw runtime_error("Unknown card type ID in deck data: " + to_string(id));
+    }
+    return it->second.decode(in);
+}
+
+bool CardTypeRegistry::isRegistered(const Card& card) const {
+    return idsByType.count(type_index(typeid(card))) > 0;
+}
+
+string CardTypeRegistry::getTypeName(uint16_t id) const {
+    auto it = entries.find(id);
+    if (it == entries.end()) {
+        throw runtime_error("Unknown card type ID: " + to_string(id));
+    }
+    return it->second.name;
+}
+
+// Deck file layout
+namespace DeckFormat {
+    void writeHeader(ByteWriter& out, const string& deckName, const string& owner, int maxSize, int cardCount) {
+        out.write(deckName);
+        out.write(owner);
+        out.write<int32_t>(maxSize);
+        out.write<int32_t>(cardCount);
+        out.write(TYPED_CARDS_MARKER);
+    }
+}
@@ -0,0 +1,222 @@
+#ifndef CARDSERIALIZATION_H
+#define CARDSERIALIZATION_H
+
+#include "Card.h"
+#include "PlayingCard.h"
+#include "GameCard.h"
+#include "SpecialCard.h"
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+
+class ByteWriter;
+class ByteReader;
+
+// How a value of type T is stored. Trivially copyable types are copied byte
+// for byte and strings are length-prefixed; any other type used as a
+// SpecialCard effect needs its own specialization with the same two members.
+template<typename T, typename Enable = void>
+struct SerializationTraits {
+    static_assert(sizeof(T) == 0, "Specialize SerializationTraits<T> to save SpecialCard<T>");
+};
+
+// Appends encoded values to one buffer, written to disk in a single call
+class ByteWriter {
+private:
+    vector<char> bytes;
+
+public:
+    void writeRaw(const void* data, size_t size) {
+        const char* begin = static_cast<const char*>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+    }
+
+    template<typename T>
+    void write(const T& value) {
+        SerializationTraits<T>::write(*this, value);
+    }
+
+    void reserve(size_t size);
+    size_t size() const;
+    const char* data() const;
+    void saveToFile(const string& filename) const;
+};
+
+// Reads encoded values from memory; running past the end throws
+class ByteReader {
+private:
+    const char* bytes;
+    size_t length;
+    size_t offset;
+
+public:
+    ByteReader(const char* data, size_t size) : bytes(data), length(size), offset(0) {}
+
+    void readRaw(void* out, size_t size) {
+        if (size > length - offset) {
+            throw runtime_error("Unexpected end of deck data");
+        }
+        memcpy(out, bytes + offset, size);
+        offset += size;
+    }
+
+    template<typename T>
+    T read() {
+        return SerializationTraits<T>::read(*this);
+    }
+
+    template<typename T>
+    T peek() const {
+        ByteReader ahead(*this);
+        return ahead.read<T>();
+    }
+
+    size_t remaining() const { return length - offset; }
+    size_t position() const { return offset; }
+};
+
+template<typename T>
+struct SerializationTraits<T, enable_if_t<is_trivially_copyable<T>::value>> {
+    static void write(ByteWriter& out, const T& value) {
+        out.writeRaw(&value, sizeof(T));
+    }
+
+    static T read(ByteReader& in) {
+        T value;
+        in.readRaw(&value, sizeof(T));
+        return value;
+    }
+};
+
+// A file byte other than 0 or 1 copied into a bool is undefined, so go through uint8_t
+template<>
+struct SerializationTraits<bool> {
+    static void write(ByteWriter& out, const bool& value) {
+        uint8_t byte = value ? 1 : 0;
+        out.writeRaw(&byte, sizeof(byte));
+    }
+
+    static bool read(ByteReader& in) {
+        uint8_t byte;
+        in.readRaw(&byte, sizeof(byte));
+        return byte != 0;
+    }
+};
+
+template<>
+struct SerializationTraits<string> {
+    static void write(ByteWriter& out, const string& value) {
+        int32_t size = static_cast<int32_t>(value.size());
+        out.writeRaw(&size, sizeof(size));
+        out.writeRaw(value.data(), value.size());
+    }
+
+    static string read(ByteReader& in) {
+        int32_t size = in.read<int32_t>();
+        if (size < 0 || static_cast<size_t>(size) > in.remaining()) {
+            throw runtime_error("Invalid string length in deck data");
+        }
+        string value(static_cast<size_t>(size), '\0');
+        in.readRaw(&value[0], value.size());
+        return value;
+    }
+};
+
+// Encodes one concrete card class; specialized per class
+template<typename CardT>
+struct CardCodec;
+
+template<>
+struct CardCodec<PlayingCard> {
+    static void encode(const Card& card, ByteWriter& out);
+    static Card* decode(ByteReader& in);
+};
+
+template<>
+struct CardCodec<GameCard> {
+    static void encode(const Card& card, ByteWriter& out);
+    static Card* decode(ByteReader& in);
+};
+
+template<typename T>
+struct CardCodec<SpecialCard<T>> {
+    static void encode(const Card& card, ByteWriter& out) {
+        const SpecialCard<T>& special = static_cast<const SpecialCard<T>&>(card);
+        out.write(special.getName());
+        out.write<int32_t>(special.getBaseValue());
+        out.write(special.getSpecialEffect());
+        out.write<int32_t>(special.getDurability());
+        out.write(special.getCardType());
+        out.write(special.getPowerLevel());
+    }
+
+    static Card* decode(ByteReader& in) {
+        string name = in.read<string>();
+        int32_t value = in.read<int32_t>();
+        T effect = in.read<T>();
+        int32_t durability = in.read<int32_t>();
+        string type = in.read<string>();
+        double power = in.read<double>();
+        return new SpecialCard<T>(name, value, effect, durability, type, power);
+    }
+};
+
+// Maps each saveable card class to a stable type ID written before its data,
+// so decks mixing card types load back as the same types. The built-in classes
+// use IDs 1-5; register other classes (for example SpecialCard<T> with a
+// custom SerializationTraits<T>) with IDs of 100 and up before saving or
+// loading from several threads.
+class CardTypeRegistry {
+public:
+    using Encoder = void (*)(const Card&, ByteWriter&);
+    using Decoder = Card* (*)(ByteReader&);
+
+private:
+    struct Entry {
+        uint16_t id;
+        string name;
+        Encoder encode;
+        Decoder decode;
+    };
+
+    unordered_map<type_index, uint16_t> idsByType;
+    unordered_map<uint16_t, Entry> entries;
+    // Few types are registered, so comparing type_info addresses first is
+    // cheaper than hashing the type name for every card saved
+    vector<pair<const type_info*, const Entry*>> knownTypes;
+
+    CardTypeRegistry();
+
+public:
+    static CardTypeRegistry& instance();
+
+    template<typename CardT>
+    void registerType(uint16_t id, const string& name) {
+        registerType(id, typeid(CardT), name, &CardCodec<CardT>::encode, &CardCodec<CardT>::decode);
+    }
+
+    void registerType(uint16_t id, const type_info& type, const string& name, Encoder encode, Decoder decode);
+
+    // Writes the card's type ID followed by its data
+    void encode(const Card& card, ByteWriter& out) const;
+    Card* decode(ByteReader& in) const;   // New card; the caller owns it
+
+    bool isRegistered(const Card& card) const;
+    string getTypeName(uint16_t id) const;
+};
+
+// Layout shared by every deck file writer and reader. The header is the
+// original one; TYPED_CARDS_MARKER sits where older files store the first
+// card's name length (always positive), so both formats can be told apart.
+namespace DeckFormat {
+    const int32_t TYPED_CARDS_MARKER = -2;
+
+    void writeHeader(ByteWriter& out, const string& deckName, const string& owner, int maxSize, int cardCount);
+}
+
+#endif // CARDSERIALIZATION_H
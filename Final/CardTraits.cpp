@@ -0,0 +1,92 @@
+#include "CardTraits.h"
+#include "PlayingCard.h"
+#include "GameCard.h"
+
+const char* const CardTraits::SUIT_NAMES[4] = {"Hearts", "Diamonds", "Clubs", "Spades"};
+
+int CardTraits::suitIndex(const string& suit) {
+    for (int i = 0; i < 4; i++) {
+        // Suit names differ in their first letter, so most misses stop there
+        if (!suit.empty() && suit[0] == SUIT_NAMES[i][0] && suit == SUIT_NAMES[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+CardTraits CardTraits::fromCard(const Card& card) {
+    CardTraits traits;
+    traits.value = card.getValue();
+    traits.suit = -1;
+    traits.condition = 0;
+    traits.rarity = 0;
+    traits.faceCard = false;
+    traits.foiled = false;
+    traits.kind = KIND_OTHER;
+
+    if (const PlayingCard* playing = dynamic_cast<const PlayingCard*>(&card)) {
+        traits.kind = KIND_PLAYING;
+        traits.suit = static_cast<int8_t>(suitIndex(playing->getSuit()));
+        traits.condition = static_cast<uint8_t>(playing->getCondition());
+        traits.faceCard = playing->isFaceCard();
+        if (const GameCard* game = dynamic_cast<const GameCard*>(&card)) {
+            traits.kind = KIND_GAME;
+            traits.rarity = static_cast<uint8_t>(game->getRarity());
+            traits.foiled = game->isFoiled();
+        }
+    }
+    return traits;
+}
+
+vector<CardTraits> CardTraits::fromDeck(const Deck& deck) {
+    vector<CardTraits> traits;
+    traits.reserve(deck.getCurrentSize());
+    for (int i = 0; i < deck.getCurrentSize(); i++) {
+        traits.push_back(fromCard(*deck.getCard(i)));
+    }
+    return traits;
+}
+
+vector<CardTraits> CardTraits::fromSnapshot(const DeckSnapshot& snapshot) {
+    vector<CardTraits> traits;
+    traits.reserve(snapshot.getCurrentSize());
+    for (int i = 0; i < snapshot.getCurrentSize(); i++) {
+        traits.push_back(fromCard(snapshot.getCard(i)));
+    }
+    return traits;
+}
+
+// Predicate implementations
+namespace CardFilters {
+    CardPredicate anyCard() {
+        return [](const CardTraits&) { return true; };
+    }
+
+    CardPredicate suit(const string& suitName) {
+        int index = CardTraits::suitIndex(suitName);
+        if (index < 0) {
+            throw runtime_error("Invalid suit. Must be Hearts, Diamonds, Clubs, or Spades");
+        }
+        return [index](const CardTraits& card) { return card.suit == index; };
+    }
+
+    CardPredicate faceCard() {
+        return [](const CardTraits& card) { return card.faceCard; };
+    }
+
+    CardPredicate foiled() {
+        return [](const CardTraits& card) { return card.foiled; };
+    }
+
+    CardPredicate minRarity(int rarity) {
+        return [rarity](const CardTraits& card) { return card.rarity >= rarity; };
+    }
+
+    CardPredicate minValue(int value) {
+        return [value](const CardTraits& card) { return card.value >= value; };
+    }
+
+    CardPredicate both(CardPredicate first, CardPredicate second) {
+        return [first, second](const CardTraits& card) { return first(card) && second(card); };
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef CARDTRAITS_H
+#define CARDTRAITS_H
+
+#include "Card.h"
+#include "Deck.h"
+#include "VersionedDeck.h"
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+enum CardKind : uint8_t {
+    KIND_OTHER,      // Base or special cards
+    KIND_PLAYING,
+    KIND_GAME
+};
+
+// Compact, copyable snapshot of the attributes draw questions are asked about.
+// Probability code works on these instead of chasing Card* and virtual calls.
+struct CardTraits {
+    int value;           // getValue() at snapshot time
+    int8_t suit;         // Index into SUIT_NAMES, or -1 for cards without a suit
+    uint8_t condition;   // 0 for cards without a condition
+    uint8_t rarity;      // 0 for cards that are not game cards
+    bool faceCard;
+    bool foiled;
+    CardKind kind;
+
+    static const char* const SUIT_NAMES[4];
+
+    // Returns the suit index for a suit name, or -1 if it is not a suit
+    static int suitIndex(const string& suit);
+
+    static CardTraits fromCard(const Card& card);
+    static vector<CardTraits> fromDeck(const Deck& deck);
+    static vector<CardTraits> fromSnapshot(const DeckSnapshot& snapshot);
+};
+
+using CardPredicate = function<bool(const CardTraits&)>;
+
+// Common predicates for draw questions
+namespace CardFilters {
+    CardPredicate anyCard();
+    CardPredicate suit(const string& suitName);
+    CardPredicate faceCard();
+    CardPredicate foiled();
+    CardPredicate minRarity(int rarity);
+    CardPredicate minValue(int value);
+    CardPredicate both(CardPredicate first, CardPredicate second);
+}
+
+#endif // CARDTRAITS_H
@@ -0,0 +1,157 @@
+#include "CardTrie.h"
+#include <atomic>
+
+// Constructor
+CardTrie::CardTrie() : root(nullptr), count(0), shift(0) {}
+
+// Core functionality implementations
+int CardTrie::size() const {
+    return count;
+}
+
+bool CardTrie::empty() const {
+    return count == 0;
+}
+
+const CardTrie::CardPtr& CardTrie::get(int index) const {
+    if (index < 0 || index >= count) {
+        throw runtime_error("Card index out of range");
+    }
+    const Node* node = root.get();
+    for (int level = shift; level > 0; level -= BITS) {
+        node = node->children[(index >> level) & MASK].get();
+    }
+    return node->cards[index & MASK];
+}
+
+void CardTrie::set(int index, CardPtr card) {
+    if (index < 0 || index >= count) {
+        throw runtime_error("Card index out of range");
+    }
+    setIn(root, shift, index, move(card));
+}
+
+void CardTrie::pushBack(CardPtr card) {
+    if (!root) {
+        root = newPath(0, move(card));
+    } else if ((count >> BITS) >= (1 << shift)) {
+        // Every slot under the current root is used: grow a level
+        auto grown = make_shared<Node>();
+        grown->children.push_back(root);
+        grown->children.push_back(newPath(shift, move(card)));
+        root = grown;
+        shift += BITS;
+    } else {
+        pushInto(root, shift, count, move(card));
+    }
+    count++;
+}
+
+CardTrie::CardPtr CardTrie::popBack() {
+    if (count == 0) {
+        throw runtime_error("Cannot draw from empty deck");
+    }
+    CardPtr card = get(count - 1);
+    count--;
+    if (count == 0) {
+        root.reset();
+        shift = 0;
+        return card;
+    }
+    popFrom(root, shift, count);
+    while (shift > 0 && root->children.size() == 1) {
+        root = root->children[0];
+        shift -= BITS;
+    }
+    return card;
+}
+
+vector<CardTrie::CardPtr> CardTrie::toVector() const {
+    vector<CardPtr> cards;
+    cards.reserve(count);
+    if (root) {
+        collect(*root, cards);
+    }
+    return cards;
+}
+
+CardTrie CardTrie::fromVector(const vector<CardPtr>& cards) {
+    // Nodes of a trie nobody else holds are filled in place
+    CardTrie trie;
+    for (const auto& card : cards) {
+        trie.pushBack(card);
+    }
+    return trie;
+}
+
+// Private helper implementations
+void CardTrie::makeUnique(shared_ptr<Node>& node) {
+    // A node only this trie can reach may be changed in place; a shared one is
+    // copied first. No other thread can add a reference to a node we hold alone.
+    if (node.use_count() > 1) {
+        node = make_shared<Node>(*node);
+        return;
+    }
+    // use_count() is a relaxed load. The fence pairs it with the releasing
+    // decrement of the thread that dropped the last other reference, so that
+    // thread's reads of the node happen before our writes to it.
+    atomic_thread_fence(memory_order_acquire);
+}
+
+shared_ptr<CardTrie::Node> CardTrie::newPath(int level, CardPtr card) {
+    auto node = make_shared<Node>();
+    if (level == 0) {
+        node->cards.reserve(WIDTH);
+        node->cards.push_back(move(card));
+    } else {
+        node->children.push_back(newPath(level - BITS, move(card)));
+    }
+    return node;
+}
+
+void CardTrie::pushInto(shared_ptr<Node>& node, int level, int index, CardPtr card) {
+    makeUnique(node);
+    if (level == 0) {
+        node->cards.push_back(move(card));
+        return;
+    }
+    size_t slot = (index >> level) & MASK;
+    if (slot < node->children.size()) {
+        pushInto(node->children[slot], level - BITS, index, move(card));
+    } else {
+        node->children.push_back(newPath(level - BITS, move(card)));
+    }
+}
+
+void CardTrie::popFrom(shared_ptr<Node>& node, int level, int index) {
+    makeUnique(node);
+    if (level == 0) {
+        node->cards.pop_back();
+        return;
+    }
+    size_t slot = (index >> level) & MASK;
+    popFrom(node->children[slot], level - BITS, index);
+    const Node& child = *node->children[slot];
+    if (child.children.empty() && child.cards.empty()) {
+        node->children.pop_back();
+    }
+}
+
+void CardTrie::setIn(shared_ptr<Node>& node, int level, int index, CardPtr card) {
+    makeUnique(node);
+    if (level == 0) {
+        node->cards[index & MASK] = move(card);
+    } else {
+        setIn(node->children[(index >> level) & MASK], level - BITS, index, move(card));
+    }
+}
+
+void CardTrie::collect(const Node& node, vector<CardPtr>& out) {
+    if (node.children.empty()) {
+        out.insert(out.end(), node.cards.begin(), node.cards.end());
+        return;
+    }
+    for (const auto& child : node.children) {
+        collect(*child, out);
+    }
+}
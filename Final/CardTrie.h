@@ -0,0 +1,54 @@
+#ifndef CARDTRIE_H
+#define CARDTRIE_H
+
+#include "Card.h"
+#include <memory>
+#include <vector>
+
+// Persistent vector of shared cards: a 32-way trie whose nodes are shared
+// between copies. Copying a CardTrie is O(1); a mutation copies only the nodes
+// on the path to the changed slot (and only when another copy still shares
+// them), so versions that differ by a few cards share everything else.
+// Different copies may be used from different threads; one copy may not.
+class CardTrie {
+public:
+    using CardPtr = shared_ptr<Card>;
+
+private:
+    static const int BITS = 5;
+    static const int WIDTH = 1 << BITS;
+    static const int MASK = WIDTH - 1;
+
+    struct Node {
+        vector<shared_ptr<Node>> children;   // Interior nodes
+        vector<CardPtr> cards;               // Leaves
+    };
+
+    shared_ptr<Node> root;
+    int count;
+    int shift;       // BITS * (height - 1); 0 when the root is a leaf
+
+public:
+    // Constructor
+    CardTrie();
+
+    // Core functionality
+    int size() const;
+    bool empty() const;
+    const CardPtr& get(int index) const;
+    void set(int index, CardPtr card);
+    void pushBack(CardPtr card);
+    CardPtr popBack();
+    vector<CardPtr> toVector() const;
+    static CardTrie fromVector(const vector<CardPtr>& cards);
+
+private:
+    static void makeUnique(shared_ptr<Node>& node);
+    static shared_ptr<Node> newPath(int level, CardPtr card);
+    static void pushInto(shared_ptr<Node>& node, int level, int index, CardPtr card);
+    static void popFrom(shared_ptr<Node>& node, int level, int index);
+    static void setIn(shared_ptr<Node>& node, int level, int index, CardPtr card);
+    static void collect(const Node& node, vector<CardPtr>& out);
+};
+
+#endif // CARDTRIE_H
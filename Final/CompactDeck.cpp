@@ -0,0 +1,135 @@
+#include "CompactDeck.h"
+#include "SplitMix64.h"
+#include <ctime>
+#include <memory>
+
+// Constructor implementation with validation
+CompactDeck::CompactDeck(CardCatalog& sharedCatalog, int size, string name, string ownr)
+    : catalog(&sharedCatalog), maxSize(size), deckName(name), owner(ownr) {
+    if (size < 1) {
+        throw runtime_error("Deck size must be positive");
+    }
+    if (name.empty()) {
+        throw runtime_error("Deck name cannot be empty");
+    }
+    if (ownr.empty()) {
+        throw runtime_error("Owner name cannot be empty");
+    }
+}
+
+// Core functionality implementations
+void CompactDeck::addCard(const Card& card) {
+    if (isFull()) {
+        throw runtime_error("Deck is full - cannot add more cards");
+    }
+    cards.push_back(catalog->instanceOf(card));
+}
+
+void CompactDeck::addCard(const CardInstance& card) {
+    if (isFull()) {
+        throw runtime_error("Deck is full - cannot add more cards");
+    }
+    catalog->getDefinition(card.definition);   // Validates the handle
+    cards.push_back(card);
+}
+
+void CompactDeck::shuffle() {
+    if (isEmpty()) {
+        throw runtime_error("Cannot shuffle empty deck");
+    }
+    SplitMix64 rng(static_cast<uint64_t>(time(0)) ^ reinterpret_cast<uintptr_t>(this));
+    for (size_t i = cards.size() - 1; i > 0; i--) {
+        swap(cards[i], cards[rng.nextBelow(i + 1)]);
+    }
+}
+
+CardInstance CompactDeck::drawCard() {
+    if (isEmpty()) {
+        throw runtime_error("Cannot draw from empty deck");
+    }
+    CardInstance drawn = cards.back();
+    cards.pop_back();
+    return drawn;
+}
+
+// Conversion implementations
+void CompactDeck::addAll(const Deck& deck) {
+    if (getCurrentSize() + deck.getCurrentSize() > maxSize) {
+        throw runtime_error("Deck is full - cannot add more cards");
+    }
+    cards.reserve(cards.size() + deck.getCurrentSize());
+    for (int i = 0; i < deck.getCurrentSize(); i++) {
+        cards.push_back(catalog->instanceOf(*deck.getCard(i)));
+    }
+}
+
+void CompactDeck::copyTo(Deck& deck) const {
+    for (const auto& card : cards) {
+        unique_ptr<Card> full(catalog->materialize(card));
+        deck.addCard(full.get());
+        full.release();
+    }
+}
+
+// Accessor and mutator implementations with validation
+void CompactDeck::setMaxSize(int size) {
+    if (size < 1) {
+        throw runtime_error("Deck size must be positive");
+    }
+    if (size < getCurrentSize()) {
+        throw runtime_error("New max size cannot be less than current number of cards");
+    }
+    maxSize = size;
+}
+
+int CompactDeck::getMaxSize() const {
+    return maxSize;
+}
+
+string CompactDeck::getDeckName() const {
+    return deckName;
+}
+
+string CompactDeck::getOwner() const {
+    return owner;
+}
+
+int CompactDeck::getCurrentSize() const {
+    return static_cast<int>(cards.size());
+}
+
+bool CompactDeck::isEmpty() const {
+    return cards.empty();
+}
+
+bool CompactDeck::isFull() const {
+    return cards.size() >= static_cast<size_t>(maxSize);
+}
+
+const CardInstance& CompactDeck::getCard(int index) const {
+    if (index < 0 || index >= getCurrentSize()) {
+        throw runtime_error("Card index out of range");
+    }
+    return cards[index];
+}
+
+int CompactDeck::getCardValue(int index) const {
+    return catalog->getValue(getCard(index));
+}
+
+const CardCatalog& CompactDeck::getCatalog() const {
+    return *catalog;
+}
+
+size_t CompactDeck::memoryUsage() const {
+    return sizeof(*this) + cards.capacity() * sizeof(CardInstance);
+}
+
+// Operator overloading implementations
+ostream& operator<<(ostream& os, const CompactDeck& deck) {
+    os << "Deck: " << deck.deckName
+       << " (Owner: " << deck.owner
+       << ", Cards: " << deck.getCurrentSize()
+       << "/" << deck.maxSize << ")";
+    return os;
+}
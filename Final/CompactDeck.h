@@ -0,0 +1,54 @@
+#ifndef COMPACTDECK_H
+#define COMPACTDECK_H
+
+#include "CardCatalog.h"
+#include "Deck.h"
+#include <vector>
+#include <string>
+
+// Deck of CardInstance handles into a shared CardCatalog, for holding large
+// collections. Each card costs sizeof(CardInstance) bytes; names and other
+// shared attributes live once in the catalog. The catalog must outlive the
+// deck, and decks sharing a catalog must not be changed from different
+// threads at once.
+class CompactDeck {
+private:
+    CardCatalog* catalog;
+    vector<CardInstance> cards;
+    int maxSize;
+    string deckName;
+    string owner;
+
+public:
+    // Constructor
+    CompactDeck(CardCatalog& sharedCatalog, int size = 52, string name = "Standard Deck",
+                string ownr = "Player");
+
+    // Core functionality
+    void addCard(const Card& card);          // Copies the card; the caller keeps it
+    void addCard(const CardInstance& card);
+    void shuffle();
+    CardInstance drawCard();                 // Remove and return top card
+
+    // Conversion to and from plain decks
+    void addAll(const Deck& deck);
+    void copyTo(Deck& deck) const;           // Appends full copies of every card
+
+    // Accessors and mutators with validation
+    void setMaxSize(int size);
+    int getMaxSize() const;
+    string getDeckName() const;
+    string getOwner() const;
+    int getCurrentSize() const;
+    bool isEmpty() const;
+    bool isFull() const;
+    const CardInstance& getCard(int index) const;
+    int getCardValue(int index) const;
+    const CardCatalog& getCatalog() const;
+    size_t memoryUsage() const;              // Bytes held by this deck, excluding the catalog
+
+    // Operator overloading
+    friend ostream& operator<<(ostream& os, const CompactDeck& deck);
+};
+
+#endif // COMPACTDECK_H
@@ -0,0 +1,181 @@
+#include "ConcurrentDeck.h"
+#include <algorithm>
+#include <random>
+
+// Constructor implementation with validation
+ConcurrentDeck::ConcurrentDeck(int size, string name, string ownr)
+    : maxSize(size), deckName(name), owner(ownr) {
+    if (size < 1) {
+        throw runtime_error("Deck size must be positive");
+    }
+    if (name.empty()) {
+        throw runtime_error("Deck name cannot be empty");
+    }
+    if (ownr.empty()) {
+        throw runtime_error("Owner name cannot be empty");
+    }
+
+    // Every node starts on the free stack, linked in index order
+    nodes.reset(new Node[size]);
+    for (int i = 0; i < size; i++) {
+        nodes[i].card.store(nullptr, memory_order_relaxed);
+        nodes[i].next.store(i + 1 < size ? static_cast<uint32_t>(i + 1) : NO_NODE, memory_order_relaxed);
+        nodes[i].depth.store(0, memory_order_relaxed);
+    }
+    cardHead.store(pack(NO_NODE, 0));
+    freeHead.store(pack(0, 0));
+}
+
+// Destructor implementation
+ConcurrentDeck::~ConcurrentDeck() {
+    while (Card* card = tryDrawCard()) {
+        delete card;
+    }
+}
+
+// Core functionality implementations
+void ConcurrentDeck::addCard(Card* card) {
+    if (!tryAddCard(card)) {
+        throw runtime_error("Deck is full - cannot add more cards");
+    }
+}
+
+bool ConcurrentDeck::tryAddCard(Card* card) {
+    if (!card) {
+        throw runtime_error("Cannot add null card to deck");
+    }
+    uint32_t index = pop(freeHead);
+    if (index == NO_NODE) {
+        return false;
+    }
+    nodes[index].card.store(card, memory_order_relaxed);
+    push(cardHead, index, true);
+    return true;
+}
+
+Card* ConcurrentDeck::drawCard() {
+    Card* card = tryDrawCard();
+    if (!card) {
+        throw runtime_error("Cannot draw from empty deck");
+    }
+    return card;
+}
+
+Card* ConcurrentDeck::tryDrawCard() {
+    uint32_t index = pop(cardHead);
+    if (index == NO_NODE) {
+        return nullptr;
+    }
+    Card* card = nodes[index].card.exchange(nullptr, memory_order_relaxed);
+    push(freeHead, index, false);
+    return card;
+}
+
+void ConcurrentDeck::shuffle() {
+    vector<Card*> cards;
+    while (Card* card = tryDrawCard()) {
+        cards.push_back(card);
+    }
+    if (cards.empty()) {
+        throw runtime_error("Cannot shuffle empty deck");
+    }
+    mt19937_64 rng(random_device{}());
+    std::shuffle(cards.begin(), cards.end(), rng);
+    for (auto card : cards) {
+        addCard(card);
+    }
+}
+
+// Accessor implementations
+int ConcurrentDeck::getMaxSize() const {
+    return maxSize;
+}
+
+string ConcurrentDeck::getDeckName() const {
+    return deckName;
+}
+
+string ConcurrentDeck::getOwner() const {
+    return owner;
+}
+
+int ConcurrentDeck::getCurrentSize() const {
+    // The top node's depth is only trusted if the head did not move while reading
+    // it; a changed tag means the node may have been recycled in between.
+    uint64_t head = cardHead.load(memory_order_acquire);
+    while (true) {
+        uint32_t index = indexOf(head);
+        if (index == NO_NODE) {
+            return 0;
+        }
+        uint32_t depth = nodes[index].depth.load(memory_order_acquire);
+        uint64_t again = cardHead.load(memory_order_acquire);
+        if (again == head) {
+            return static_cast<int>(depth);
+        }
+        head = again;
+    }
+}
+
+bool ConcurrentDeck::isEmpty() const {
+    return indexOf(cardHead.load(memory_order_acquire)) == NO_NODE;
+}
+
+bool ConcurrentDeck::isFull() const {
+    return indexOf(freeHead.load(memory_order_acquire)) == NO_NODE;
+}
+
+// Lock-free stack helpers
+uint64_t ConcurrentDeck::pack(uint32_t index, uint32_t tag) {
+    return (static_cast<uint64_t>(tag) << 32) | index;
+}
+
+uint32_t ConcurrentDeck::indexOf(uint64_t head) {
+    return static_cast<uint32_t>(head);
+}
+
+uint32_t ConcurrentDeck::tagOf(uint64_t head) {
+    return static_cast<uint32_t>(head >> 32);
+}
+
+uint32_t ConcurrentDeck::pop(atomic<uint64_t>& head) {
+    uint64_t old = head.load(memory_order_acquire);
+    while (true) {
+        uint32_t index = indexOf(old);
+        if (index == NO_NODE) {
+            return NO_NODE;
+        }
+        // Nodes are never freed, so a stale next is harmless: the tag makes the CAS fail
+        uint32_t next = nodes[index].next.load(memory_order_relaxed);
+        if (head.compare_exchange_weak(old, pack(next, tagOf(old) + 1),
+                                       memory_order_acq_rel, memory_order_acquire)) {
+            return index;
+        }
+    }
+}
+
+void ConcurrentDeck::push(atomic<uint64_t>& head, uint32_t index, bool trackDepth) {
+    Node& node = nodes[index];
+    uint64_t old = head.load(memory_order_acquire);
+    while (true) {
+        uint32_t top = indexOf(old);
+        node.next.store(top, memory_order_relaxed);
+        if (trackDepth) {
+            uint32_t below = (top == NO_NODE) ? 0 : nodes[top].depth.load(memory_order_relaxed);
+            node.depth.store(below + 1, memory_order_relaxed);
+        }
+        if (head.compare_exchange_weak(old, pack(index, tagOf(old) + 1),
+                                       memory_order_release, memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+// Operator overloading implementation
+ostream& operator<<(ostream& os, const ConcurrentDeck& deck) {
+    os << "Concurrent Deck: " << deck.deckName
+       << " (Owner: " << deck.owner
+       << ", Cards: " << deck.getCurrentSize()
+       << "/" << deck.maxSize << ")";
+    return os;
+}
@@ -0,0 +1,71 @@
+#ifndef CONCURRENTDECK_H
+#define CONCURRENTDECK_H
+
+#include "Card.h"
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <vector>
+
+// Thread-safe deck for many concurrent players. Cards live in a Treiber stack
+// built over a fixed pool of maxSize nodes; unused nodes sit on a second free
+// stack. Both stack heads pack a node index with an ABA tag so every operation
+// is a single lock-free compare-and-swap.
+class ConcurrentDeck {
+private:
+    static const uint32_t NO_NODE = 0xFFFFFFFFu;
+
+    struct Node {
+        atomic<Card*> card;
+        atomic<uint32_t> next;
+        atomic<uint32_t> depth;   // Number of cards from this node to the bottom
+    };
+
+    unique_ptr<Node[]> nodes;
+    int maxSize;
+    string deckName;
+    string owner;
+
+    // Each head sits on its own cache line so draws and node recycling do not share one
+    alignas(64) atomic<uint64_t> cardHead;
+    alignas(64) atomic<uint64_t> freeHead;
+
+public:
+    // Constructor
+    ConcurrentDeck(int size = 52, string name = "Shared Deck", string ownr = "Server");
+
+    // Destructor
+    ~ConcurrentDeck();
+
+    ConcurrentDeck(const ConcurrentDeck&) = delete;
+    ConcurrentDeck& operator=(const ConcurrentDeck&) = delete;
+
+    // Core functionality; all of these are safe to call from any number of threads
+    void addCard(Card* card);
+    bool tryAddCard(Card* card);   // Returns false instead of throwing when full
+    Card* drawCard();
+    Card* tryDrawCard();           // Returns nullptr instead of throwing when empty
+
+    // Not thread-safe: callers must make sure no other operation runs meanwhile
+    void shuffle();
+
+    // Accessors
+    int getMaxSize() const;
+    string getDeckName() const;
+    string getOwner() const;
+    int getCurrentSize() const;
+    bool isEmpty() const;
+    bool isFull() const;
+
+    friend ostream& operator<<(ostream& os, const ConcurrentDeck& deck);
+
+private:
+    static uint64_t pack(uint32_t index, uint32_t tag);
+    static uint32_t indexOf(uint64_t head);
+    static uint32_t tagOf(uint64_t head);
+
+    uint32_t pop(atomic<uint64_t>& head);
+    void push(atomic<uint64_t>& head, uint32_t index, bool trackDepth);
+};
+
+#endif // CONCURRENTDECK_H
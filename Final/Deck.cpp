@@ -1,8 +1,13 @@
 #include "Deck.h"
 #include "PlayingCard.h"
+#include "Stats.h"
+#include "SplitMix64.h"
+#include "CardSerialization.h"
 
 // Constructor implementation with validation
-Deck::Deck(int size, string name, string ownr) : maxSize(size), deckName(name), owner(ownr) {
+Deck::Deck(int size, string name, string ownr)
+    : maxSize(size), deckName(name), owner(ownr), changes(0), cachedTotalValue(0), totalValueGeneration(UINT64_MAX),
+      drawTableWeighting(WEIGHT_UNIFORM), drawTableGeneration(UINT64_MAX) {
     setMaxSize(size);
     setDeckName(name);
     setOwner(ownr);
@@ -24,10 +29,14 @@ void Deck::addCard(Card* card) {
     if (!card) {
         throw runtime_error("Cannot add null card to deck");
     }
+    STATS_SAMPLED_TIMER(TIMER_DECK_ADD);
     cards.push_back(card);
+    if (nameIndex) nameIndex->add(card);
+    markChanged();
 }
 
 void Deck::shuffle() {
+    STATS_TIMER(TIMER_DECK_SHUFFLE);
     if (isEmpty()) {
         throw runtime_error("Cannot shuffle empty deck");
     }
@@ -36,9 +45,23 @@ void Deck::shuffle() {
         size_t j = rand() % cards.size();
         swap(cards[i], cards[j]);
     }
+    markChanged();
+}
+
+void Deck::shuffle(uint64_t seed) {
+    STATS_TIMER(TIMER_DECK_SHUFFLE);
+    if (isEmpty()) {
+        throw runtime_error("Cannot shuffle empty deck");
+    }
+    SplitMix64 rng(seed);
+    for (size_t i = cards.size() - 1; i > 0; i--) {
+        swap(cards[i], cards[rng.nextBelow(i + 1)]);
+    }
+    markChanged();
 }
 
 void Deck::displayAllCards() const {
+    STATS_TIMER(TIMER_DECK_DISPLAY);
     if (isEmpty()) {
         cout << "Deck is empty." << endl;
         return;
@@ -59,11 +82,101 @@ Card* Deck::drawCard() {
     if (isEmpty()) {
         throw runtime_error("Cannot draw from empty deck");
     }
+    STATS_SAMPLED_TIMER(TIMER_DECK_DRAW);
     Card* drawnCard = cards.back();
     cards.pop_back();
+    if (nameIndex) nameIndex->remove(drawnCard);
+    markChanged();
+    return drawnCard;
+}
+
+void Deck::sortBy(const vector<DeckSortKey>& keys, int threads) {
+    DeckSorter::sort(cards, keys, threads);
+    markChanged();
+}
+
+Card* Deck::drawRandom(mt19937_64& rng) {
+    if (isEmpty()) {
+        throw runtime_error("Cannot draw from empty deck");
+    }
+    size_t index = uniform_int_distribution<size_t>(0, cards.size() - 1)(rng);
+    Card* drawnCard = cards[index];
+    cards[index] = cards.back();
+    cards.pop_back();
+    if (nameIndex) nameIndex->remove(drawnCard);
+    markChanged();
     return drawnCard;
 }
 
+vector<Card*> Deck::drawWeighted(int count, DrawWeighting weighting, mt19937_64& rng) {
+    if (count < 0 || count > getCurrentSize()) {
+        throw runtime_error("Cannot draw more cards than the deck holds");
+    }
+    vector<Card*> drawn;
+    if (count == 0) {
+        return drawn;
+    }
+    // Only a change made outside weighted draws forces a rebuild
+    if (getGeneration() != drawTableGeneration || weighting != drawTableWeighting) {
+        drawTable.build(cards, weighting);
+        slotPosition.resize(cards.size());
+        positionSlot.resize(cards.size());
+        for (size_t i = 0; i < cards.size(); i++) {
+            slotPosition[i] = static_cast<uint32_t>(i);
+            positionSlot[i] = static_cast<uint32_t>(i);
+        }
+        drawTableWeighting = weighting;
+        drawTableGeneration = getGeneration();
+    }
+    if (drawTable.getLiveCount() < static_cast<size_t>(count)) {
+        throw runtime_error("Not enough cards with a positive draw weight");
+    }
+    drawn.reserve(count);
+    for (int i = 0; i < count; i++) {
+        size_t slot = drawTable.sample(rng);
+        drawTable.remove(slot);
+        uint32_t position = slotPosition[slot];
+        drawn.push_back(cards[position]);
+        if (nameIndex) nameIndex->remove(cards[position]);
+
+        // As in drawRandom, the top card moves into the gap
+        uint32_t top = static_cast<uint32_t>(cards.size() - 1);
+        uint32_t topSlot = positionSlot[top];
+        cards[position] = cards[top];
+        positionSlot[position] = topSlot;
+        slotPosition[topSlot] = position;
+        cards.pop_back();
+        positionSlot.pop_back();
+    }
+    markChanged();
+    drawTableGeneration = getGeneration();
+    return drawn;
+}
+
+int Deck::removeCards(const vector<int>& positions) {
+    for (size_t i = 0; i < positions.size(); i++) {
+        if (positions[i] < 0 || positions[i] >= getCurrentSize() || (i > 0 && positions[i] <= positions[i - 1])) {
+            throw runtime_error("Card positions must be ascending and inside the deck");
+        }
+    }
+
+    // One compaction pass, so removing many cards stays linear in the deck size
+    size_t next = 0;
+    size_t kept = 0;
+    for (size_t i = 0; i < cards.size(); i++) {
+        if (next < positions.size() && static_cast<size_t>(positions[next]) == i) {
+            if (nameIndex) nameIndex->remove(cards[i]);
+            delete cards[i];
+            next++;
+        } else {
+            cards[kept++] = cards[i];
+        }
+    }
+    cards.resize(kept);
+    markChanged();
+    return static_cast<int>(next);
+}
+
 // Accessor and mutator implementations with validation
 void Deck::setMaxSize(int size) {
     if (size < 1) {
@@ -113,130 +226,250 @@ bool Deck::isFull() const {
     return cards.size() >= static_cast<size_t>(maxSize);
 }
 
+Card* Deck::getCard(int index) const {
+    if (index < 0 || index >= getCurrentSize()) {
+        throw runtime_error("Card index out of range");
+    }
+    return cards[index];
+}
+
+// View and bulk move implementations
+DeckView Deck::view() const {
+    return DeckView(cards.data(), cards.size());
+}
+
+DeckView Deck::view(int begin, int count) const {
+    return view().slice(begin, count);
+}
+
+void Deck::moveTopTo(Deck& target, int count) {
+    if (&target == this) {
+        throw runtime_error("Cannot move cards onto the same deck");
+    }
+    if (count < 0 || count > getCurrentSize()) {
+        throw runtime_error("Cannot move more cards than the deck holds");
+    }
+    if (target.getCurrentSize() + count > target.maxSize) {
+        throw runtime_error("Target deck does not have room for the cards");
+    }
+    target.cards.insert(target.cards.end(), cards.end() - count, cards.end());
+    for (auto it = cards.end() - count; it != cards.end(); ++it) {
+        if (nameIndex) nameIndex->remove(*it);
+        if (target.nameIndex) target.nameIndex->add(*it);
+    }
+    cards.resize(cards.size() - count);
+    markChanged();
+    target.markChanged();
+}
+
+void Deck::deal(const vector<Deck*>& hands, int cardsEach) {
+    if (cardsEach < 0) {
+        throw runtime_error("Cards per hand cannot be negative");
+    }
+    if (static_cast<long long>(hands.size()) * cardsEach > getCurrentSize()) {
+        throw runtime_error("Not enough cards to deal every hand");
+    }
+    checkDistinct(hands);
+    for (auto hand : hands) {
+        if (hand->getCurrentSize() + cardsEach > hand->maxSize) {
+            throw runtime_error("Hand " + hand->deckName + " does not have room for the cards");
+        }
+    }
+
+    // Reserve first so no copy below can fail after cards have been handed out
+    for (auto hand : hands) {
+        hand->cards.reserve(hand->cards.size() + cardsEach);
+    }
+    // Whole blocks rather than one card per hand in turn; for a shuffled deck
+    // every hand gets the same distribution of cards either way
+    size_t top = cards.size();
+    for (auto hand : hands) {
+        hand->cards.insert(hand->cards.end(), cards.begin() + (top - cardsEach), cards.begin() + top);
+        for (size_t i = top - cardsEach; i < top; i++) {
+            if (nameIndex) nameIndex->remove(cards[i]);
+            if (hand->nameIndex) hand->nameIndex->add(cards[i]);
+        }
+        hand->markChanged();
+        top -= cardsEach;
+    }
+    cards.resize(top);
+    markChanged();
+}
+
+void Deck::cut(int position) {
+    if (position < 0 || position > getCurrentSize()) {
+        throw runtime_error("Cut position must be inside the deck");
+    }
+    rotate(cards.begin(), cards.begin() + position, cards.end());
+    markChanged();
+}
+
+void Deck::splitInto(Deck& other) {
+    moveTopTo(other, getCurrentSize() / 2);
+}
+
+void Deck::mergeFrom(const vector<Deck*>& sources) {
+    checkDistinct(sources);
+    size_t total = cards.size();
+    for (auto source : sources) {
+        total += source->cards.size();
+    }
+    if (total > static_cast<size_t>(maxSize)) {
+        throw runtime_error("Merged deck would exceed its maximum size");
+    }
+    cards.reserve(total);
+    for (auto source : sources) {
+        cards.insert(cards.end(), source->cards.begin(), source->cards.end());
+        if (nameIndex) {
+            for (auto card : source->cards) nameIndex->add(card);
+        }
+        source->cards.clear();
+        source->nameIndex.reset();
+        source->markChanged();
+    }
+    markChanged();
+}
+
+// Aggregate implementations
+uint64_t Deck::getGeneration() const {
+    // Both counters only grow, so their sum moves whenever either does
+    return changes + Card::getValueEpoch();
+}
+
+long long Deck::getTotalValue() const {
+    uint64_t generation = getGeneration();
+    if (generation != totalValueGeneration) {
+        long long total = 0;
+        for (const auto card : cards) {
+            total += card->getValue();
+        }
+        cachedTotalValue = total;
+        totalValueGeneration = generation;
+    }
+    return cachedTotalValue;
+}
+
+DeckMemoryReport Deck::memoryReport() const {
+    DeckMemoryReport report;
+    report.deckBytes = sizeof(Deck) + report.addString(deckName) + report.addString(owner);
+    report.pointerArrayBytes = cards.capacity() * sizeof(Card*);
+    report.unusedPointerBytes = (cards.capacity() - cards.size()) * sizeof(Card*);
+    if (cards.capacity() > 0) {
+        report.addBlock(cards.data(), report.pointerArrayBytes);
+    }
+    for (const auto card : cards) {
+        report.addCard(*card);
+    }
+    report.finish();
+    return report;
+}
+
+// Name search implementations
+const CardNameIndex& Deck::getNameIndex() const {
+    if (!nameIndex) {
+        nameIndex.reset(new CardNameIndex());
+        nameIndex->build(cards);
+    }
+    return *nameIndex;
+}
+
+void Deck::refreshNameIndex() {
+    nameIndex.reset();
+}
+
 // File operations with enhanced error handling
 void Deck::saveToBinary(const string& filename) {
+    STATS_TIMER(TIMER_DECK_SAVE);
     if (filename.empty()) {
         throw runtime_error("Filename cannot be empty");
     }
     
-    ofstream file(filename, ios::binary);
-    if (!file) {
-        throw runtime_error("Could not open file for writing: " + filename);
-    }
-    
-    // Write deck metadata
-    int nameLength = deckName.length();
-    file.write(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
-    file.write(deckName.c_str(), nameLength);
-    
-    int ownerLength = owner.length();
-    file.write(reinterpret_cast<char*>(&ownerLength), sizeof(ownerLength));
-    file.write(owner.c_str(), ownerLength);
-    
-    file.write(reinterpret_cast<char*>(&maxSize), sizeof(maxSize));
-    
-    // Write number of cards
-    int size = getCurrentSize();
-    file.write(reinterpret_cast<char*>(&size), sizeof(size));
-    
-    // Write card data
+    // Encode the whole deck into one buffer and write it in a single call
+    ByteWriter out;
+    writeTo(out);
+    out.saveToFile(filename);
+}
+
+void Deck::writeTo(ByteWriter& out) const {
+    const CardTypeRegistry& registry = CardTypeRegistry::instance();
+    out.reserve(out.size() + 64 + cards.size() * 48);
+    DeckFormat::writeHeader(out, deckName, owner, maxSize, getCurrentSize());
     for (const auto& card : cards) {
-        string name = card->getName();
-        int value = card->getValue();
-        
-        int cardNameLength = name.length();
-        file.write(reinterpret_cast<char*>(&cardNameLength), sizeof(cardNameLength));
-        file.write(name.c_str(), cardNameLength);
-        file.write(reinterpret_cast<char*>(&value), sizeof(value));
-    }
-    
-    if (!file.good()) {
-        throw runtime_error("Error occurred while writing to file");
+        registry.encode(*card, out);
     }
 }
 
 void Deck::loadFromBinary(const string& filename) {
+    STATS_TIMER(TIMER_DECK_LOAD);
     if (filename.empty()) {
         throw runtime_error("Filename cannot be empty");
     }
     
-    ifstream file(filename, ios::binary);
+    ifstream file(filename, ios::binary | ios::ate);
     if (!file) {
         throw runtime_error("Could not open file for reading: " + filename);
     }
     
+    // Read the whole file at once, then decode from memory
+    vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(data.data(), static_cast<streamsize>(data.size()));
+    if (!file.good()) {
+        throw runtime_error("Error reading deck file: " + filename);
+    }
+    loadFromBuffer(data.data(), data.size());
+    STATS_COUNT(COUNTER_BYTES_READ, static_cast<uint64_t>(data.size()));
+}
+
+void Deck::loadFromBuffer(const char* data, size_t size) {
+    ByteReader in(data, size);
+    
     // Clear existing cards
     for (auto card : cards) {
         delete card;
     }
     cards.clear();
+    nameIndex.reset();   // Rebuilt in one pass on the next search
+    markChanged();
     
     // Read deck metadata
-    int nameLength;
-    file.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
-    if (!file.good() || nameLength <= 0 || nameLength > 1000) {
-        throw runtime_error("Invalid deck name length in file");
-    }
-    
-    // Fixed: Proper string reading
-    vector<char> nameBuffer(nameLength + 1, '\0');
-    file.read(nameBuffer.data(), nameLength);
-    if (!file.good()) {
-        throw runtime_error("Error reading deck name");
-    }
-    deckName = string(nameBuffer.data(), nameLength);
-    
-    int ownerLength;
-    file.read(reinterpret_cast<char*>(&ownerLength), sizeof(ownerLength));
-    if (!file.good() || ownerLength <= 0 || ownerLength > 1000) {
-        throw runtime_error("Invalid owner name length in file");
-    }
-    
-    // Fixed: Proper string reading
-    vector<char> ownerBuffer(ownerLength + 1, '\0');
-    file.read(ownerBuffer.data(), ownerLength);
-    if (!file.good()) {
-        throw runtime_error("Error reading owner name");
-    }
-    owner = string(ownerBuffer.data(), ownerLength);
+    deckName = readBoundedString(in, "Invalid deck name length in file", "Error reading deck name");
+    owner = readBoundedString(in, "Invalid owner name length in file", "Error reading owner name");
     
-    file.read(reinterpret_cast<char*>(&maxSize), sizeof(maxSize));
-    if (!file.good()) {
+    if (in.remaining() < sizeof(int32_t)) {
         throw runtime_error("Error reading max size");
     }
+    int32_t storedMaxSize = in.read<int32_t>();
+    if (storedMaxSize < 1) {
+        throw runtime_error("Invalid max size in file");
+    }
     
     // Read number of cards
-    int size;
-    file.read(reinterpret_cast<char*>(&size), sizeof(size));
-    if (!file.good() || size < 0) {
+    int count = in.remaining() >= sizeof(int32_t) ? in.read<int32_t>() : -1;
+    if (count < 0 || count > storedMaxSize) {
         throw runtime_error("Invalid card count in file");
     }
+    maxSize = storedMaxSize;
     
-    // Read card data (simplified - creates basic Card objects)
-    for (int i = 0; i < size; i++) {
-        int cardNameLength;
-        file.read(reinterpret_cast<char*>(&cardNameLength), sizeof(cardNameLength));
-        if (!file.good() || cardNameLength <= 0 || cardNameLength > 1000) {
-            throw runtime_error("Invalid card name length");
+    if (in.remaining() >= sizeof(int32_t) && in.peek<int32_t>() == DeckFormat::TYPED_CARDS_MARKER) {
+        // Current format: every card is stored with its type
+        in.read<int32_t>();
+        const CardTypeRegistry& registry = CardTypeRegistry::instance();
+        cards.reserve(min<size_t>(count, in.remaining() / sizeof(uint16_t)));
+        for (int i = 0; i < count; i++) {
+            cards.push_back(registry.decode(in));
         }
-        
-        // Fixed: Proper string reading for card names
-        vector<char> cardNameBuffer(cardNameLength + 1, '\0');
-        file.read(cardNameBuffer.data(), cardNameLength);
-        if (!file.good()) {
-            throw runtime_error("Error reading card name");
-        }
-        string cardName(cardNameBuffer.data(), cardNameLength);
-        
-        int value;
-        file.read(reinterpret_cast<char*>(&value), sizeof(value));
-        if (!file.good()) {
+        return;
+    }
+    
+    // Older files only kept each card's name and value
+    for (int i = 0; i < count; i++) {
+        string cardName = readBoundedString(in, "Invalid card name length", "Error reading card name");
+        if (in.remaining() < sizeof(int32_t)) {
             throw runtime_error("Error reading card value");
         }
-        
-        // Create a basic PlayingCard (you might want to enhance this)
-        PlayingCard* card = new PlayingCard(cardName, value);
-        cards.push_back(card);
+        int value = in.read<int32_t>();
+        cards.push_back(new PlayingCard(cardName, value));
     }
 }
 
@@ -271,4 +504,36 @@ istream& operator>>(istream& is, Deck& deck) {
     deck.setMaxSize(maxSize);
     
     return is;
+}
+
+// Private helper implementations
+void Deck::markChanged() {
+    changes++;
+}
+
+void Deck::checkDistinct(const vector<Deck*>& decks) const {
+    vector<Deck*> sorted(decks);
+    sort(sorted.begin(), sorted.end());
+    if (!sorted.empty() && sorted.front() == nullptr) {
+        throw runtime_error("Deck list contains a missing deck");
+    }
+    if (adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) {
+        throw runtime_error("Deck list contains the same deck twice");
+    }
+    if (binary_search(sorted.begin(), sorted.end(), const_cast<Deck*>(this))) {
+        throw runtime_error("A deck cannot deal to or merge with itself");
+    }
+}
+
+string Deck::readBoundedString(ByteReader& in, const char* lengthError, const char* dataError) {
+    int32_t length = in.remaining() >= sizeof(int32_t) ? in.read<int32_t>() : 0;
+    if (length <= 0 || length > 1000) {
+        throw runtime_error(lengthError);
+    }
+    if (in.remaining() < static_cast<size_t>(length)) {
+        throw runtime_error(dataError);
+    }
+    string text(static_cast<size_t>(length), '\0');
+    in.readRaw(&text[0], text.size());
+    return text;
 }
\ No newline at end of file
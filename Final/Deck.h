@@ -2,11 +2,21 @@
 #define DECK_H
 
 #include "Card.h"
+#include "DeckSorter.h"
+#include "DeckView.h"
+#include "AliasTable.h"
+#include "MemoryReport.h"
+#include "CardNameIndex.h"
+#include <cstdint>
 #include <vector>
 #include <fstream>
 #include <ctime>
 #include <algorithm>
 #include <filesystem>
+#include <memory>
+
+class ByteReader;
+class ByteWriter;
 
 class Deck {
 private:
@@ -14,6 +24,15 @@ private:
     int maxSize;
     string deckName;     // Name/theme of the deck
     string owner;        // Owner of the deck
+    uint64_t changes;    // Bumped whenever cards are added, removed or reordered
+    mutable long long cachedTotalValue;
+    mutable uint64_t totalValueGeneration;
+    mutable unique_ptr<CardNameIndex> nameIndex;   // Built on first use, then kept in step
+    AliasTable drawTable;             // Kept between weighted draws until the generation moves
+    vector<uint32_t> slotPosition;    // Table entry -> position in cards
+    vector<uint32_t> positionSlot;    // Position in cards -> table entry
+    DrawWeighting drawTableWeighting;
+    uint64_t drawTableGeneration;
 
 public:
     // Constructor
@@ -25,8 +44,13 @@ public:
     // Core functionality
     void addCard(Card* card);
     void shuffle();
+    void shuffle(uint64_t seed);  // Same seed and cards give the same order
     void displayAllCards() const;
     Card* drawCard();  // Remove and return top card
+    int removeCards(const vector<int>& positions);  // Delete cards at ascending positions
+    void sortBy(const vector<DeckSortKey>& keys, int threads = 0);  // Stable; smallest card first
+    Card* drawRandom(mt19937_64& rng);  // O(1) without shuffling; the top card fills the gap
+    vector<Card*> drawWeighted(int count, DrawWeighting weighting, mt19937_64& rng);  // Without replacement; the top card fills each gap
     
     // Accessors and mutators with validation
     void setMaxSize(int size);
@@ -38,14 +62,44 @@ public:
     int getCurrentSize() const;
     bool isEmpty() const;
     bool isFull() const;
+    Card* getCard(int index) const;  // Read-only access; the deck keeps ownership
+    
+    // Views and bulk moves. Moves hand over card pointers in contiguous
+    // blocks, so they allocate at most once per receiving deck and never
+    // touch the cards themselves.
+    DeckView view() const;
+    DeckView view(int begin, int count) const;
+    void moveTopTo(Deck& target, int count);             // Keeps the cards' order
+    void deal(const vector<Deck*>& hands, int cardsEach); // Hand i gets the i-th block from the top
+    void cut(int position);                               // Cards from position up go to the bottom
+    void splitInto(Deck& other);                          // Moves the top half onto other
+    void mergeFrom(const vector<Deck*>& sources);         // Appends every source, leaving them empty
+    
+    // Aggregates
+    uint64_t getGeneration() const;  // Moves whenever the cards or any card's value change
+    long long getTotalValue() const; // Sum of getValue(); recomputed only when the generation moves
+    DeckMemoryReport memoryReport() const;   // Bytes held by the deck and its cards
+    
+    // Name search. The index is built from the whole deck on first use and then
+    // updated as cards come and go; cards renamed while in the deck need
+    // refreshNameIndex() before they can be found under their new name.
+    const CardNameIndex& getNameIndex() const;
+    void refreshNameIndex();
     
     // File operations
     void saveToBinary(const string& filename);
+    void writeTo(ByteWriter& out) const;                 // Same bytes, appended to out
     void loadFromBinary(const string& filename);
+    void loadFromBuffer(const char* data, size_t size);  // Same format, already in memory
     
     // Operator overloading (BOTH required)
     friend ostream& operator<<(ostream& os, const Deck& deck);
     friend istream& operator>>(istream& is, Deck& deck);
+    
+private:
+    void markChanged();
+    void checkDistinct(const vector<Deck*>& decks) const;  // No nulls, repeats or this deck
+    static string readBoundedString(ByteReader& in, const char* lengthError, const char* dataError);
 };
 
 #endif // DECK_H
\ No newline at end of file
@@ -0,0 +1,2267 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include "Benchmark.h"
+#include "Card.h"
+#include "PlayingCard.h"
+#include "GameCard.h"
+#include "SpecialCard.h"
+#include "Deck.h"
+#include "ConcurrentDeck.h"
+#include "Shoe.h"
+#include "BoosterGenerator.h"
+#include "SessionTrace.h"
+#include "DeckDelta.h"
+#include "DeckStore.h"
+#include "MemoryTracker.h"
+#ifdef CARDGAME_SHARED_DECK
+#include "SharedDeck.h"
+#include <unistd.h>
+#endif
+#include "VersionedDeck.h"
+#include "CompactDeck.h"
+#include "CardSerialization.h"
+#include "EffectTicker.h"
+#include "AutosaveService.h"
+#include "GameSimulator.h"
+#include "MonteCarloEstimator.h"
+#include "HypergeometricOdds.h"
+#include "Rules.h"
+#include "FileManager.h"
+#include "DeckCollectionLoader.h"
+#include "SaveIndex.h"
+#include "Stats.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Prevents the optimizer from discarding benchmark results
+static volatile long long benchSink = 0;
+
+static const string SUITS[] = {"Hearts", "Diamonds", "Clubs", "Spades"};
+
+// Card factories used to build benchmark decks
+Card* makePlayingCard(long long i) {
+    return new PlayingCard("Card " + to_string(i), static_cast<int>(i % 100) + 1,
+                           SUITS[i % 4], i % 13 >= 10, static_cast<int>(i % 10) + 1);
+}
+
+Card* makeGameCard(long long i) {
+    return new GameCard("Card " + to_string(i), static_cast<int>(i % 100) + 1,
+                        SUITS[i % 4], i % 13 >= 10, static_cast<int>(i % 10) + 1,
+                        i % 7 == 0, "First", static_cast<int>(i));
+}
+
+Card* makeSpecialCard(long long i) {
+    return new SpecialCard<string>("Card " + to_string(i), static_cast<int>(i % 100) + 1,
+                                   "Heal", static_cast<int>(i % 5) + 1, "Magic",
+                                   1.0 + static_cast<double>(i % 10) / 2.0);
+}
+
+Card* makeMixedCard(long long i) {
+    switch (i % 3) {
+        case 0: return makePlayingCard(i);
+        case 1: return makeGameCard(i);
+        default: return makeSpecialCard(i);
+    }
+}
+
+vector<Card*> makeCards(long long n, Card* (*factory)(long long)) {
+    vector<Card*> cards;
+    cards.reserve(n);
+    for (long long i = 0; i < n; i++) {
+        cards.push_back(factory(i));
+    }
+    return cards;
+}
+
+void deleteCards(vector<Card*>& cards) {
+    for (auto card : cards) {
+        delete card;
+    }
+    cards.clear();
+}
+
+// Moves every card out of a deck without deleting it
+void drainDeck(Deck& deck, vector<Card*>& into) {
+    while (!deck.isEmpty()) {
+        into.push_back(deck.drawCard());
+    }
+}
+
+// Deck benchmarks at one size
+void benchDeckOperations(BenchmarkSuite& suite, long long n, const string& tempDir) {
+    int size = static_cast<int>(n);
+    vector<Card*> pool = makeCards(n, makeMixedCard);
+
+    suite.measure("deck_addCard", n, [&]() {
+        Deck deck(size);
+        Stopwatch sw;
+        for (auto card : pool) {
+            deck.addCard(card);
+        }
+        double t = sw.elapsedSeconds();
+        pool.clear();
+        drainDeck(deck, pool);
+        return t;
+    });
+
+    suite.measure("deck_drawCard", n, [&]() {
+        Deck deck(size);
+        for (auto card : pool) {
+            deck.addCard(card);
+        }
+        pool.clear();
+        Stopwatch sw;
+        while (!deck.isEmpty()) {
+            pool.push_back(deck.drawCard());
+        }
+        return sw.elapsedSeconds();
+    });
+
+    Deck deck(size, "Bench Deck", "Bench");
+    for (auto card : pool) {
+        deck.addCard(card);
+    }
+    pool.clear();
+
+    suite.measure("deck_shuffle", n, [&]() {
+        Stopwatch sw;
+        deck.shuffle();
+        return sw.elapsedSeconds();
+    });
+
+    suite.measure("deck_displayAllCards", n, [&]() {
+        CoutSilencer silence;
+        Stopwatch sw;
+        deck.displayAllCards();
+        return sw.elapsedSeconds();
+    });
+
+    string path = tempDir + "/bench_deck.dat";
+    suite.measure("deck_saveToBinary", n, [&]() {
+        Stopwatch sw;
+        deck.saveToBinary(path);
+        return sw.elapsedSeconds();
+    });
+
+    if (suite.isSelected("deck_loadFromBinary")) {
+        deck.saveToBinary(path);
+    }
+    suite.measure("deck_loadFromBinary", n, [&]() {
+        Deck loaded;
+        Stopwatch sw;
+        loaded.loadFromBinary(path);
+        return sw.elapsedSeconds();
+    });
+    fs::remove(path);
+}
+
+// getValue benchmarks for each card type
+void benchGetValue(BenchmarkSuite& suite, long long n) {
+    struct CardKind {
+        string name;
+        Card* (*factory)(long long);
+    };
+    const CardKind kinds[] = {
+        {"getValue_PlayingCard", makePlayingCard},
+        {"getValue_GameCard", makeGameCard},
+        {"getValue_SpecialCard", makeSpecialCard},
+    };
+
+    for (const auto& kind : kinds) {
+        if (!suite.isSelected(kind.name)) {
+            continue;
+        }
+        vector<Card*> cards = makeCards(n, kind.factory);
+        suite.measure(kind.name, n, [&]() {
+            Stopwatch sw;
+            long long total = 0;
+            for (const auto card : cards) {
+                total += card->getValue();
+            }
+            benchSink = total;
+            return sw.elapsedSeconds();
+        });
+        deleteCards(cards);
+    }
+}
+
+void benchRulesSearch(BenchmarkSuite& suite) {
+    const vector<string> keywords = {"card", "deck", "value", "suit", "rarity", "foil", "effect", "zzz"};
+    const long long searches = 1000;
+    Rules rules;
+    suite.measure("rules_searchRules", searches, [&]() {
+        CoutSilencer silence;
+        Stopwatch sw;
+        for (long long i = 0; i < searches; i++) {
+            rules.searchRules(keywords[i % keywords.size()]);
+        }
+        return sw.elapsedSeconds();
+    });
+}
+
+void benchDirectoryScan(BenchmarkSuite& suite, long long fileCount, const string& tempDir) {
+    if (!suite.isSelected("filemanager_refreshFileList")) {
+        return;
+    }
+    string dir = tempDir + "/scan_" + to_string(fileCount) + "/";
+    fs::create_directories(dir);
+    for (long long i = 0; i < fileCount; i++) {
+        // One in ten files is not a deck file so the extension filter does real work
+        string ext = (i % 10 == 9) ? ".txt" : ".dat";
+        ofstream(dir + "deck_" + to_string(i) + ext).put('\0');
+    }
+
+    {
+        CoutSilencer silence;
+        FileManager manager(dir);
+        suite.measure("filemanager_refreshFileList", fileCount, [&]() {
+            Stopwatch sw;
+            manager.refreshFileList();
+            return sw.elapsedSeconds();
+        });
+    }
+    fs::remove_all(dir);
+}
+
+// Thread counts used by the concurrency benchmarks
+vector<int> benchThreadCounts() {
+    int limit = max(4, static_cast<int>(thread::hardware_concurrency()));
+    vector<int> counts;
+    for (int t = 1; t <= limit && t <= 16; t *= 2) {
+        counts.push_back(t);
+    }
+    return counts;
+}
+
+// Fails the run if the drawn cards are not exactly the expected set
+void verifyDrawnOnce(vector<Card*> drawn, vector<Card*> expected, const string& benchName) {
+    sort(drawn.begin(), drawn.end());
+    sort(expected.begin(), expected.end());
+    if (adjacent_find(drawn.begin(), drawn.end()) != drawn.end()) {
+        throw runtime_error(benchName + ": a card was drawn twice");
+    }
+    if (drawn != expected) {
+        throw runtime_error(benchName + ": drawn cards do not match the cards added");
+    }
+}
+
+// Concurrent draw throughput and add/draw stress checks
+void benchConcurrentDeck(BenchmarkSuite& suite, long long n) {
+    int size = static_cast<int>(n);
+    vector<Card*> pool = makeCards(n, makePlayingCard);
+
+    for (int threads : benchThreadCounts()) {
+        string drawName = "concurrent_drawCard_t" + to_string(threads);
+        suite.measure(drawName, n, [&]() {
+            ConcurrentDeck deck(size);
+            for (auto card : pool) {
+                deck.addCard(card);
+            }
+            vector<vector<Card*>> drawn(threads);
+            Stopwatch sw;
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&deck, &drawn, t]() {
+                    while (Card* card = deck.tryDrawCard()) {
+                        drawn[t].push_back(card);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            double elapsed = sw.elapsedSeconds();
+
+            vector<Card*> all;
+            for (auto& part : drawn) {
+                all.insert(all.end(), part.begin(), part.end());
+            }
+            verifyDrawnOnce(all, pool, drawName);
+            return elapsed;
+        });
+
+        // Same workload through one big mutex, as the server does with Deck today
+        string mutexName = "mutex_deck_drawCard_t" + to_string(threads);
+        suite.measure(mutexName, n, [&]() {
+            Deck deck(size);
+            for (auto card : pool) {
+                deck.addCard(card);
+            }
+            mutex deckLock;
+            vector<vector<Card*>> drawn(threads);
+            Stopwatch sw;
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&deck, &deckLock, &drawn, t]() {
+                    while (true) {
+                        lock_guard<mutex> guard(deckLock);
+                        if (deck.isEmpty()) break;
+                        drawn[t].push_back(deck.drawCard());
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            return sw.elapsedSeconds();
+        });
+
+        // Every thread adds its own share of cards and draws concurrently
+        string mixedName = "concurrent_mixed_t" + to_string(threads);
+        suite.measure(mixedName, n, [&]() {
+            ConcurrentDeck deck(size);
+            vector<vector<Card*>> drawn(threads);
+            Stopwatch sw;
+            vector<thread> workers;
+            for (int t = 0; t < threads; t++) {
+                workers.emplace_back([&, t]() {
+                    for (long long i = t; i < n; i += threads) {
+                        deck.addCard(pool[i]);
+                        if (i % 3 == 0) {
+                            if (Card* card = deck.tryDrawCard()) {
+                                drawn[t].push_back(card);
+                            }
+                        }
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            double elapsed = sw.elapsedSeconds();
+
+            vector<Card*> all;
+            for (auto& part : drawn) {
+                all.insert(all.end(), part.begin(), part.end());
+            }
+            if (static_cast<long long>(all.size()) + deck.getCurrentSize() != n) {
+                throw runtime_error(mixedName + ": deck size disagrees with cards drawn");
+            }
+            while (Card* card = deck.tryDrawCard()) {
+                all.push_back(card);
+            }
+            verifyDrawnOnce(all, pool, mixedName);
+            return elapsed;
+        });
+    }
+    deleteCards(pool);
+}
+
+// Headless high-card games through the work-stealing scheduler
+void benchGameSimulation(BenchmarkSuite& suite) {
+    const long long games = 100000;
+    vector<Card*> cards = makeCards(52, makePlayingCard);
+    GameSimulator simulator(cards);
+    for (int threads : benchThreadCounts()) {
+        suite.measure("simulate_games_t" + to_string(threads), games, [&]() {
+            return simulator.run(games, 42, threads).seconds;
+        });
+    }
+    deleteCards(cards);
+}
+
+// Monte Carlo draw odds: P(at least one Hearts card in 5 draws) over a 52-card deck
+void benchMonteCarlo(BenchmarkSuite& suite) {
+    const long long trials = 1 << 20;
+    vector<Card*> cards = makeCards(52, makePlayingCard);
+    vector<CardTraits> traits;
+    for (auto card : cards) {
+        traits.push_back(CardTraits::fromCard(*card));
+    }
+    for (int threads : benchThreadCounts()) {
+        MonteCarloEstimator estimator(traits, threads);
+        estimator.setMaxTrials(trials);
+        suite.measure("montecarlo_trials_t" + to_string(threads), trials, [&]() {
+            // A precision of 1e-9 is never reached, so every run does all trials
+            return estimator.estimate(CardFilters::suit("Hearts"), 5, 1, 1e-9, 7).seconds;
+        });
+    }
+    deleteCards(cards);
+}
+
+// Exact odds query rate on a 10k-card deck, cross-checked against Monte Carlo
+void benchHypergeometric(BenchmarkSuite& suite) {
+    const int deckSize = 10000;
+    vector<Card*> cards = makeCards(deckSize, makeGameCard);
+    vector<CardTraits> traits;
+    for (auto card : cards) {
+        traits.push_back(CardTraits::fromCard(*card));
+    }
+    deleteCards(cards);
+
+    // Distinct (matching, draws, minCount) questions, so the cache is not hit
+    const long long queries = 20000;
+    suite.measure("hypergeometric_query", queries, [&]() {
+        HypergeometricOdds odds(traits);
+        Stopwatch sw;
+        double total = 0.0;
+        for (long long i = 0; i < queries; i++) {
+            total += odds.probabilityAtLeast(static_cast<int>(500 + i % 5000),
+                                             static_cast<int>(5 + i % 60), static_cast<int>(1 + i % 4));
+        }
+        benchSink = static_cast<long long>(total);
+        return sw.elapsedSeconds();
+    });
+
+    suite.measure("hypergeometric_cached_query", queries, [&]() {
+        HypergeometricOdds odds(traits);
+        odds.probabilityAtLeast(CardFilters::suit("Spades"), 20, 3);
+        Stopwatch sw;
+        double total = 0.0;
+        for (long long i = 0; i < queries; i++) {
+            total += odds.probabilityAtLeast(2500, 20, 3);
+        }
+        benchSink = static_cast<long long>(total);
+        return sw.elapsedSeconds();
+    });
+
+    vector<DrawRequirement> joint = {
+        {CardFilters::suit("Hearts"), 2},
+        {CardFilters::minRarity(8), 1},
+        {CardFilters::foiled(), 1},
+    };
+    suite.measure("hypergeometric_joint_query", 100, [&]() {
+        Stopwatch sw;
+        for (int i = 0; i < 100; i++) {
+            HypergeometricOdds odds(traits);
+            benchSink = static_cast<long long>(odds.jointProbability(joint, 10 + i % 20) * 1e6);
+        }
+        return sw.elapsedSeconds();
+    });
+
+    // Exact answers must fall inside a generous Monte Carlo confidence interval
+    if (!suite.isSelected("hypergeometric")) {
+        return;
+    }
+    HypergeometricOdds odds(traits);
+    MonteCarloEstimator estimator(traits);
+    estimator.setConfidenceZ(4.0);
+    struct Check {
+        string name;
+        vector<DrawRequirement> requirements;
+        int draws;
+    };
+    const Check checks[] = {
+        {"Spades>=3 in 20", {{CardFilters::suit("Spades"), 3}}, 20},
+        {"face>=1 in 5", {{CardFilters::faceCard(), 1}}, 5},
+        {"Hearts>=2, rarity>=8, foiled", joint, 15},
+        {"Hearts>=1, Clubs>=1", {{CardFilters::suit("Hearts"), 1}, {CardFilters::suit("Clubs"), 1}}, 4},
+    };
+    for (const auto& check : checks) {
+        double exact = odds.jointProbability(check.requirements, check.draws);
+        ProbabilityEstimate estimate = estimator.estimate(check.requirements, check.draws, 0.002, 11);
+        if (exact < estimate.lower || exact > estimate.upper) {
+            throw runtime_error("Exact odds for '" + check.name + "' (" + to_string(exact) +
+                                ") disagree with Monte Carlo (" + to_string(estimate.probability) + ")");
+        }
+    }
+    cerr << "hypergeometric cross-check against Monte Carlo passed" << endl;
+}
+
+// Copy-on-write deck: per-operation cost should stay flat as the deck grows
+void benchVersionedDeck(BenchmarkSuite& suite, long long n) {
+    int size = static_cast<int>(n);
+    vector<shared_ptr<Card>> pool;
+    pool.reserve(n);
+    for (long long i = 0; i < n; i++) {
+        pool.emplace_back(makeMixedCard(i));
+    }
+
+    suite.measure("versioned_addCard", n, [&]() {
+        VersionedDeck deck(size);
+        Stopwatch sw;
+        for (const auto& card : pool) {
+            deck.addCard(card);
+        }
+        return sw.elapsedSeconds();
+    });
+
+    // Each draw happens while the previous version is still held
+    suite.measure("versioned_snapshot_draw", n, [&]() {
+        VersionedDeck deck(size);
+        deck.setHistoryLimit(0);
+        for (const auto& card : pool) {
+            deck.addCard(card);
+        }
+        Stopwatch sw;
+        while (!deck.isEmpty()) {
+            DeckSnapshot held = deck.snapshot();
+            benchSink = benchSink + deck.drawCard()->getValue() + held.getCurrentSize();
+        }
+        return sw.elapsedSeconds();
+    });
+
+    const int steps = 1000;
+    VersionedDeck deck(size);
+    deck.setHistoryLimit(steps);
+    for (const auto& card : pool) {
+        deck.addCard(card);
+    }
+    deck.clearHistory();
+    int drawn = static_cast<int>(min<long long>(steps, n));
+    // Undo and redo every draw; the deck size is in the name since the work is fixed
+    suite.measure("versioned_undo_redo_d" + to_string(n), 2 * drawn, [&]() {
+        for (int i = 0; i < drawn; i++) {
+            deck.drawCard();
+        }
+        Stopwatch sw;
+        while (deck.undo()) {}
+        while (deck.redo()) {}
+        double elapsed = sw.elapsedSeconds();
+        while (deck.undo()) {}
+        deck.clearHistory();
+        return elapsed;
+    });
+
+    // Snapshots must keep their contents while the live deck changes, even when
+    // another thread reads them at the same time
+    if (!suite.isSelected("versioned")) {
+        return;
+    }
+    DeckSnapshot before = deck.snapshot();
+    long long expected = 0;
+    for (const auto& card : pool) {
+        expected += card->getValue();
+    }
+    long long readerSum = 0;
+    thread reader([&]() {
+        for (int i = 0; i < before.getCurrentSize(); i++) {
+            readerSum += before.getCard(i).getValue();
+        }
+    });
+    deck.shuffle();
+    while (deck.getCurrentSize() > size / 2) {
+        deck.drawCard();
+    }
+    reader.join();
+    if (readerSum != expected) {
+        throw runtime_error("versioned deck: snapshot changed while the live deck was mutated");
+    }
+    for (int i = 0; i < before.getCurrentSize(); i++) {
+        if (&before.getCard(i) != pool[i].get()) {
+            throw runtime_error("versioned deck: snapshot order changed");
+        }
+    }
+    deck.restore(before);
+    deck.undo();
+    deck.undo();
+    if (deck.getCurrentSize() != size / 2 + 1) {
+        throw runtime_error("versioned deck: undo did not restore the previous version");
+    }
+}
+
+// Foreground cost of autosave while the writer thread saves continuously
+void benchAutosave(BenchmarkSuite& suite, long long n, const string& tempDir) {
+    if (!suite.isSelected("autosave")) {
+        return;
+    }
+    int size = static_cast<int>(n);
+    VersionedDeck deck(size, "Autosave Bench", "Bench");
+    deck.setHistoryLimit(0);
+    for (long long i = 0; i < n; i++) {
+        deck.addCard(makeMixedCard(i));
+    }
+
+    string path = tempDir + "/autosave.dat";
+    const long long changes = min<long long>(10000, n - 1);
+    double slowest = 0.0;
+    suite.measure("autosave_notify", changes, [&]() {
+        // Threshold 1 keeps the writer busy, the worst case for contention
+        AutosaveService autosave(path, chrono::milliseconds(1), 1);
+        vector<shared_ptr<Card>> drawn;
+        double total = 0.0;
+        for (long long i = 0; i < changes; i++) {
+            drawn.push_back(deck.drawCard());
+            DeckSnapshot snapshot = deck.snapshot();
+            Stopwatch sw;
+            autosave.notifyChanged(snapshot);
+            double elapsed = sw.elapsedSeconds();
+            total += elapsed;
+            slowest = max(slowest, elapsed);
+        }
+        if (!autosave.flush()) {
+            throw runtime_error("autosave failed: " + autosave.getLastError());
+        }
+
+        // The file on disk must hold the final state once flush() returns
+        Deck loaded;
+        loaded.loadFromBinary(path);
+        int top = deck.getCurrentSize() - 1;
+        if (loaded.getCurrentSize() != deck.getCurrentSize() ||
+            loaded.getCard(top)->getName() != deck.getCard(top).getName()) {
+            throw runtime_error("autosave: saved deck does not match the live deck");
+        }
+        while (!drawn.empty()) {
+            deck.addCard(drawn.back());
+            drawn.pop_back();
+        }
+        return total;
+    });
+    cerr << "autosave: slowest notify " << slowest * 1e6 << " us" << endl;
+    fs::remove(path);
+}
+
+// Loading a whole save directory: one file at a time, thread pool, io_uring
+void benchCollectionLoad(BenchmarkSuite& suite, long long fileCount, const string& tempDir) {
+    if (!suite.isSelected("collection_load")) {
+        return;
+    }
+    string dir = tempDir + "/collection_" + to_string(fileCount) + "/";
+    fs::create_directories(dir);
+    vector<string> files;
+    {
+        Deck deck(52, "Collection Deck", "Bench");
+        for (long long i = 0; i < 52; i++) {
+            deck.addCard(makePlayingCard(i));
+        }
+        for (long long i = 0; i < fileCount; i++) {
+            files.push_back(dir + "deck_" + to_string(i) + ".dat");
+            deck.saveToBinary(files.back());
+        }
+    }
+    // A truncated file must be reported without stopping the rest
+    files.push_back(dir + "broken.dat");
+    ofstream(files.back(), ios::binary).write("\x05\0\0\0abc", 7);
+
+    auto check = [&](const DeckLoadResult& result, const string& name) {
+        if (static_cast<long long>(result.decks.size()) != fileCount || result.failures.size() != 1 ||
+            result.failures[0].file != files.back()) {
+            throw runtime_error(name + ": wrong number of decks loaded");
+        }
+        for (size_t i = 0; i < result.decks.size(); i++) {
+            if (result.files[i] != files[i] || result.decks[i]->getCurrentSize() != 52 ||
+                result.decks[i]->getCard(51)->getName() != "Card 51") {
+                throw runtime_error(name + ": deck " + to_string(i) + " loaded incorrectly");
+            }
+        }
+    };
+
+    suite.measure("collection_load_serial", fileCount, [&]() {
+        vector<unique_ptr<Deck>> decks;
+        Stopwatch sw;
+        for (long long i = 0; i < fileCount; i++) {
+            decks.emplace_back(new Deck());
+            decks.back()->loadFromBinary(files[i]);
+        }
+        return sw.elapsedSeconds();
+    });
+
+    DeckCollectionLoader threaded;
+    threaded.setUseIoUring(false);
+    suite.measure("collection_load_threads", fileCount, [&]() {
+        DeckLoadResult result = threaded.loadFiles(files);
+        check(result, "collection_load_threads");
+        return result.seconds;
+    });
+
+    if (DeckCollectionLoader::ioUringAvailable()) {
+        DeckCollectionLoader uring;
+        suite.measure("collection_load_uring", fileCount, [&]() {
+            DeckLoadResult result = uring.loadFiles(files);
+            if (!result.usedIoUring) {
+                throw runtime_error("collection_load_uring: fell back to the thread pool");
+            }
+            check(result, "collection_load_uring");
+            return result.seconds;
+        });
+    } else {
+        cerr << "io_uring unavailable; collection_load_uring skipped" << endl;
+    }
+    fs::remove_all(dir);
+}
+
+// Bytes currently allocated from the heap, or 0 where that cannot be measured
+size_t heapBytesInUse() {
+#ifdef __GLIBC__
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+// A multi-deck collection built from 5000 distinct cards, held as full Card
+// objects and as CompactDecks over one CardCatalog
+void benchFlyweight(BenchmarkSuite& suite, long long n) {
+    if (!suite.isSelected("flyweight")) {
+        return;
+    }
+    const long long distinct = 5000;
+    const int deckSize = 60;
+    auto makeCopy = [](long long i) {
+        long long kind = i % distinct;
+        Card* card = makeMixedCard(kind);
+        if (PlayingCard* playing = dynamic_cast<PlayingCard*>(card)) {
+            playing->setCondition(static_cast<int>(i % 10) + 1);
+            if (GameCard* game = dynamic_cast<GameCard*>(card)) {
+                game->setSerialNumber(static_cast<int>(i % 1000000));
+                game->setFoiled(i % 11 == 0);
+            }
+        }
+        return card;
+    };
+
+    size_t heapBefore = heapBytesInUse();
+    vector<Deck*> decks;
+    for (long long i = 0; i < n; i++) {
+        if (i % deckSize == 0) {
+            decks.push_back(new Deck(deckSize));
+        }
+        decks.back()->addCard(makeCopy(i));
+    }
+    size_t fullBytes = heapBytesInUse() - heapBefore;
+
+    CardCatalog catalog;
+    vector<CompactDeck> compact;
+    suite.measure("flyweight_intern", n, [&]() {
+        catalog = CardCatalog();
+        compact.clear();
+        Stopwatch sw;
+        for (auto deck : decks) {
+            compact.emplace_back(catalog, deckSize);
+            compact.back().addAll(*deck);
+        }
+        return sw.elapsedSeconds();
+    });
+
+    suite.measure("flyweight_getValue", n, [&]() {
+        long long total = 0;
+        Stopwatch sw;
+        for (const auto& deck : compact) {
+            for (int i = 0; i < deck.getCurrentSize(); i++) {
+                total += deck.getCardValue(i);
+            }
+        }
+        benchSink = total;
+        return sw.elapsedSeconds();
+    });
+
+    // Values and materialized cards must match the originals exactly
+    for (size_t d = 0; d < decks.size(); d += 97) {
+        for (int i = 0; i < decks[d]->getCurrentSize(); i++) {
+            const Card& original = *decks[d]->getCard(i);
+            unique_ptr<Card> rebuilt(catalog.materialize(compact[d].getCard(i)));
+            if (compact[d].getCardValue(i) != original.getValue() ||
+                rebuilt->getValue() != original.getValue() || rebuilt->getName() != original.getName()) {
+                throw runtime_error("flyweight: card " + original.getName() + " does not round-trip");
+            }
+        }
+    }
+    if (catalog.size() != static_cast<size_t>(min(n, distinct))) {
+        throw runtime_error("flyweight: identical cards were not shared");
+    }
+
+    size_t compactBytes = catalog.memoryUsage();
+    for (const auto& deck : compact) {
+        compactBytes += deck.memoryUsage();
+    }
+    for (auto deck : decks) {
+        delete deck;
+    }
+    if (fullBytes > 0) {
+        cerr << "flyweight: " << n << " cards take " << fullBytes / 1024 << " KB as objects, "
+             << compactBytes / 1024 << " KB compact (" << fullBytes / max<size_t>(compactBytes, 1)
+             << "x smaller)" << endl;
+    }
+}
+
+// Effect type with its own codec, registered to check custom SpecialCard types
+struct ComboEffect {
+    vector<string> steps;
+};
+
+ostream& operator<<(ostream& os, const ComboEffect& effect) {
+    for (size_t i = 0; i < effect.steps.size(); i++) {
+        os << (i ? " -> " : "") << effect.steps[i];
+    }
+    return os;
+}
+
+template<>
+struct SerializationTraits<ComboEffect> {
+    static void write(ByteWriter& out, const ComboEffect& effect) {
+        out.write<int32_t>(static_cast<int32_t>(effect.steps.size()));
+        for (const auto& step : effect.steps) {
+            out.write(step);
+        }
+    }
+
+    static ComboEffect read(ByteReader& in) {
+        ComboEffect effect;
+        int32_t count = in.read<int32_t>();
+        if (count < 0) {
+            throw runtime_error("Invalid combo length");
+        }
+        for (int32_t i = 0; i < count; i++) {
+            effect.steps.push_back(in.read<string>());
+        }
+        return effect;
+    }
+};
+
+// Typed save/load of plain and special-card decks, plus round-trip checks
+void benchSerialization(BenchmarkSuite& suite, long long n, const string& tempDir) {
+    if (!suite.isSelected("serialize")) {
+        return;
+    }
+    int size = static_cast<int>(n);
+    string path = tempDir + "/serialize.dat";
+    struct Kind {
+        string name;
+        Card* (*factory)(long long);
+    };
+    const Kind kinds[] = {{"playing", makePlayingCard}, {"special", makeSpecialCard}};
+    for (const auto& kind : kinds) {
+        Deck deck(size);
+        for (long long i = 0; i < n; i++) {
+            deck.addCard(kind.factory(i));
+        }
+        suite.measure("serialize_" + kind.name + "_save", n, [&]() {
+            Stopwatch sw;
+            deck.saveToBinary(path);
+            return sw.elapsedSeconds();
+        });
+        suite.measure("serialize_" + kind.name + "_load", n, [&]() {
+            Deck loaded;
+            Stopwatch sw;
+            loaded.loadFromBinary(path);
+            return sw.elapsedSeconds();
+        });
+    }
+
+    // Every registered type must come back as itself with the same value
+    static bool comboRegistered = false;
+    if (!comboRegistered) {
+        CardTypeRegistry::instance().registerType<SpecialCard<ComboEffect>>(100, "SpecialCard<ComboEffect>");
+        comboRegistered = true;
+    }
+    Deck mixed(6, "Mixed", "Bench");
+    mixed.addCard(makePlayingCard(1));
+    mixed.addCard(makeGameCard(2));
+    mixed.addCard(makeSpecialCard(3));
+    mixed.addCard(new SpecialCard<int>("Counter", 4, 3, 2, "Trap", 1.5));
+    mixed.addCard(new SpecialCard<double>("Boost", 5, 2.5, 3, "Buff", 2.0));
+    mixed.addCard(new SpecialCard<ComboEffect>("Combo", 6, ComboEffect{{"Draw", "Discard"}}, 2, "Chain", 3.0));
+    mixed.saveToBinary(path);
+    Deck loaded;
+    loaded.loadFromBinary(path);
+    for (int i = 0; i < mixed.getCurrentSize(); i++) {
+        const Card& before = *mixed.getCard(i);
+        const Card& after = *loaded.getCard(i);
+        if (typeid(before) != typeid(after) || before.getValue() != after.getValue() ||
+            before.getName() != after.getName()) {
+            throw runtime_error("serialize: " + before.getName() + " did not round-trip");
+        }
+    }
+    const auto* combo = dynamic_cast<const SpecialCard<ComboEffect>*>(loaded.getCard(5));
+    if (combo->getSpecialEffect().steps.size() != 2 || combo->getSpecialEffect().steps[1] != "Discard") {
+        throw runtime_error("serialize: custom effect did not round-trip");
+    }
+
+    // Files from before typed cards still load as name/value playing cards
+    {
+        ofstream legacy(path, ios::binary);
+        auto writeInt = [&](int value) { legacy.write(reinterpret_cast<char*>(&value), sizeof(value)); };
+        writeInt(3); legacy.write("Old", 3);
+        writeInt(2); legacy.write("Me", 2);
+        writeInt(52);
+        writeInt(1);
+        writeInt(4); legacy.write("King", 4);
+        writeInt(13);
+    }
+    loaded.loadFromBinary(path);
+    if (loaded.getDeckName() != "Old" || loaded.getCurrentSize() != 1 ||
+        loaded.getCard(0)->getName() != "King" || loaded.getCard(0)->getValue() != 13) {
+        throw runtime_error("serialize: legacy deck file did not load");
+    }
+    fs::remove(path);
+}
+
+// Per-turn effect ticks over decks of special cards, plus a check against a
+// card-by-card model of the same rule
+void benchEffectTick(BenchmarkSuite& suite, long long n) {
+    string name = "effect_tick_d" + to_string(n);
+    if (!suite.isSelected(name)) {
+        return;
+    }
+    auto makeTickCard = [](long long i) -> Card* {
+        int value = static_cast<int>(i % 100) + 1;
+        int durability = static_cast<int>(i % 50) + 1;
+        double power = 0.5 + static_cast<double>(i % 20) / 4.0;
+        switch (i % 4) {
+            case 0: return new SpecialCard<string>("Card " + to_string(i), value, "Heal", durability, "Magic", power);
+            case 1: return new SpecialCard<int>("Card " + to_string(i), value, 3, durability, "Trap", power);
+            case 2: return new SpecialCard<double>("Card " + to_string(i), value, 0.5, durability, "Aura", power);
+            default: return makePlayingCard(i);
+        }
+    };
+
+    Deck deck(static_cast<int>(n));
+    for (long long i = 0; i < n; i++) {
+        deck.addCard(makeTickCard(i));
+    }
+    EffectTickRule rule;
+    rule.durabilityLoss = 1;
+    rule.powerScale = 1.05;
+    EffectTicker ticker(rule);
+    suite.measure(name, n, [&]() {
+        return ticker.tick(deck).seconds;
+    });
+
+    // Tick a small deck past every card's lifetime and compare each turn
+    // with the rule applied card by card
+    struct Expected {
+        string name;
+        int durability;
+        double power;
+        int value;
+        bool special;
+    };
+    Deck small(1000);
+    vector<Expected> model;
+    for (long long i = 0; i < 1000; i++) {
+        Card* card = makeTickCard(i);
+        small.addCard(card);
+        SpecialCardBase* special = dynamic_cast<SpecialCardBase*>(card);
+        model.push_back({card->getName(), special ? special->getDurability() : 0,
+                         special ? special->getPowerLevel() : 0.0, card->getValue(), special != nullptr});
+    }
+    for (int turn = 0; turn < 55; turn++) {
+        EffectTickReport report = ticker.tick(small);
+        vector<Expected> survivors;
+        int expired = 0;
+        for (auto expected : model) {
+            if (expected.special) {
+                expected.durability -= rule.durabilityLoss;
+                expected.power = min(10.0, max(0.1, expected.power * rule.powerScale));
+                if (expected.durability < 1) {
+                    expired++;
+                    continue;
+                }
+            }
+            survivors.push_back(expected);
+        }
+        model = survivors;
+        if (report.expired != expired || small.getCurrentSize() != static_cast<int>(model.size())) {
+            throw runtime_error("effect_tick: turn " + to_string(turn) + " expired the wrong cards");
+        }
+        for (int i = 0; i < small.getCurrentSize(); i++) {
+            const Card* card = small.getCard(i);
+            const Expected& expected = model[i];
+            int value = expected.special
+                ? static_cast<int>(card->getBaseValue() * expected.durability * expected.power)
+                : expected.value;
+            if (card->getName() != expected.name || card->getValue() != value) {
+                throw runtime_error("effect_tick: " + card->getName() + " has the wrong value after turn " +
+                                    to_string(turn));
+            }
+        }
+    }
+    if (small.getCurrentSize() != 250) {
+        throw runtime_error("effect_tick: only playing cards should outlive every effect");
+    }
+}
+
+// Multi-key radix sorts against a comparator sort over the same keys
+void benchSort(BenchmarkSuite& suite, long long n) {
+    if (!suite.isSelected("sort")) {
+        return;
+    }
+    Deck deck(static_cast<int>(n));
+    for (long long i = 0; i < n; i++) {
+        // Scramble values so the input is not already grouped
+        deck.addCard(makeMixedCard((i * 2654435761LL) % max<long long>(n, 1)));
+    }
+
+    // Comparator sort over the same keys, the reference for every radix result
+    auto suitOf = [](const Card* card) {
+        const PlayingCard* playing = dynamic_cast<const PlayingCard*>(card);
+        return playing ? CardTraits::suitIndex(playing->getSuit()) : 4;
+    };
+    auto comparatorOrder = [&](const vector<Card*>& cards) {
+        vector<Card*> sorted = cards;
+        stable_sort(sorted.begin(), sorted.end(), [&](const Card* a, const Card* b) {
+            if (a->getValue() != b->getValue()) return a->getValue() < b->getValue();
+            return suitOf(a) < suitOf(b);
+        });
+        return sorted;
+    };
+    auto deckCards = [&]() {
+        vector<Card*> cards;
+        for (int i = 0; i < deck.getCurrentSize(); i++) {
+            cards.push_back(deck.getCard(i));
+        }
+        return cards;
+    };
+
+    const vector<DeckSortKey> valueSuit = {SORT_BY_VALUE, SORT_BY_SUIT};
+    suite.measure("sort_value_suit", n, [&]() {
+        deck.shuffle();
+        Stopwatch sw;
+        deck.sortBy(valueSuit);
+        return sw.elapsedSeconds();
+    });
+    if (n <= 1000000 && deckCards() != comparatorOrder(deckCards())) {
+        throw runtime_error("sort: radix order differs from the comparator sort");
+    }
+
+    if (n <= 1000000) {
+        suite.measure("sort_comparator_value_suit", n, [&]() {
+            deck.shuffle();
+            vector<Card*> cards = deckCards();
+            Stopwatch sw;
+            benchSink = comparatorOrder(cards).size();
+            return sw.elapsedSeconds();
+        });
+    }
+
+    suite.measure("sort_rarity_condition_value", n, [&]() {
+        deck.shuffle();
+        Stopwatch sw;
+        deck.sortBy({SORT_BY_RARITY, SORT_BY_CONDITION, SORT_BY_VALUE});
+        return sw.elapsedSeconds();
+    });
+
+    suite.measure("sort_name", n, [&]() {
+        deck.shuffle();
+        Stopwatch sw;
+        deck.sortBy({SORT_BY_NAME});
+        return sw.elapsedSeconds();
+    });
+    for (int i = 1; i < deck.getCurrentSize(); i++) {
+        if (deck.getCard(i - 1)->getName() > deck.getCard(i)->getName()) {
+            throw runtime_error("sort: names are out of order");
+        }
+    }
+
+    // Stability and thread-count independence: sorting by suit alone must keep
+    // the previous name order within each suit, whatever the thread count
+    if (n <= 1000000) {
+        vector<Card*> byName = deckCards();
+        vector<uint32_t> serial = DeckSorter::sortedOrder(byName, {SORT_BY_SUIT}, 1);
+        vector<uint32_t> parallel = DeckSorter::sortedOrder(byName, {SORT_BY_SUIT}, 4);
+        if (serial != parallel) {
+            throw runtime_error("sort: result depends on the thread count");
+        }
+        for (size_t i = 1; i < serial.size(); i++) {
+            if (suitOf(byName[serial[i - 1]]) == suitOf(byName[serial[i]]) && serial[i - 1] > serial[i]) {
+                throw runtime_error("sort: equal keys changed order");
+            }
+        }
+    }
+}
+
+// Deck totals served from the generation-checked cache, against a full
+// recomputation after one card changes
+void benchValueCache(BenchmarkSuite& suite, long long n) {
+    string cachedName = "value_total_cached_d" + to_string(n);
+    string changedName = "value_total_after_change";
+    if (!suite.isSelected(cachedName) && !suite.isSelected(changedName)) {
+        return;
+    }
+    Deck deck(static_cast<int>(n));
+    for (long long i = 0; i < n; i++) {
+        deck.addCard(makeMixedCard(i));
+    }
+    auto recount = [&]() {
+        long long total = 0;
+        for (int i = 0; i < deck.getCurrentSize(); i++) {
+            total += deck.getCard(i)->getValue();
+        }
+        return total;
+    };
+    PlayingCard* playing = dynamic_cast<PlayingCard*>(deck.getCard(0));
+    deck.getTotalValue();
+
+    const long long calls = 100000;
+    suite.measure(cachedName, calls, [&]() {
+        long long total = 0;
+        Stopwatch sw;
+        for (long long i = 0; i < calls; i++) {
+            total += deck.getTotalValue();
+        }
+        benchSink = total;
+        return sw.elapsedSeconds();
+    });
+
+    int condition = 1;
+    suite.measure(changedName, n, [&]() {
+        playing->setCondition(condition % 10 + 1);
+        condition++;
+        Stopwatch sw;
+        benchSink = deck.getTotalValue();
+        return sw.elapsedSeconds();
+    });
+
+    // Every setter a value depends on, and every deck change, must refresh the total
+    if (deck.getTotalValue() != recount()) {
+        throw runtime_error("value cache: total is stale after a condition change");
+    }
+    for (int i = 0; i < min(deck.getCurrentSize(), 30); i++) {
+        Card* card = deck.getCard(i);
+        deck.getTotalValue();
+        if (GameCard* game = dynamic_cast<GameCard*>(card)) {
+            game->setRarity(game->getRarity() % 10 + 1);
+            game->setFoiled(!game->isFoiled());
+        } else if (PlayingCard* plain = dynamic_cast<PlayingCard*>(card)) {
+            plain->setCondition(plain->getCondition() % 10 + 1);
+        } else if (SpecialCardBase* special = dynamic_cast<SpecialCardBase*>(card)) {
+            special->setDurability(special->getDurability() + 1);
+            special->setPowerLevel(min(10.0, special->getPowerLevel() + 0.5));
+        }
+        card->setValue(card->getBaseValue() + 1);
+        unique_ptr<Card> copy(card->clone());
+        if (copy->getValue() != card->getValue() || deck.getTotalValue() != recount()) {
+            throw runtime_error("value cache: " + card->getName() + " kept a stale value");
+        }
+    }
+    long long beforeDraw = deck.getTotalValue();
+    unique_ptr<Card> drawn(deck.drawCard());
+    if (deck.getTotalValue() != beforeDraw - drawn->getValue()) {
+        throw runtime_error("value cache: total ignored a draw");
+    }
+}
+
+void benchDeal(BenchmarkSuite& suite, long long players, int cardsEach) {
+    string viewName = "deal_bulk_p" + to_string(players);
+    string loopName = "deal_per_card_p" + to_string(players);
+    if (!suite.isSelected(viewName) && !suite.isSelected(loopName)) {
+        return;
+    }
+    long long n = players * cardsEach;
+    Deck shoe(static_cast<int>(n), "Shoe");
+    for (long long i = 0; i < n; i++) {
+        shoe.addCard(makeMixedCard(i));
+    }
+    vector<Card*> original(shoe.view().begin(), shoe.view().end());
+    vector<unique_ptr<Deck>> hands;
+    vector<Deck*> handPointers;
+    for (long long p = 0; p < players; p++) {
+        hands.emplace_back(new Deck(cardsEach, "Hand " + to_string(p)));
+        handPointers.push_back(hands.back().get());
+    }
+
+    // Hand p must hold the p-th block from the top, in the shoe's order
+    auto checkHands = [&](const string& name) {
+        for (long long p = 0; p < players; p++) {
+            DeckView hand = hands[p]->view();
+            Card* const* block = original.data() + (n - (p + 1) * cardsEach);
+            if (hand.size() != static_cast<size_t>(cardsEach) || !equal(hand.begin(), hand.end(), block)) {
+                throw runtime_error(name + ": hand " + to_string(p) + " got the wrong cards");
+            }
+        }
+        if (!shoe.isEmpty()) {
+            throw runtime_error(name + ": cards were left in the shoe");
+        }
+    };
+    // Putting the hands back in reverse restores the shoe exactly
+    auto collect = [&]() {
+        shoe.mergeFrom(vector<Deck*>(handPointers.rbegin(), handPointers.rend()));
+        if (!equal(original.begin(), original.end(), shoe.view().begin())) {
+            throw runtime_error("deal: merging the hands did not restore the shoe");
+        }
+    };
+
+    suite.measure(viewName, n, [&]() {
+        Stopwatch sw;
+        shoe.deal(handPointers, cardsEach);
+        double seconds = sw.elapsedSeconds();
+        checkHands(viewName);
+        collect();
+        return seconds;
+    });
+    suite.measure(loopName, n, [&]() {
+        Stopwatch sw;
+        for (auto hand : handPointers) {
+            Deck block(cardsEach);
+            for (int k = 0; k < cardsEach; k++) {
+                block.addCard(shoe.drawCard());
+            }
+            // Drawing reverses the block, so flip it back into the hand
+            while (!block.isEmpty()) {
+                hand->addCard(block.drawCard());
+            }
+        }
+        double seconds = sw.elapsedSeconds();
+        checkHands(loopName);
+        collect();
+        return seconds;
+    });
+
+    // Cut and split keep every card exactly once
+    shoe.cut(static_cast<int>(n / 3));
+    if (shoe.view().at(0) != original[n / 3] || shoe.view().top() != original[n / 3 - 1]) {
+        throw runtime_error("deal: cut moved the wrong cards");
+    }
+    shoe.cut(static_cast<int>(n - n / 3));
+    Deck half(static_cast<int>(n), "Half");
+    shoe.splitInto(half);
+    if (half.getCurrentSize() != n / 2 || half.view().top() != original.back()
+        || shoe.getCurrentSize() + half.getCurrentSize() != n) {
+        throw runtime_error("deal: split did not move the top half");
+    }
+    shoe.mergeFrom({&half});
+    if (!equal(original.begin(), original.end(), shoe.view().begin())) {
+        throw runtime_error("deal: split and merge did not restore the shoe");
+    }
+    bool rejected = false;
+    try {
+        shoe.deal({handPointers[0], handPointers[0]}, 1);
+    } catch (const runtime_error&) {
+        rejected = true;
+    }
+    if (!rejected || shoe.getCurrentSize() != n) {
+        throw runtime_error("deal: dealing to the same hand twice was not rejected cleanly");
+    }
+}
+
+void benchShoe(BenchmarkSuite& suite, long long n) {
+    string dealName = "shoe_deal_d" + to_string(n);
+    string bottomName = "shoe_draw_bottom_d" + to_string(n);
+    if (!suite.isSelected(dealName) && !suite.isSelected(bottomName)) {
+        return;
+    }
+    Shoe shoe(static_cast<int>(n), 0.75, 42);
+    vector<Card*> owned;
+    for (long long i = 0; i < n; i++) {
+        owned.push_back(makeMixedCard(i));
+        shoe.addCard(owned.back());
+    }
+    if (shoe.peek(0) != owned.back() || shoe.peekTop(2)[1] != owned[n - 2]) {
+        throw runtime_error("shoe: peek does not see the top cards");
+    }
+
+    // A table round: burn one, deal, discard the played cards, reshuffle at the cut card
+    const long long draws = max<long long>(n * 4, 100000);
+    long long reshuffles = 0;
+    suite.measure(dealName, draws, [&]() {
+        Stopwatch sw;
+        for (long long i = 0; i < draws; i++) {
+            if (i % 16 == 0) {
+                reshuffles += shoe.reshuffleIfNeeded();
+                shoe.burn(1);
+            }
+            shoe.discard(shoe.drawTop());
+        }
+        double seconds = sw.elapsedSeconds();
+        if (reshuffles == 0 || shoe.getCurrentSize() + shoe.getDiscardSize() != n
+            || shoe.getDealtFraction() > shoe.getPenetration() + 17.0 / n) {
+            throw runtime_error("shoe: penetration or card count is wrong after dealing");
+        }
+        return seconds;
+    });
+
+    // Draws from both ends must together return every card exactly once
+    shoe.reshuffle();
+    suite.measure(bottomName, n, [&]() {
+        vector<Card*> drawn;
+        drawn.reserve(n);
+        Stopwatch sw;
+        while (!shoe.isEmpty()) {
+            drawn.push_back(shoe.drawBottom());
+            if (!shoe.isEmpty()) {
+                drawn.push_back(shoe.drawTop());
+            }
+        }
+        double seconds = sw.elapsedSeconds();
+        vector<Card*> sortedDrawn(drawn), sortedOwned(owned);
+        sort(sortedDrawn.begin(), sortedDrawn.end());
+        sort(sortedOwned.begin(), sortedOwned.end());
+        if (sortedDrawn != sortedOwned) {
+            throw runtime_error("shoe: drawing from both ends lost or repeated a card");
+        }
+        for (auto card : drawn) {
+            shoe.addToBottom(card);
+        }
+        if (shoe.peek(0) != drawn.front() || shoe.peek(shoe.getCurrentSize() - 1) != drawn.back()) {
+            throw runtime_error("shoe: addToBottom did not stack cards underneath");
+        }
+        return seconds;
+    });
+}
+
+void benchWeightedDraw(BenchmarkSuite& suite, long long n) {
+    string randomName = "draw_random_d" + to_string(n);
+    string pickName = "booster_pick_d" + to_string(n);
+    string weightedName = "draw_weighted_d" + to_string(n);
+    if (!suite.isSelected(randomName) && !suite.isSelected(pickName) && !suite.isSelected(weightedName)) {
+        return;
+    }
+    mt19937_64 rng(7);
+    Deck pool(static_cast<int>(n), "Pool");
+    for (long long i = 0; i < n; i++) {
+        pool.addCard(makeGameCard(i));
+    }
+
+    // Picks must follow the rarity weights: count them per rarity and compare
+    BoosterGenerator generator(pool, WEIGHT_BY_RARITY, 11);
+    const long long picks = 1000000;
+    vector<double> expected(11, 0.0);
+    double total = 0.0;
+    for (long long i = 0; i < n; i++) {
+        double weight = AliasTable::weightOf(*pool.getCard(static_cast<int>(i)), WEIGHT_BY_RARITY);
+        expected[static_cast<GameCard*>(pool.getCard(static_cast<int>(i)))->getRarity()] += weight;
+        total += weight;
+    }
+    suite.measure(pickName, picks, [&]() {
+        vector<long long> perRarity(11, 0);
+        Stopwatch sw;
+        for (long long i = 0; i < picks; i++) {
+            perRarity[static_cast<GameCard*>(pool.getCard(generator.pickIndex()))->getRarity()]++;
+        }
+        double seconds = sw.elapsedSeconds();
+        for (int r = 1; r <= 10; r++) {
+            double mean = expected[r] / total * picks;
+            if (fabs(perRarity[r] - mean) > 6.0 * sqrt(mean) + 1.0) {
+                throw runtime_error("weighted draw: rarity " + to_string(r) + " picked " + to_string(perRarity[r])
+                                    + " times, expected about " + to_string(static_cast<long long>(mean)));
+            }
+        }
+        return seconds;
+    });
+
+    // Removing entries must renormalize over what is left, across rebuilds
+    AliasTable table(vector<double>{1, 2, 3, 4, 0, 6});
+    table.remove(5);
+    table.remove(3);
+    vector<long long> hits(6, 0);
+    for (int i = 0; i < 600000; i++) {
+        hits[table.sample(rng)]++;
+    }
+    for (int i = 0; i < 3; i++) {
+        double mean = 600000.0 * (i + 1) / 6.0;
+        if (fabs(hits[i] - mean) > 6.0 * sqrt(mean)) {
+            throw runtime_error("alias table: removed weight was not renormalized");
+        }
+    }
+    if (hits[3] + hits[4] + hits[5] != 0) {
+        throw runtime_error("alias table: sampled a removed or zero-weight entry");
+    }
+
+    vector<Card*> original(pool.view().begin(), pool.view().end());
+    sort(original.begin(), original.end());
+    auto checkConserved = [&](const string& name, vector<Card*>& drawn) {
+        vector<Card*> all(pool.view().begin(), pool.view().end());
+        all.insert(all.end(), drawn.begin(), drawn.end());
+        sort(all.begin(), all.end());
+        if (all != original) {
+            throw runtime_error(name + ": drawn and remaining cards do not add up to the deck");
+        }
+        for (auto card : drawn) {
+            pool.addCard(card);
+        }
+    };
+
+    long long randomDraws = max<long long>(1, n / 2);
+    suite.measure(randomName, randomDraws, [&]() {
+        vector<Card*> drawn;
+        drawn.reserve(randomDraws);
+        Stopwatch sw;
+        for (long long i = 0; i < randomDraws; i++) {
+            drawn.push_back(pool.drawRandom(rng));
+        }
+        double seconds = sw.elapsedSeconds();
+        checkConserved(randomName, drawn);
+        return seconds;
+    });
+
+    int packDraws = static_cast<int>(max<long long>(1, n / 10));
+    suite.measure(weightedName, packDraws, [&]() {
+        // Single-card draws reuse the table built by the first one
+        vector<Card*> drawn;
+        drawn.reserve(packDraws);
+        Stopwatch sw;
+        for (int i = 0; i < packDraws; i++) {
+            drawn.push_back(pool.drawWeighted(1, WEIGHT_BY_VALUE, rng)[0]);
+        }
+        double seconds = sw.elapsedSeconds();
+        checkConserved(weightedName, drawn);
+        return seconds;
+    });
+}
+
+void benchSessionReplay(BenchmarkSuite& suite, long long operations, const string& tempDir) {
+    string name = "session_replay_ops" + to_string(operations);
+    if (!suite.isSelected(name)) {
+        return;
+    }
+    // Record a synthetic session with the same mix of operations the game offers
+    string traceFile = tempDir + "/session.trace";
+    VersionedDeck live(200, "Replay", "Bench");
+    long long recorded = 0;
+    long long checkpoints = 1;
+    {
+        SessionRecorder recorder(traceFile, live);
+        mt19937_64 rng(99);
+        long long added = 0;
+        while (recorder.getOperationCount() < operations) {
+            int roll = static_cast<int>(rng() % 100);
+            if (roll < 40 && live.getCurrentSize() < 150) {
+                Card* card = makeMixedCard(added++);
+                live.addCard(card);
+                recorder.recordAddCard(*card);
+            } else if (roll < 50 && !live.isEmpty()) {
+                uint64_t seed = rng();
+                live.shuffle(seed);
+                recorder.recordShuffle(seed);
+            } else if (roll < 70 && !live.isEmpty()) {
+                shared_ptr<Card> drawn = live.drawCard();
+                recorder.recordDraw();
+                if (rng() % 2 == 0) {
+                    live.addCard(drawn);
+                    recorder.recordReturnDrawn();
+                }
+            } else if (roll < 80) {
+                if (live.undo()) recorder.recordUndo();
+            } else if (roll < 88) {
+                if (live.redo()) recorder.recordRedo();
+            } else if (roll < 98 && !live.isEmpty()) {
+                vector<DeckSortKey> keys = {static_cast<DeckSortKey>(rng() % 5), static_cast<DeckSortKey>(rng() % 5)};
+                live.sortBy(keys);
+                recorder.recordSort(keys);
+            } else {
+                Deck loaded(200, "Loaded " + to_string(added), "Bench");
+                for (int i = 0; i < 20; i++) {
+                    loaded.addCard(makeMixedCard(added++));
+                }
+                live.adoptDeck(loaded);
+                recorder.recordLoad(live);
+            }
+            recorder.checkpoint(live);
+            checkpoints++;
+        }
+        recorded = recorder.getOperationCount();
+    }
+
+    SessionReplayer replayer(traceFile);
+    uint64_t expectedHash = SessionRecorder::stateHash(live.snapshot());
+    suite.measure(name, operations, [&]() {
+        ReplayReport report = replayer.replay(true);
+        if (report.finalHash != expectedHash || report.finalSize != live.getCurrentSize()
+            || report.operations != recorded || report.checkpoints != checkpoints) {
+            throw runtime_error("session replay: replay did not reproduce the recorded deck");
+        }
+        return report.seconds;
+    });
+
+    // A trace whose last checkpoint disagrees must be reported, not replayed silently
+    ifstream in(traceFile, ios::binary);
+    vector<char> bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    bytes.back() ^= 1;
+    bool diverged = false;
+    try {
+        SessionReplayer(bytes).replay(true);
+    } catch (const runtime_error&) {
+        diverged = true;
+    }
+    if (!diverged || SessionReplayer(bytes).replay(false).finalHash != expectedHash) {
+        throw runtime_error("session replay: a wrong checkpoint was not detected");
+    }
+}
+
+void replayTraceFile(BenchmarkSuite& suite, const string& traceFile) {
+    SessionReplayer replayer(traceFile);
+    ReplayReport first = replayer.replay(true);
+    suite.measure("replay_" + fs::path(traceFile).filename().string(), first.operations, [&]() {
+        ReplayReport report = replayer.replay(true);
+        if (report.finalHash != first.finalHash) {
+            throw runtime_error("replay: " + traceFile + " did not replay the same way twice");
+        }
+        return report.seconds;
+    });
+}
+
+#ifdef CARDGAME_SHARED_DECK
+void benchSharedDeck(BenchmarkSuite& suite, long long n) {
+    string publishName = "shm_publish_d" + to_string(n);
+    string rawName = "shm_publish_records_d" + to_string(n);
+    string contendedName = "shm_publish_records_with_readers_d" + to_string(n);
+    string lookupName = "shm_lookup_d" + to_string(n);
+    if (!suite.isSelected(publishName) && !suite.isSelected(rawName) && !suite.isSelected(contendedName)
+        && !suite.isSelected(lookupName)) {
+        return;
+    }
+    string segment = "/deck_bench_" + to_string(getpid());
+    Deck deck(static_cast<int>(n), "Shared", "Bench");
+    for (long long i = 0; i < n; i++) {
+        deck.addCard(makeMixedCard(i));
+    }
+    SharedDeckWriter writer(segment, static_cast<int>(n));
+    writer.publish(deck);
+    SharedDeckReader reader(segment);
+
+    vector<SharedCard> copy;
+    SharedDeckInfo info = reader.snapshot(copy);
+    if (info.count != n || info.totalValue != deck.getTotalValue() || info.deckName != "Shared"
+        || copy.back().getName() != deck.getCard(static_cast<int>(n - 1))->getName()) {
+        throw runtime_error("shared deck: reader does not see the published deck");
+    }
+
+    suite.measure(publishName, n, [&]() {
+        Stopwatch sw;
+        writer.publish(deck);
+        return sw.elapsedSeconds();
+    });
+
+    const long long lookups = 1000000;
+    suite.measure(lookupName, lookups, [&]() {
+        SharedCard card;
+        long long total = 0;
+        Stopwatch sw;
+        for (long long i = 0; i < lookups; i++) {
+            reader.getCard(static_cast<int>((i * 7919) % n), card);
+            total += card.value;
+        }
+        benchSink = total;
+        return sw.elapsedSeconds();
+    });
+
+    // Every publish stamps all cards with its version; a reader must never
+    // accept a read that mixes two versions
+    vector<SharedCard> stamped(copy);
+    int32_t stamp = 0;
+    for (auto& card : stamped) card.baseValue = stamp;
+    writer.publish(stamped, "Shared", "Bench", static_cast<int>(n));
+    auto publishStamped = [&]() {
+        stamp++;
+        for (auto& card : stamped) card.baseValue = stamp;
+        Stopwatch sw;
+        writer.publish(stamped, "Shared", "Bench", static_cast<int>(n));
+        return sw.elapsedSeconds();
+    };
+    suite.measure(rawName, n, publishStamped);
+
+    atomic<bool> done(false);
+    atomic<long long> reads(0);
+    atomic<long long> torn(0);
+    auto readLoop = [&]() {
+        SharedDeckReader own(segment);
+        while (!done.load(memory_order_relaxed)) {
+            int32_t low = INT32_MAX, high = INT32_MIN;
+            own.read([&](const SharedCard* cards, int count) {
+                low = INT32_MAX;
+                high = INT32_MIN;
+                for (int i = 0; i < count; i++) {
+                    low = min(low, cards[i].baseValue);
+                    high = max(high, cards[i].baseValue);
+                }
+            });
+            if (low != high) torn++;
+            reads++;
+        }
+    };
+    vector<thread> readers;
+    for (int t = 0; t < 2; t++) {
+        readers.emplace_back(readLoop);
+    }
+    suite.measure(contendedName, n, publishStamped);
+    while (reads.load() < 100) {
+        writer.publish(stamped, "Shared", "Bench", static_cast<int>(n));
+        this_thread::yield();
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+    if (torn.load() != 0) {
+        throw runtime_error("shared deck: readers accepted " + to_string(torn.load()) + " torn reads");
+    }
+}
+#endif
+
+// Deltas between two saves of a large deck that differ in a few cards, plus
+// the byte-block fallback and a patch applied to the wrong base
+void benchDeckDelta(BenchmarkSuite& suite, long long n, const string& tempDir) {
+    string cardsName = "delta_create_cards_d" + to_string(n);
+    string applyName = "delta_apply_d" + to_string(n);
+    string blocksName = "delta_create_blocks_d" + to_string(n);
+    if (!suite.isSelected(cardsName) && !suite.isSelected(applyName) && !suite.isSelected(blocksName)) {
+        return;
+    }
+    // The new save replaces 8 cards, inserts one and drops one
+    vector<long long> oldIds, newIds;
+    for (long long i = 0; i < n; i++) {
+        oldIds.push_back(i);
+    }
+    newIds = oldIds;
+    for (int k = 0; k < 8; k++) {
+        newIds[(n * k) / 8 + k % 3] = n + k;
+    }
+    newIds.insert(newIds.begin() + n / 3, n + 8);
+    newIds.erase(newIds.begin() + (2 * n) / 3);
+    auto saveIds = [&](const vector<long long>& ids, const string& path) {
+        Deck deck(static_cast<int>(ids.size()), "Delta", "Bench");
+        for (long long id : ids) {
+            deck.addCard(makeMixedCard(id));
+        }
+        deck.saveToBinary(path);
+        return DeckDelta::readFile(path);
+    };
+    string path = tempDir + "/delta.dat";
+    vector<char> oldFile = saveIds(oldIds, path);
+    vector<char> newFile = saveIds(newIds, path);
+    fs::remove(path);
+
+    vector<char> delta;
+    suite.measure(cardsName, n, [&]() {
+        DeltaStats stats;
+        Stopwatch sw;
+        delta = DeckDelta::create(oldFile, newFile, &stats);
+        double seconds = sw.elapsedSeconds();
+        // Ten changed records cost a few hundred bytes however large the deck is
+        if (stats.method != DeckDelta::METHOD_CARDS || stats.insertedBytes > 2000 || delta.size() > 3000) {
+            throw runtime_error("deck delta: " + to_string(delta.size()) + "-byte delta for 10 changed cards");
+        }
+        return seconds;
+    });
+    suite.measure(applyName, n, [&]() {
+        if (delta.empty()) {
+            delta = DeckDelta::create(oldFile, newFile);
+        }
+        Stopwatch sw;
+        vector<char> patched = DeckDelta::apply(oldFile, delta);
+        double seconds = sw.elapsedSeconds();
+        if (patched != newFile) {
+            throw runtime_error("deck delta: patched deck differs from the new save");
+        }
+        bool rejected = false;
+        try {
+            DeckDelta::apply(newFile, delta);
+        } catch (const runtime_error&) {
+            rejected = true;
+        }
+        if (!rejected) {
+            throw runtime_error("deck delta: patch applied to the wrong base deck");
+        }
+        return seconds;
+    });
+
+    // A prefix that is not a deck header forces block matching
+    suite.measure(blocksName, n, [&]() {
+        vector<char> oldBytes(oldFile), newBytes(newFile);
+        oldBytes.insert(oldBytes.begin(), {'R', 'A', 'W'});
+        newBytes.insert(newBytes.begin(), {'R', 'A', 'W'});
+        DeltaStats stats;
+        Stopwatch sw;
+        vector<char> blockDelta = DeckDelta::create(oldBytes, newBytes, &stats);
+        double seconds = sw.elapsedSeconds();
+        if (stats.method != DeckDelta::METHOD_BLOCKS || blockDelta.size() > 10 * 3000
+            || DeckDelta::apply(oldBytes, blockDelta) != newBytes) {
+            throw runtime_error("deck delta: block delta is too large or does not round-trip");
+        }
+        return seconds;
+    });
+}
+
+// Saves of many variants of one deck, each changing three cards of the last,
+// as plain files and through the deduplicating store
+void benchDeckStore(BenchmarkSuite& suite, long long n, const string& tempDir) {
+    string plainName = "store_save_plain_d" + to_string(n);
+    string dedupName = "store_save_dedup_d" + to_string(n);
+    string loadName = "store_load_d" + to_string(n);
+    if (!suite.isSelected(plainName) && !suite.isSelected(dedupName) && !suite.isSelected(loadName)) {
+        return;
+    }
+    const int variantCount = 20;
+    vector<vector<char>> variants;
+    vector<long long> ids;
+    for (long long i = 0; i < n; i++) {
+        ids.push_back(i);
+    }
+    for (int v = 0; v < variantCount; v++) {
+        for (int k = 0; k < 3; k++) {
+            ids[(v * 7919 + k * 104729) % n] = n + v * 3 + k;
+        }
+        Deck deck(static_cast<int>(n), "Variant", "Bench");
+        for (long long id : ids) {
+            deck.addCard(makeMixedCard(id));
+        }
+        ByteWriter out;
+        deck.writeTo(out);
+        variants.emplace_back(out.data(), out.data() + out.size());
+    }
+    size_t plainBytes = 0;
+    for (const auto& bytes : variants) {
+        plainBytes += bytes.size();
+    }
+    string directory = tempDir + "/store/";
+    auto referencePath = [&](int v) { return directory + "variant" + to_string(v) + DeckStore::REFERENCE_EXTENSION; };
+
+    suite.measure(plainName, n * variantCount, [&]() {
+        fs::remove_all(directory);
+        fs::create_directories(directory);
+        Stopwatch sw;
+        for (int v = 0; v < variantCount; v++) {
+            ofstream file(directory + "variant" + to_string(v) + ".dat", ios::binary);
+            file.write(variants[v].data(), static_cast<streamsize>(variants[v].size()));
+        }
+        return sw.elapsedSeconds();
+    });
+    suite.measure(dedupName, n * variantCount, [&]() {
+        fs::remove_all(directory);
+        size_t written = 0;
+        Stopwatch sw;
+        DeckStore store(directory);
+        for (int v = 0; v < variantCount; v++) {
+            written += store.put(referencePath(v), variants[v].data(), variants[v].size()).bytesWritten;
+        }
+        double seconds = sw.elapsedSeconds();
+        // Variants after the first should cost a few chunks each, index log included
+        StoreUsage usage = store.usage();
+        StoreUsage replayed = DeckStore(directory).usage();
+        if (replayed.chunks != usage.chunks || replayed.chunkBytes != usage.chunkBytes) {
+            throw runtime_error("deck store: reopening the store did not replay its index log");
+        }
+        if (usage.packBytes * 3 > plainBytes || written * 2 > plainBytes) {
+            throw runtime_error("deck store: " + to_string(usage.packBytes) + " bytes stored and "
+                                + to_string(written) + " written for " + to_string(plainBytes) + " bytes of decks");
+        }
+        return seconds;
+    });
+    suite.measure(loadName, n * variantCount, [&]() {
+        fs::remove_all(directory);
+        DeckStore store(directory);
+        for (int v = 0; v < variantCount; v++) {
+            store.put(referencePath(v), variants[v].data(), variants[v].size());
+        }
+        Stopwatch sw;
+        bool same = true;
+        for (int v = 0; v < variantCount; v++) {
+            same = store.get(referencePath(v)) == variants[v] && same;
+        }
+        double seconds = sw.elapsedSeconds();
+        if (!same) {
+            throw runtime_error("deck store: a stored variant did not load back unchanged");
+        }
+
+        // Deleting releases chunks; only the remaining deck's stay referenced and it still loads
+        for (int v = 0; v + 1 < variantCount; v++) {
+            store.remove(referencePath(v));
+        }
+        DeckStore reopened(directory);
+        if (reopened.usage().chunkBytes > variants.back().size()
+            || reopened.get(referencePath(variantCount - 1)) != variants.back()) {
+            throw runtime_error("deck store: deleting variants did not free their chunks");
+        }
+        reopened.remove(referencePath(variantCount - 1));
+        if (reopened.usage().chunks != 0 || reopened.usage().packBytes != 0) {
+            throw runtime_error("deck store: chunks left after every deck was deleted");
+        }
+        return seconds;
+    });
+    fs::remove_all(directory);
+}
+
+// Memory report of a mixed deck with long card names, checked against what the
+// heap (and the tracking allocator, when built in) saw while building the deck
+void benchMemoryReport(BenchmarkSuite& suite, long long n) {
+    string name = "memory_report_d" + to_string(n);
+    if (!suite.isSelected(name)) {
+        return;
+    }
+#ifdef __GLIBC__
+    auto heapInUse = [] {
+        struct mallinfo2 info = mallinfo2();
+        return static_cast<long long>(info.uordblks + info.hblkhd);
+    };
+#else
+    auto heapInUse = [] { return 0LL; };
+#endif
+    long long heapBefore = heapInUse();
+    MemoryTracker::Scope scope;
+    Deck deck(static_cast<int>(n), "Memory", "Bench");
+    for (long long i = 0; i < n; i++) {
+        Card* card = makeMixedCard(i);
+        card->setName("Card number " + to_string(i) + " of the memory benchmark");
+        deck.addCard(card);
+    }
+    long long heapGrowth = heapInUse() - heapBefore;
+    long long trackedGrowth = scope.bytes();
+
+    suite.measure(name, n, [&]() {
+        Stopwatch sw;
+        DeckMemoryReport report = deck.memoryReport();
+        double seconds = sw.elapsedSeconds();
+        size_t fields = 0;
+        for (const auto& type : report.byType) {
+            fields += type.objectBytes + type.stringHeapBytes + type.otherHeapBytes;
+        }
+        if (report.cards != n || report.byType.size() != 3
+            || fields != report.cardObjectBytes + report.stringHeapBytes + report.otherHeapBytes) {
+            throw runtime_error("memory report: per-type totals do not add up");
+        }
+        // Heap counters also see allocator noise, so allow 2% plus 64 KB
+        auto close = [&](long long measured, long long reported) {
+            return llabs(measured - reported) <= reported / 50 + 65536;
+        };
+        if (heapGrowth > 0 && !close(heapGrowth, static_cast<long long>(report.heapBytes()))) {
+            throw runtime_error("memory report: " + to_string(report.heapBytes()) + " bytes reported, heap grew by "
+                                + to_string(heapGrowth));
+        }
+        if (MemoryTracker::enabled() && !close(trackedGrowth, static_cast<long long>(report.allocatedBytes))) {
+            throw runtime_error("memory report: " + to_string(report.allocatedBytes)
+                                + " bytes reported, tracking allocator saw " + to_string(trackedGrowth));
+        }
+        return seconds;
+    });
+}
+
+// Name search over a collection whose names share long prefixes, as real card
+// names do. Answers are checked against a linear scan of the deck.
+void benchNameIndex(BenchmarkSuite& suite, long long n) {
+    string buildName = "name_index_build_d" + to_string(n);
+    string completeName = "name_complete_d" + to_string(n);
+    string similarName = "name_similar_d" + to_string(n);
+    string updateName = "name_index_update_d" + to_string(n);
+    if (!suite.isSelected(buildName) && !suite.isSelected(completeName) && !suite.isSelected(similarName)
+        && !suite.isSelected(updateName)) {
+        return;
+    }
+    static const char* const WORDS[] = {"Ancient", "Blazing", "Crimson", "Dragon", "Eternal", "Frost",
+                                        "Golden", "Hollow", "Iron", "Jade", "Knight", "Lunar"};
+    auto nameFor = [](long long i) {
+        return string(WORDS[i % 12]) + " " + WORDS[(i / 12) % 12] + " " + to_string(i);
+    };
+    Deck deck(static_cast<int>(n) + 1, "Names", "Bench");
+    for (long long i = 0; i < n; i++) {
+        Card* card = makeMixedCard(i);
+        card->setName(nameFor(i));
+        deck.addCard(card);
+    }
+    auto lower = [](string text) {
+        for (char& c : text) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        return text;
+    };
+
+    suite.measure(buildName, n, [&]() {
+        deck.refreshNameIndex();
+        Stopwatch sw;
+        const CardNameIndex& index = deck.getNameIndex();
+        double seconds = sw.elapsedSeconds();
+        if (index.size() != static_cast<size_t>(n) || index.distinctNames() != static_cast<size_t>(n)) {
+            throw runtime_error("name index: built over the wrong number of cards");
+        }
+        return seconds;
+    });
+
+    // Every keystroke of a few names, the way an autocomplete box asks
+    vector<string> prefixes;
+    for (long long target : {n / 3, n / 2, n - 1}) {
+        string full = nameFor(target);
+        for (size_t length = 1; length <= full.size(); length++) {
+            prefixes.push_back(full.substr(0, length));
+        }
+    }
+    suite.measure(completeName, static_cast<long long>(prefixes.size()), [&]() {
+        const CardNameIndex& index = deck.getNameIndex();
+        vector<vector<NameMatch>> answers;
+        answers.reserve(prefixes.size());
+        Stopwatch sw;
+        for (const auto& prefix : prefixes) {
+            answers.push_back(index.complete(prefix, 10));
+        }
+        double seconds = sw.elapsedSeconds();
+        for (size_t q = 0; q < prefixes.size(); q++) {
+            string prefix = lower(prefixes[q]);
+            const auto& answer = answers[q];
+            for (size_t i = 0; i < answer.size(); i++) {
+                string name = lower(answer[i].name);
+                if (name.compare(0, prefix.size(), prefix) != 0 || (i > 0 && lower(answer[i - 1].name) >= name)) {
+                    throw runtime_error("name index: completions of '" + prefixes[q] + "' are wrong or out of order");
+                }
+            }
+        }
+        // The smallest names and the prefix counts must match a scan of the deck
+        for (const string& prefix : {prefixes[0], prefixes[6], prefixes.back()}) {
+            string key = lower(prefix);
+            vector<string> matching;
+            for (int i = 0; i < deck.getCurrentSize(); i++) {
+                string name = lower(deck.getCard(i)->getName());
+                if (name.compare(0, key.size(), key) == 0) matching.push_back(name);
+            }
+            sort(matching.begin(), matching.end());
+            vector<NameMatch> answer = index.complete(prefix, 10);
+            bool same = index.countPrefix(prefix) == matching.size() && answer.size() == min<size_t>(10, matching.size());
+            for (size_t i = 0; same && i < answer.size(); i++) {
+                same = lower(answer[i].name) == matching[i];
+            }
+            if (!same) {
+                throw runtime_error("name index: completions of '" + prefix + "' differ from a scan of the deck");
+            }
+        }
+        return seconds;
+    });
+
+    // Misspellings: a swapped pair of letters, a dropped letter, a wrong digit
+    vector<pair<string, string>> typos;
+    for (long long i = 0; i < 30; i++) {
+        long long target = (i * 7919) % n;
+        string name = nameFor(target);
+        string typo = name;
+        switch (i % 3) {
+            case 0: swap(typo[1], typo[2]); break;
+            case 1: typo.erase(3, 1); break;
+            default: typo.back() = typo.back() == '0' ? '1' : '0'; break;
+        }
+        typos.emplace_back(typo, name);
+    }
+    suite.measure(similarName, static_cast<long long>(typos.size()), [&]() {
+        const CardNameIndex& index = deck.getNameIndex();
+        vector<vector<NameMatch>> answers;
+        answers.reserve(typos.size());
+        Stopwatch sw;
+        for (const auto& typo : typos) {
+            answers.push_back(index.findSimilar(typo.first, 2, 5));
+        }
+        double seconds = sw.elapsedSeconds();
+        for (size_t q = 0; q < typos.size(); q++) {
+            bool found = false;
+            for (const auto& match : answers[q]) {
+                found = found || match.name == typos[q].second;
+                if (match.distance > 2 || (&match != &answers[q][0] && match.distance < (&match - 1)->distance)) {
+                    throw runtime_error("name index: fuzzy matches for '" + typos[q].first + "' are not closest first");
+                }
+            }
+            if (!found) {
+                throw runtime_error("name index: '" + typos[q].first + "' did not find '" + typos[q].second + "'");
+            }
+        }
+        return seconds;
+    });
+
+    // Drawing and adding cards keeps the index in step without a rebuild
+    const long long updates = min<long long>(n, 100000);
+    suite.measure(updateName, updates, [&]() {
+        const CardNameIndex& index = deck.getNameIndex();
+        vector<Card*> drawn;
+        drawn.reserve(updates);
+        Stopwatch sw;
+        for (long long i = 0; i < updates; i++) {
+            drawn.push_back(deck.drawCard());
+        }
+        for (long long i = updates - 1; i >= 0; i--) {
+            deck.addCard(drawn[i]);
+        }
+        double seconds = sw.elapsedSeconds();
+        Card* extra = makePlayingCard(n);
+        extra->setName("Zephyr Unique");
+        deck.addCard(extra);
+        bool added = index.findExact("zephyr UNIQUE").size() == 1 && index.size() == static_cast<size_t>(n) + 1;
+        delete deck.drawCard();
+        if (!added || !index.findExact("Zephyr Unique").empty() || index.size() != static_cast<size_t>(n)
+            || index.findExact(nameFor(n - 1)).size() != 1) {
+            throw runtime_error("name index: not kept in step with draws and adds");
+        }
+        return seconds;
+    });
+}
+
+// Cross-collection card search over many small saved decks. Each name is in a
+// handful of decks, so answers are checked against what was written.
+void benchSaveIndex(BenchmarkSuite& suite, long long fileCount, const string& tempDir) {
+    string buildName = "save_index_build_f" + to_string(fileCount);
+    string refreshName = "save_index_refresh_f" + to_string(fileCount);
+    string missingName = "card_search_missing_f" + to_string(fileCount);
+    string presentName = "card_search_present_f" + to_string(fileCount);
+    if (!suite.isSelected(buildName) && !suite.isSelected(refreshName) && !suite.isSelected(missingName)
+        && !suite.isSelected(presentName)) {
+        return;
+    }
+    const int cardsPerDeck = 20;
+    const long long universe = fileCount * 5;
+    string dir = tempDir + "/indexed_" + to_string(fileCount) + "/";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    unordered_map<long long, vector<string>> decksWithCard;
+    for (long long f = 0; f < fileCount; f++) {
+        string filename = "deck_" + to_string(f) + ".dat";
+        Deck deck(cardsPerDeck, "Indexed " + to_string(f), "Bench");
+        SplitMix64 rng(static_cast<uint64_t>(f) + 1);
+        for (int c = 0; c < cardsPerDeck; c++) {
+            long long id = static_cast<long long>(rng.nextBelow(static_cast<uint64_t>(universe)));
+            deck.addCard(makeGameCard(id));
+            vector<string>& files = decksWithCard[id];
+            if (files.empty() || files.back() != filename) files.push_back(filename);
+        }
+        deck.saveToBinary(dir + filename);
+    }
+    for (auto& item : decksWithCard) {
+        sort(item.second.begin(), item.second.end());
+        item.second.erase(unique(item.second.begin(), item.second.end()), item.second.end());
+    }
+
+    suite.measure(buildName, fileCount, [&]() {
+        fs::remove(dir + SaveIndex::INDEX_FILE);
+        Stopwatch sw;
+        SaveIndex index(dir);
+        SaveIndexRefresh refreshed = index.refresh();
+        double seconds = sw.elapsedSeconds();
+        if (refreshed.indexed != fileCount || refreshed.failed != 0 || index.size() != static_cast<size_t>(fileCount)) {
+            throw runtime_error("save index: indexed " + to_string(refreshed.indexed) + " of "
+                                + to_string(fileCount) + " deck files");
+        }
+        return seconds;
+    });
+
+    // Unchanged files cost a stat each and are not read
+    suite.measure(refreshName, fileCount, [&]() {
+        Stopwatch sw;
+        SaveIndex index(dir);
+        SaveIndexRefresh refreshed = index.refresh();
+        double seconds = sw.elapsedSeconds();
+        if (refreshed.files != fileCount || refreshed.indexed != 0 || refreshed.removed != 0) {
+            throw runtime_error("save index: refresh reread unchanged deck files");
+        }
+        return seconds;
+    });
+
+    SaveIndex index(dir);
+    const int queries = 200;
+    suite.measure(missingName, queries, [&]() {
+        int opened = 0;
+        int found = 0;
+        Stopwatch sw;
+        for (int q = 0; q < queries; q++) {
+            CardSearchResult result = index.findCard("Card " + to_string(universe + q));
+            opened += result.candidates;
+            found += static_cast<int>(result.files.size());
+        }
+        double seconds = sw.elapsedSeconds();
+        // About one false match per two million filter checks; allow ten times that
+        if (found != 0 || opened > 1 + static_cast<int>(queries * fileCount / 200000)) {
+            throw runtime_error("save index: missing cards opened " + to_string(opened) + " deck files");
+        }
+        return seconds;
+    });
+
+    suite.measure(presentName, queries, [&]() {
+        vector<long long> ids;
+        vector<CardSearchResult> results;
+        Stopwatch sw;
+        for (int q = 0; q < queries; q++) {
+            long long id = (static_cast<long long>(q) * 7919) % universe;
+            ids.push_back(id);
+            results.push_back(index.findCard("CARD " + to_string(id)));
+        }
+        double seconds = sw.elapsedSeconds();
+        for (int q = 0; q < queries; q++) {
+            auto it = decksWithCard.find(ids[q]);
+            const vector<string> expected = it == decksWithCard.end() ? vector<string>() : it->second;
+            if (results[q].files != expected) {
+                throw runtime_error("save index: wrong decks for Card " + to_string(ids[q]));
+            }
+        }
+        return seconds;
+    });
+
+    // Serial numbers are indexed too, and saves, edits and deletes are picked up
+    // (game card serials equal their id, and serial 0 means unnumbered)
+    auto numbered = decksWithCard.begin();
+    if (numbered->first == 0) ++numbered;
+    const string& holder = numbered->second.front();
+    vector<string> serialMatches = index.candidatesForSerial(static_cast<int>(numbered->first));
+    if (find(serialMatches.begin(), serialMatches.end(), holder) == serialMatches.end()) {
+        throw runtime_error("save index: serial number search missed " + holder);
+    }
+    Deck extra(1, "Extra", "Bench");
+    extra.addCard(new PlayingCard("Unindexed Wonder", 5));
+    extra.saveToBinary(dir + "extra.dat");
+    index.update("extra.dat", extra);
+    bool added = index.findCard("unindexed wonder").files == vector<string>{"extra.dat"};
+    fs::remove(dir + "extra.dat");
+    fs::remove(dir + "deck_0.dat");
+    SaveIndexRefresh refreshed = index.refresh();
+    if (!added || refreshed.removed != 2 || !index.findCard("Unindexed Wonder").files.empty()
+        || index.size() != static_cast<size_t>(fileCount - 1)) {
+        throw runtime_error("save index: saves and deletes were not tracked");
+    }
+    fs::remove_all(dir);
+}
+
+void printUsage() {
+    cout << "Usage: deck_bench [--max-size N] [--filter TEXT] [--json FILE]\n"
+         << "                  [--baseline FILE] [--threshold FRACTION] [--stats FILE]\n"
+         << "                  [--replay TRACE]\n"
+         << "Runs deck, card, rules and file manager benchmarks at sizes 52..N (default 10000000).\n"
+         << "With --baseline, exits with status 2 if any benchmark regressed by more than\n"
+         << "the threshold (default 0.15). --stats writes the instrumentation histograms.\n"
+         << "--replay also times a recorded game session (saves/last_session.trace)." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    long long maxSize = 10000000;
+    string filter, jsonFile, baselineFile, statsFile, replayFile;
+    double threshold = 0.15;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--max-size" && hasValue) {
+                maxSize = stoll(argv[++i]);
+            } else if (arg == "--filter" && hasValue) {
+                filter = argv[++i];
+            } else if (arg == "--json" && hasValue) {
+                jsonFile = argv[++i];
+            } else if (arg == "--baseline" && hasValue) {
+                baselineFile = argv[++i];
+            } else if (arg == "--threshold" && hasValue) {
+                threshold = stod(argv[++i]);
+            } else if (arg == "--stats" && hasValue) {
+                statsFile = argv[++i];
+            } else if (arg == "--replay" && hasValue) {
+                replayFile = argv[++i];
+            } else {
+                printUsage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+
+        string tempDir = (fs::temp_directory_path() / "deck_bench").string();
+        fs::create_directories(tempDir);
+
+        BenchmarkSuite suite(filter);
+        const long long deckSizes[] = {52, 1000, 100000, 1000000, 10000000};
+        for (long long n : deckSizes) {
+            if (n > maxSize) break;
+            benchDeckOperations(suite, n, tempDir);
+            benchGetValue(suite, n);
+            benchValueCache(suite, n);
+        }
+        const long long concurrentSizes[] = {100000, 1000000};
+        for (long long n : concurrentSizes) {
+            if (n > maxSize) break;
+            benchConcurrentDeck(suite, n);
+        }
+        const long long versionedSizes[] = {1000, 100000, 1000000};
+        for (long long n : versionedSizes) {
+            if (n > maxSize) break;
+            benchVersionedDeck(suite, n);
+        }
+        const long long flyweightSizes[] = {100000, 1000000};
+        for (long long n : flyweightSizes) {
+            if (n > maxSize) break;
+            benchFlyweight(suite, n);
+        }
+        const long long tickSizes[] = {1000, 100000, 1000000};
+        for (long long n : tickSizes) {
+            if (n > maxSize) break;
+            benchEffectTick(suite, n);
+        }
+        const long long playerCounts[] = {10, 1000};
+        for (long long players : playerCounts) {
+            if (players * 13 > maxSize) break;
+            benchDeal(suite, players, 13);
+        }
+        const long long shoeSizes[] = {416, 100000, 1000000};
+        for (long long n : shoeSizes) {
+            if (n > maxSize) break;
+            benchShoe(suite, n);
+        }
+        const long long weightedSizes[] = {1000, 100000, 1000000};
+        for (long long n : weightedSizes) {
+            if (n > maxSize) break;
+            benchWeightedDraw(suite, n);
+        }
+        const long long sortSizes[] = {1000, 100000, 1000000, 10000000};
+        for (long long n : sortSizes) {
+            if (n > maxSize) break;
+            benchSort(suite, n);
+        }
+        benchSerialization(suite, min<long long>(1000000, maxSize), tempDir);
+        benchAutosave(suite, min<long long>(100000, maxSize), tempDir);
+        benchSessionReplay(suite, min<long long>(2000, maxSize), tempDir);
+        const long long deltaSizes[] = {1000, 100000, 1000000};
+        for (long long n : deltaSizes) {
+            if (n > maxSize) break;
+            benchDeckDelta(suite, n, tempDir);
+        }
+        const long long storeSizes[] = {1000, 10000};
+        for (long long n : storeSizes) {
+            if (n > maxSize) break;
+            benchDeckStore(suite, n, tempDir);
+        }
+        const long long memorySizes[] = {1000, 100000, 1000000};
+        for (long long n : memorySizes) {
+            if (n > maxSize) break;
+            benchMemoryReport(suite, n);
+        }
+        const long long nameSizes[] = {1000, 100000, 2000000};
+        for (long long n : nameSizes) {
+            if (n > maxSize) break;
+            benchNameIndex(suite, n);
+        }
+#ifdef CARDGAME_SHARED_DECK
+        const long long sharedSizes[] = {52, 100000, 1000000};
+        for (long long n : sharedSizes) {
+            if (n > maxSize) break;
+            benchSharedDeck(suite, n);
+        }
+#endif
+        if (!replayFile.empty()) {
+            replayTraceFile(suite, replayFile);
+        }
+        benchGameSimulation(suite);
+        benchMonteCarlo(suite);
+        benchHypergeometric(suite);
+        benchRulesSearch(suite);
+        const long long fileCounts[] = {10, 100, 1000, 10000};
+        for (long long n : fileCounts) {
+            if (n > maxSize) break;
+            benchDirectoryScan(suite, n, tempDir);
+        }
+        const long long collectionSizes[] = {1000, 20000};
+        for (long long n : collectionSizes) {
+            if (n > maxSize) break;
+            benchCollectionLoad(suite, n, tempDir);
+        }
+        const long long indexedSizes[] = {1000, 50000};
+        for (long long n : indexedSizes) {
+            if (n > maxSize) break;
+            benchSaveIndex(suite, n, tempDir);
+        }
+        fs::remove_all(tempDir);
+
+        cout << endl;
+        suite.printTable(cout);
+
+        if (!jsonFile.empty()) {
+            ofstream out(jsonFile);
+            if (!out) {
+                throw runtime_error("Could not open JSON output file: " + jsonFile);
+            }
+            suite.writeJson(out);
+            cout << "\nResults written to " << jsonFile << endl;
+        }
+
+        if (!statsFile.empty()) {
+            ofstream out(statsFile);
+            if (!out) {
+                throw runtime_error("Could not open stats output file: " + statsFile);
+            }
+            StatsRegistry::instance().writeJson(out);
+            cout << "Instrumentation statistics written to " << statsFile << endl;
+        }
+
+        if (!baselineFile.empty()) {
+            int regressions = suite.compareToBaseline(baselineFile, threshold, cout);
+            if (regressions > 0) {
+                cout << regressions << " benchmark(s) regressed." << endl;
+                return 2;
+            }
+            cout << "No regressions." << endl;
+        }
+    } catch (const exception& e) {
+        cerr << "Benchmark error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,384 @@
+#include "DeckCollectionLoader.h"
+#include "WorkStealingPool.h"
+#include "Stats.h"
+#include <chrono>
+#include <cstring>
+
+#ifdef CARDGAME_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
+
+namespace {
+
+// The smallest io_uring wrapper the loader needs, over the raw system calls
+// (liburing is not a dependency). One thread submits and reaps.
+class IoRing {
+private:
+    int ringFd = -1;
+    void* sqRing = MAP_FAILED;
+    void* cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqEntries = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    unsigned pendingTail = 0;    // Local tail, published on submit
+    unsigned submittedTail = 0;
+    unsigned firstHead = 0;      // Submission head at setup, to count what the kernel has taken
+    unsigned reaped = 0;         // Completions taken off the queue
+
+public:
+    ~IoRing() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+        if (ringFd >= 0) close(ringFd);
+    }
+
+    bool init(unsigned entries) {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd < 0) {
+            return false;
+        }
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap) {
+            sqRingSize = cqRingSize = max(sqRingSize, cqRingSize);
+        }
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_SQ_RING);
+        if (sqRing == MAP_FAILED) {
+            return false;
+        }
+        cqRing = singleMap ? sqRing
+                           : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            return false;
+        }
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+
+        char* sq = static_cast<char*>(sqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sqEntries = params.sq_entries;
+        char* cq = static_cast<char*>(cqRing);
+        cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        pendingTail = submittedTail = *sqTail;
+        firstHead = *sqHead;
+        return true;
+    }
+
+    // True if the kernel implements every opcode the loader uses
+    bool supportsLoaderOps() const {
+        const unsigned opCount = 256;
+        vector<char> storage(sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op), 0);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+        if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, opCount) < 0) {
+            return false;
+        }
+        for (int op : {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE}) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    unsigned getEntries() const {
+        return sqEntries;
+    }
+
+    // Next free submission entry, cleared; the caller keeps in-flight work below the ring size
+    io_uring_sqe* nextSqe() {
+        unsigned head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        if (pendingTail - head >= sqEntries) {
+            throw runtime_error("io_uring submission queue overflow");
+        }
+        unsigned index = pendingTail & *sqMask;
+        sqArray[index] = index;
+        pendingTail++;
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    // Submits everything queued and waits for at least one completion
+    void submitAndWait() {
+        __atomic_store_n(sqTail, pendingTail, __ATOMIC_RELEASE);
+        unsigned toSubmit = pendingTail - submittedTail;
+        while (true) {
+            long result = syscall(__NR_io_uring_enter, ringFd, toSubmit, 1, IORING_ENTER_GETEVENTS,
+                                  nullptr, 0);
+            if (result >= 0) {
+                submittedTail += static_cast<unsigned>(result);
+                return;
+            }
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                throw runtime_error(string("io_uring_enter failed: ") + strerror(errno));
+            }
+        }
+    }
+
+    bool peekCompletion(io_uring_cqe& completion) {
+        unsigned head = *cqHead;
+        if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        completion = cqes[head & *cqMask];
+        __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+        reaped++;
+        return true;
+    }
+
+    // Discards completions until every operation the kernel has taken has finished,
+    // so none still points into caller buffers. False if the ring stopped working.
+    bool drain() {
+        io_uring_cqe completion;
+        while (true) {
+            while (peekCompletion(completion)) {
+            }
+            if (__atomic_load_n(sqHead, __ATOMIC_ACQUIRE) - firstHead == reaped) {
+                return true;
+            }
+            long result = syscall(__NR_io_uring_enter, ringFd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                return false;
+            }
+        }
+    }
+};
+
+// Per-file state while its operations are in flight
+struct ReadJob {
+    enum Stage { OPENING, READING, CLOSING };
+    Stage stage = OPENING;
+    int fd = -1;
+    vector<char> data;
+    size_t filled = 0;
+};
+
+const size_t INITIAL_READ_SIZE = 16 * 1024;
+
+}  // namespace
+#endif // CARDGAME_IO_URING
+
+// Constructor implementation with validation
+DeckCollectionLoader::DeckCollectionLoader(int depth, int threadCount)
+    : queueDepth(depth), threads(threadCount), ioUringEnabled(true) {
+    if (depth < 1 || depth > 4096) {
+        throw runtime_error("Queue depth must be between 1 and 4096");
+    }
+    if (threadCount < 0) {
+        throw runtime_error("Thread count cannot be negative");
+    }
+}
+
+// Core functionality implementations
+DeckLoadResult DeckCollectionLoader::loadFiles(const vector<string>& files) const {
+    auto start = chrono::steady_clock::now();
+    DeckLoadResult result;
+    vector<FileSlot> slots(files.size());
+
+    if (!files.empty()) {
+        result.usedIoUring = ioUringEnabled && loadWithIoUring(files, slots);
+        if (!result.usedIoUring) {
+            loadWithThreads(files, slots);
+        }
+    }
+
+    for (size_t i = 0; i < files.size(); i++) {
+        result.bytesRead += slots[i].bytes;
+        if (slots[i].deck) {
+            result.decks.push_back(move(slots[i].deck));
+            result.files.push_back(files[i]);
+        } else {
+            result.failures.push_back({files[i], slots[i].error});
+        }
+    }
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+void DeckCollectionLoader::setUseIoUring(bool enabled) {
+    ioUringEnabled = enabled;
+}
+
+bool DeckCollectionLoader::ioUringAvailable() {
+#ifdef CARDGAME_IO_URING
+    IoRing ring;
+    return ring.init(1) && ring.supportsLoaderOps();
+#else
+    return false;
+#endif
+}
+
+// Private helper implementations
+bool DeckCollectionLoader::loadWithIoUring(const vector<string>& files, vector<FileSlot>& slots) const {
+#ifdef CARDGAME_IO_URING
+    IoRing ring;
+    if (!ring.init(static_cast<unsigned>(queueDepth)) || !ring.supportsLoaderOps()) {
+        return false;
+    }
+
+    // Each file has at most one operation in flight, so the ring never overflows
+    size_t inFlightLimit = min<size_t>(ring.getEntries(), files.size());
+    vector<ReadJob> jobs(files.size());
+    size_t nextFile = 0;
+    size_t finished = 0;
+    long long totalBytes = 0;
+
+    auto startOpen = [&](size_t index) {
+        io_uring_sqe* sqe = ring.nextSqe();
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(files[index].c_str());
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = index;
+    };
+    auto startRead = [&](size_t index) {
+        ReadJob& job = jobs[index];
+        io_uring_sqe* sqe = ring.nextSqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = job.fd;
+        sqe->addr = reinterpret_cast<uint64_t>(job.data.data() + job.filled);
+        sqe->len = static_cast<uint32_t>(job.data.size() - job.filled);
+        sqe->off = job.filled;
+        sqe->user_data = index;
+    };
+    auto startClose = [&](size_t index) {
+        io_uring_sqe* sqe = ring.nextSqe();
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = jobs[index].fd;
+        sqe->user_data = index;
+        jobs[index].stage = ReadJob::CLOSING;
+        jobs[index].fd = -1;
+    };
+    auto finishJob = [&]() {
+        finished++;
+        if (nextFile < files.size()) {
+            startOpen(nextFile++);
+        }
+    };
+    auto decode = [&](size_t index) {
+        ReadJob& job = jobs[index];
+        try {
+            unique_ptr<Deck> deck(new Deck());
+            deck->loadFromBuffer(job.data.data(), job.filled);
+            slots[index].deck = move(deck);
+        } catch (const exception& e) {
+            slots[index].error = e.what();
+        }
+        slots[index].bytes = static_cast<long long>(job.filled);
+        totalBytes += static_cast<long long>(job.filled);
+        vector<char>().swap(job.data);
+    };
+
+    while (nextFile < inFlightLimit) {
+        startOpen(nextFile++);
+    }
+    try {
+        while (finished < files.size()) {
+            ring.submitAndWait();
+            io_uring_cqe completion;
+            while (ring.peekCompletion(completion)) {
+                size_t index = static_cast<size_t>(completion.user_data);
+                ReadJob& job = jobs[index];
+                int res = completion.res;
+
+                if (job.stage == ReadJob::OPENING) {
+                    if (res < 0) {
+                        slots[index].error = "Could not open file for reading: " + files[index] +
+                                             " (" + strerror(-res) + ")";
+                        finishJob();
+                        continue;
+                    }
+                    job.fd = res;
+                    job.stage = ReadJob::READING;
+                    job.data.resize(INITIAL_READ_SIZE);
+                    startRead(index);
+                } else if (job.stage == ReadJob::READING) {
+                    if (res < 0) {
+                        slots[index].error = string("Error reading file: ") + strerror(-res);
+                        startClose(index);
+                        continue;
+                    }
+                    if (res > 0) {
+                        // Reads may come back short before the end, so only an empty one ends the file
+                        job.filled += static_cast<size_t>(res);
+                        if (job.filled == job.data.size()) {
+                            job.data.resize(job.data.size() * 2);
+                        }
+                        startRead(index);
+                        continue;
+                    }
+                    decode(index);
+                    startClose(index);
+                } else {
+                    finishJob();
+                }
+            }
+        }
+    } catch (...) {
+        // Reads still in flight point into jobs[].data, so wait for them before the buffers go
+        if (!ring.drain()) {
+            new vector<ReadJob>(move(jobs));    // Leaked on purpose: the kernel may still write to them
+            throw;
+        }
+        for (auto& job : jobs) {
+            if (job.fd >= 0) close(job.fd);
+        }
+        throw;
+    }
+    STATS_COUNT(COUNTER_BYTES_READ, static_cast<uint64_t>(totalBytes));
+    return true;
+#else
+    (void)files;
+    (void)slots;
+    return false;
+#endif
+}
+
+void DeckCollectionLoader::loadWithThreads(const vector<string>& files, vector<FileSlot>& slots) const {
+    WorkStealingPool& pool = WorkStealingPool::shared(threads);
+    pool.parallelFor(static_cast<long long>(files.size()), 8, [&](int, long long begin, long long end) {
+        for (long long i = begin; i < end; i++) {
+            try {
+                unique_ptr<Deck> deck(new Deck());
+                deck->loadFromBinary(files[i]);
+                slots[i].bytes = static_cast<long long>(filesystem::file_size(files[i]));
+                slots[i].deck = move(deck);
+            } catch (const exception& e) {
+                slots[i].error = e.what();
+            }
+        }
+    });
+}
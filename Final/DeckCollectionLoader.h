@@ -0,0 +1,57 @@
+#ifndef DECKCOLLECTIONLOADER_H
+#define DECKCOLLECTIONLOADER_H
+
+#include "Deck.h"
+#include <vector>
+#include <string>
+#include <memory>
+
+struct DeckLoadFailure {
+    string file;
+    string error;
+};
+
+struct DeckLoadResult {
+    vector<unique_ptr<Deck>> decks;      // In the order of the files that loaded
+    vector<string> files;                // files[i] produced decks[i]
+    vector<DeckLoadFailure> failures;
+    long long bytesRead = 0;
+    double seconds = 0.0;
+    bool usedIoUring = false;
+};
+
+// Loads many deck files at once. On Linux builds with CARDGAME_IO_URING the
+// opens, reads and closes for up to queueDepth files are kept in flight
+// through one io_uring, and each file is decoded as soon as its read
+// completes, so a large collection costs a few system calls per batch rather
+// than several per file. When io_uring is not compiled in, or the kernel
+// refuses it, the files are loaded with Deck::loadFromBinary across a
+// WorkStealingPool instead.
+class DeckCollectionLoader {
+private:
+    int queueDepth;
+    int threads;
+    bool ioUringEnabled;
+
+public:
+    // Constructor; zero threads means one per hardware thread for the fallback
+    DeckCollectionLoader(int depth = 64, int threadCount = 0);
+
+    DeckLoadResult loadFiles(const vector<string>& files) const;
+
+    // Forces the thread-pool path even where io_uring is available
+    void setUseIoUring(bool enabled);
+    static bool ioUringAvailable();
+
+private:
+    struct FileSlot {
+        unique_ptr<Deck> deck;
+        string error;
+        long long bytes = 0;
+    };
+
+    bool loadWithIoUring(const vector<string>& files, vector<FileSlot>& slots) const;
+    void loadWithThreads(const vector<string>& files, vector<FileSlot>& slots) const;
+};
+
+#endif // DECKCOLLECTIONLOADER_H
@@ -0,0 +1,337 @@
+#include "DeckDelta.h"
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+static const char DELTA_MAGIC[8] = {'C', 'G', 'D', 'E', 'L', 'T', 'A', '1'};
+static const int MAX_CANDIDATES = 64;   // Same-hash records tried before giving up
+static const uint64_t ROLL_BASE = 0x100000001B3ULL;
+
+static void writeVarint(ByteWriter& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.write<uint8_t>(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.write<uint8_t>(static_cast<uint8_t>(value));
+}
+
+static uint64_t readVarint(ByteReader& in) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = in.read<uint8_t>();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw runtime_error("Invalid number in deck delta");
+}
+
+// Core functionality implementations
+vector<char> DeckDelta::create(const vector<char>& oldFile, const vector<char>& newFile, DeltaStats* stats) {
+    auto start = chrono::steady_clock::now();
+    vector<Op> ops;
+    vector<size_t> oldBounds, newBounds;
+    Method method = METHOD_BLOCKS;
+    if (splitRecords(oldFile, oldBounds) && splitRecords(newFile, newBounds)) {
+        method = METHOD_CARDS;
+        diffRecords(oldFile, oldBounds, newFile, newBounds, ops);
+    } else {
+        diffBlocks(oldFile, newFile, ops);
+    }
+
+    ByteWriter out;
+    out.reserve(64);
+    out.writeRaw(DELTA_MAGIC, sizeof(DELTA_MAGIC));
+    out.write<uint8_t>(method);
+    writeVarint(out, oldFile.size());
+    out.write(hashBytes(oldFile.data(), oldFile.size()));
+    writeVarint(out, newFile.size());
+    out.write(hashBytes(newFile.data(), newFile.size()));
+    writeVarint(out, ops.size());
+    DeltaStats result;
+    for (const Op& op : ops) {
+        out.write<uint8_t>(op.copy ? 0 : 1);
+        if (op.copy) {
+            writeVarint(out, op.offset);
+            writeVarint(out, op.length);
+            result.copies++;
+        } else {
+            writeVarint(out, op.length);
+            out.writeRaw(newFile.data() + op.offset, op.length);
+            result.inserts++;
+            result.insertedBytes += op.length;
+        }
+    }
+
+    if (stats) {
+        result.method = method;
+        result.oldSize = oldFile.size();
+        result.newSize = newFile.size();
+        result.deltaSize = out.size();
+        result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        *stats = result;
+    }
+    return vector<char>(out.data(), out.data() + out.size());
+}
+
+vector<char> DeckDelta::apply(const vector<char>& oldFile, const vector<char>& delta) {
+    ByteReader in(delta.data(), delta.size());
+    char magic[sizeof(DELTA_MAGIC)];
+    in.readRaw(magic, sizeof(magic));
+    if (memcmp(magic, DELTA_MAGIC, sizeof(magic)) != 0) {
+        throw runtime_error("Not a deck delta");
+    }
+    uint8_t method = in.read<uint8_t>();
+    if (method != METHOD_CARDS && method != METHOD_BLOCKS) {
+        throw runtime_error("Unknown deck delta method");
+    }
+    uint64_t oldSize = readVarint(in);
+    uint64_t oldHash = in.read<uint64_t>();
+    if (oldSize != oldFile.size() || oldHash != hashBytes(oldFile.data(), oldFile.size())) {
+        throw runtime_error("Delta was made against a different version of the deck");
+    }
+    uint64_t newSize = readVarint(in);
+    uint64_t newHash = in.read<uint64_t>();
+    uint64_t opCount = readVarint(in);
+
+    vector<char> result;
+    result.reserve(static_cast<size_t>(min<uint64_t>(newSize, oldSize + delta.size())));
+    for (uint64_t i = 0; i < opCount; i++) {
+        uint8_t tag = in.read<uint8_t>();
+        if (tag == 0) {
+            uint64_t offset = readVarint(in);
+            uint64_t length = readVarint(in);
+            if (offset > oldFile.size() || length > oldFile.size() - offset) {
+                throw runtime_error("Delta copies past the end of the old deck");
+            }
+            result.insert(result.end(), oldFile.begin() + offset, oldFile.begin() + offset + length);
+        } else if (tag == 1) {
+            uint64_t length = readVarint(in);
+            if (length > in.remaining()) {
+                throw runtime_error("Unexpected end of deck delta");
+            }
+            size_t at = result.size();
+            result.resize(at + length);
+            in.readRaw(result.data() + at, length);
+        } else {
+            throw runtime_error("Invalid operation in deck delta");
+        }
+        if (result.size() > newSize) {
+            throw runtime_error("Delta produces more bytes than it declares");
+        }
+    }
+    if (result.size() != newSize || hashBytes(result.data(), result.size()) != newHash) {
+        throw runtime_error("Patched deck does not match the delta's checksum");
+    }
+    return result;
+}
+
+DeltaStats DeckDelta::createFile(const string& oldPath, const string& newPath, const string& deltaPath) {
+    DeltaStats stats;
+    writeFile(deltaPath, create(readFile(oldPath), readFile(newPath), &stats));
+    return stats;
+}
+
+void DeckDelta::applyFile(const string& oldPath, const string& deltaPath, const string& outputPath) {
+    writeFile(outputPath, apply(readFile(oldPath), readFile(deltaPath)));
+}
+
+vector<char> DeckDelta::readFile(const string& path) {
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        throw runtime_error("Cannot open " + path);
+    }
+    vector<char> bytes(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(bytes.data(), static_cast<streamsize>(bytes.size()));
+    if (!in) {
+        throw runtime_error("Failed to read " + path);
+    }
+    return bytes;
+}
+
+void DeckDelta::writeFile(const string& path, const vector<char>& bytes) {
+    ofstream out(path, ios::binary | ios::trunc);
+    out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+    if (!out) {
+        throw runtime_error("Failed to write " + path);
+    }
+}
+
+// Private helper implementations
+bool DeckDelta::splitRecords(const vector<char>& file, vector<size_t>& boundaries) {
+    try {
+        ByteReader in(file.data(), file.size());
+        in.read<string>();
+        in.read<string>();
+        in.read<int32_t>();
+        int32_t count = in.read<int32_t>();
+        if (count < 0) {
+            return false;
+        }
+        bool typed = in.remaining() >= sizeof(int32_t) && in.peek<int32_t>() == DeckFormat::TYPED_CARDS_MARKER;
+        if (typed) {
+            in.read<int32_t>();
+        }
+        boundaries.clear();
+        boundaries.reserve(static_cast<size_t>(min<uint64_t>(count, in.remaining() / sizeof(uint16_t))) + 1);
+        boundaries.push_back(in.position());
+        const CardTypeRegistry& registry = CardTypeRegistry::instance();
+        for (int32_t i = 0; i < count; i++) {
+            if (typed) {
+                unique_ptr<Card> card(registry.decode(in));
+            } else {
+                in.read<string>();
+                in.read<int32_t>();
+            }
+            boundaries.push_back(in.position());
+        }
+        return in.remaining() == 0;
+    } catch (const exception&) {
+        return false;
+    }
+}
+
+void DeckDelta::diffRecords(const vector<char>& oldFile, const vector<size_t>& oldBounds,
+                            const vector<char>& newFile, const vector<size_t>& newBounds, vector<Op>& ops) {
+    // The header holds the card count, so it nearly always changes; it is a few dozen bytes
+    size_t oldHeader = oldBounds[0], newHeader = newBounds[0];
+    if (oldHeader == newHeader && memcmp(oldFile.data(), newFile.data(), newHeader) == 0) {
+        addOp(ops, true, 0, newHeader);
+    } else {
+        addOp(ops, false, 0, newHeader);
+    }
+
+    int oldCount = static_cast<int>(oldBounds.size()) - 1;
+    auto oldStart = [&](int i) { return oldBounds[i]; };
+    auto oldLength = [&](int i) { return oldBounds[i + 1] - oldBounds[i]; };
+    auto sameRecord = [&](int i, size_t start, size_t length) {
+        return oldLength(i) == length && memcmp(oldFile.data() + oldStart(i), newFile.data() + start, length) == 0;
+    };
+
+    // Old records by content hash; equal cards are chained in file order
+    unordered_map<uint64_t, int> firstWithHash;
+    firstWithHash.reserve(oldCount);
+    vector<int> nextWithHash(oldCount, -1);
+    for (int i = oldCount - 1; i >= 0; i--) {
+        uint64_t hash = hashBytes(oldFile.data() + oldStart(i), oldLength(i));
+        auto it = firstWithHash.find(hash);
+        if (it != firstWithHash.end()) {
+            nextWithHash[i] = it->second;
+            it->second = i;
+        } else {
+            firstWithHash.emplace(hash, i);
+        }
+    }
+
+    int expected = -1;   // Old record that would continue the current run
+    for (size_t j = 1; j < newBounds.size(); j++) {
+        size_t start = newBounds[j - 1];
+        size_t length = newBounds[j] - start;
+        int match = -1;
+        if (expected >= 0 && expected < oldCount && sameRecord(expected, start, length)) {
+            match = expected;
+        } else {
+            auto it = firstWithHash.find(hashBytes(newFile.data() + start, length));
+            int tries = 0;
+            for (int i = it == firstWithHash.end() ? -1 : it->second; i >= 0 && tries < MAX_CANDIDATES;
+                 i = nextWithHash[i], tries++) {
+                if (sameRecord(i, start, length)) {
+                    match = i;
+                    break;
+                }
+            }
+        }
+        if (match >= 0) {
+            addOp(ops, true, oldStart(match), length);
+            expected = match + 1;
+        } else {
+            addOp(ops, false, start, length);
+            expected = -1;
+        }
+    }
+}
+
+void DeckDelta::diffBlocks(const vector<char>& oldFile, const vector<char>& newFile, vector<Op>& ops) {
+    const size_t block = BLOCK_SIZE;
+    const unsigned char* oldBytes = reinterpret_cast<const unsigned char*>(oldFile.data());
+    const unsigned char* newBytes = reinterpret_cast<const unsigned char*>(newFile.data());
+    auto hashBlock = [&](const unsigned char* data) {
+        uint64_t hash = 0;
+        for (size_t i = 0; i < block; i++) {
+            hash = hash * ROLL_BASE + data[i];
+        }
+        return hash;
+    };
+
+    // Index the old file's aligned blocks
+    unordered_map<uint64_t, size_t> blockAt;
+    for (size_t offset = 0; offset + block <= oldFile.size(); offset += block) {
+        blockAt.emplace(hashBlock(oldBytes + offset), offset);
+    }
+    uint64_t outgoing = 1;   // ROLL_BASE^(block-1), the weight of the byte leaving the window
+    for (size_t i = 1; i < block; i++) {
+        outgoing *= ROLL_BASE;
+    }
+
+    size_t literalStart = 0;
+    size_t position = 0;
+    bool haveHash = false;
+    uint64_t hash = 0;
+    while (!blockAt.empty() && position + block <= newFile.size()) {
+        if (!haveHash) {
+            hash = hashBlock(newBytes + position);
+            haveHash = true;
+        }
+        auto it = blockAt.find(hash);
+        if (it != blockAt.end() && memcmp(oldBytes + it->second, newBytes + position, block) == 0) {
+            size_t oldOffset = it->second;
+            size_t length = block;
+            while (oldOffset + length < oldFile.size() && position + length < newFile.size()
+                   && oldBytes[oldOffset + length] == newBytes[position + length]) {
+                length++;
+            }
+            // Grow backwards into bytes that were about to be stored as new
+            while (position > literalStart && oldOffset > 0 && oldBytes[oldOffset - 1] == newBytes[position - 1]) {
+                position--;
+                oldOffset--;
+                length++;
+            }
+            addOp(ops, false, literalStart, position - literalStart);
+            addOp(ops, true, oldOffset, length);
+            position += length;
+            literalStart = position;
+            haveHash = false;
+            continue;
+        }
+        if (position + block < newFile.size()) {
+            hash = (hash - newBytes[position] * outgoing) * ROLL_BASE + newBytes[position + block];
+        }
+        position++;
+    }
+    addOp(ops, false, literalStart, newFile.size() - literalStart);
+}
+
+void DeckDelta::addOp(vector<Op>& ops, bool copy, size_t offset, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    // Ranges that continue the previous one of the same kind are merged
+    if (!ops.empty() && ops.back().copy == copy && ops.back().offset + ops.back().length == offset) {
+        ops.back().length += length;
+        return;
+    }
+    ops.push_back({copy, offset, length});
+}
+
+uint64_t DeckDelta::hashBytes(const char* data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 0x100000001B3ULL;
+    }
+    return hash;
+}
@@ -0,0 +1,64 @@
+#ifndef DECKDELTA_H
+#define DECKDELTA_H
+
+#include "CardSerialization.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+struct DeltaStats {
+    int method = 0;              // DeckDelta::Method used
+    size_t oldSize = 0;
+    size_t newSize = 0;
+    size_t deltaSize = 0;
+    long long copies = 0;        // Runs taken from the old file
+    long long inserts = 0;       // Runs stored in the delta
+    size_t insertedBytes = 0;
+    double seconds = 0.0;
+};
+
+// Compact patches between two versions of a deck file. A delta rebuilds the
+// new file from byte ranges of the old one plus new bytes it carries, so
+// applying one never decodes cards. When both files are deck files the ranges
+// are found card by card: each card record of the new file is looked up by
+// the hash of its bytes among the old file's records, and consecutive
+// matches become one range. Other files fall back to rsync-style matching of
+// fixed blocks with a rolling hash. Both ends check whole-file hashes, so a
+// patch applied to the wrong base fails instead of producing a bad deck.
+class DeckDelta {
+public:
+    enum Method : uint8_t {
+        METHOD_CARDS = 1,
+        METHOD_BLOCKS = 2
+    };
+
+    static const size_t BLOCK_SIZE = 64;
+
+    static vector<char> create(const vector<char>& oldFile, const vector<char>& newFile,
+                               DeltaStats* stats = nullptr);
+    static vector<char> apply(const vector<char>& oldFile, const vector<char>& delta);
+
+    // File versions of the above
+    static DeltaStats createFile(const string& oldPath, const string& newPath, const string& deltaPath);
+    static void applyFile(const string& oldPath, const string& deltaPath, const string& outputPath);
+
+    static vector<char> readFile(const string& path);
+    static void writeFile(const string& path, const vector<char>& bytes);
+
+private:
+    struct Op {
+        bool copy;
+        size_t offset;           // Into the old file for copies, the new file for inserts
+        size_t length;
+    };
+
+    // Offsets where the header ends and each card record ends; false if not a deck file
+    static bool splitRecords(const vector<char>& file, vector<size_t>& boundaries);
+    static void diffRecords(const vector<char>& oldFile, const vector<size_t>& oldBounds,
+                            const vector<char>& newFile, const vector<size_t>& newBounds, vector<Op>& ops);
+    static void diffBlocks(const vector<char>& oldFile, const vector<char>& newFile, vector<Op>& ops);
+    static void addOp(vector<Op>& ops, bool copy, size_t offset, size_t length);
+    static uint64_t hashBytes(const char* data, size_t size);
+};
+
+#endif // DECKDELTA_H
@@ -0,0 +1,38 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "DeckDelta.h"
+
+using namespace std;
+
+void printUsage() {
+    cout << "Usage: deck_delta diff OLD NEW DELTA\n"
+         << "       deck_delta patch OLD DELTA OUTPUT\n"
+         << "diff writes the changes that turn OLD into NEW; patch rebuilds NEW from\n"
+         << "OLD and that delta. Deck files are compared card by card, other files by\n"
+         << "64-byte blocks." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc == 5 && string(argv[1]) == "diff") {
+            DeltaStats stats = DeckDelta::createFile(argv[2], argv[3], argv[4]);
+            cout << "Delta: " << stats.deltaSize << " bytes for a " << stats.newSize << "-byte file ("
+                 << (stats.method == DeckDelta::METHOD_CARDS ? "card records" : "byte blocks") << ", "
+                 << stats.copies << " copied runs, " << stats.inserts << " new runs, "
+                 << stats.insertedBytes << " new bytes, " << fixed << setprecision(2)
+                 << stats.seconds * 1000.0 << " ms)" << endl;
+            return 0;
+        }
+        if (argc == 5 && string(argv[1]) == "patch") {
+            DeckDelta::applyFile(argv[2], argv[3], argv[4]);
+            cout << "Wrote " << argv[4] << endl;
+            return 0;
+        }
+        printUsage();
+        return argc == 2 && string(argv[1]) == "--help" ? 0 : 1;
+    } catch (const exception& e) {
+        cerr << "Deck delta error: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,226 @@
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "PlayingCard.h"
+#include "CardSerialization.h"
+#include "DeckProtocol.h"
+
+using namespace std;
+using namespace DeckProtocol;
+
+struct LoadClient {
+    int fd = -1;
+    vector<char> input;
+    vector<char> output;
+    size_t outputSent = 0;
+    int inFlight = 0;
+    bool writing = false;
+};
+
+struct LoadOptions {
+    string socketPath;
+    int clients = 1000;
+    long long requests = 1000000;
+    int pipeline = 8;
+};
+
+static int64_t nowNanos() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int connectTo(const string& path) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw runtime_error("Socket path is too long");
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        string error = strerror(errno);
+        if (fd >= 0) close(fd);
+        throw runtime_error("Cannot connect to " + path + ": " + error);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// Mostly reads, with adds and draws balanced so the deck keeps its size
+static void appendRequest(vector<char>& out, uint32_t id, const vector<char>& encodedCard) {
+    int slot = id % 20;
+    if (slot < 8) {
+        appendFrame(out, id, REQ_QUERY, nullptr, 0);
+    } else if (slot < 14) {
+        int32_t index = id % 16;
+        appendFrame(out, id, REQ_PEEK, &index, sizeof(index));
+    } else if (slot < 17) {
+        appendFrame(out, id, REQ_ADD, encodedCard.data(), encodedCard.size());
+    } else {
+        appendFrame(out, id, REQ_DRAW, nullptr, 0);
+    }
+}
+
+static bool flush(LoadClient& client) {
+    while (client.outputSent < client.output.size()) {
+        ssize_t sent = send(client.fd, client.output.data() + client.outputSent,
+                            client.output.size() - client.outputSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            return errno == EAGAIN || errno == EINTR;
+        }
+        client.outputSent += sent;
+    }
+    client.output.clear();
+    client.outputSent = 0;
+    return true;
+}
+
+static double percentile(const vector<int64_t>& sorted, double fraction) {
+    size_t index = min(sorted.size() - 1, static_cast<size_t>(fraction * sorted.size()));
+    return sorted[index] / 1000.0;
+}
+
+void printUsage() {
+    cout << "Usage: deck_loadgen --socket PATH [--clients N] [--requests N] [--pipeline N]\n"
+         << "Opens N client connections (default 1000) to a deck_server and keeps up to\n"
+         << "--pipeline requests (default 8) in flight on each until --requests (default\n"
+         << "1000000) have been answered, then reports throughput and latency percentiles." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    LoadOptions options;
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--socket" && hasValue) {
+                options.socketPath = argv[++i];
+            } else if (arg == "--clients" && hasValue) {
+                options.clients = stoi(argv[++i]);
+            } else if (arg == "--requests" && hasValue) {
+                options.requests = stoll(argv[++i]);
+            } else if (arg == "--pipeline" && hasValue) {
+                options.pipeline = stoi(argv[++i]);
+            } else {
+                printUsage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+        if (options.socketPath.empty() || options.clients < 1 || options.pipeline < 1 || options.requests < 1
+            || options.requests > UINT32_MAX) {
+            printUsage();
+            return 1;
+        }
+
+        PlayingCard card("Load Card", 7, "Clubs", false);
+        ByteWriter encoded;
+        CardTypeRegistry::instance().encode(card, encoded);
+        vector<char> encodedCard(encoded.data(), encoded.data() + encoded.size());
+
+        int epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) {
+            throw runtime_error("Cannot create epoll instance");
+        }
+        vector<LoadClient> clients(options.clients);
+        for (int c = 0; c < options.clients; c++) {
+            clients[c].fd = connectTo(options.socketPath);
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u32 = c;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, clients[c].fd, &event);
+        }
+
+        vector<int64_t> sentAt(options.requests);
+        vector<int64_t> latencies;
+        latencies.reserve(options.requests);
+        long long issued = 0, answered = 0, errors = 0;
+        auto issue = [&](LoadClient& client) {
+            while (client.inFlight < options.pipeline && issued < options.requests) {
+                uint32_t id = static_cast<uint32_t>(issued++);
+                sentAt[id] = nowNanos();
+                appendRequest(client.output, id, encodedCard);
+                client.inFlight++;
+            }
+        };
+
+        int64_t start = nowNanos();
+        for (auto& client : clients) {
+            issue(client);
+            if (!flush(client)) throw runtime_error("Connection failed while sending");
+        }
+
+        vector<epoll_event> events(256);
+        vector<char> chunk(64 * 1024);
+        while (answered < options.requests) {
+            int ready = epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 10000);
+            if (ready == 0) {
+                throw runtime_error("Server stopped answering");
+            }
+            for (int i = 0; i < ready; i++) {
+                LoadClient& client = clients[events[i].data.u32];
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    throw runtime_error("Server closed a connection");
+                }
+                if (events[i].events & EPOLLIN) {
+                    ssize_t received = recv(client.fd, chunk.data(), chunk.size(), 0);
+                    if (received == 0) throw runtime_error("Server closed a connection");
+                    if (received > 0) {
+                        client.input.insert(client.input.end(), chunk.data(), chunk.data() + received);
+                        int64_t now = nowNanos();
+                        size_t offset = 0;
+                        Frame reply;
+                        while (size_t used = parseFrame(client.input.data() + offset, client.input.size() - offset, reply)) {
+                            latencies.push_back(now - sentAt[reply.id]);
+                            errors += reply.code != STATUS_OK;
+                            client.inFlight--;
+                            answered++;
+                            offset += used;
+                        }
+                        client.input.erase(client.input.begin(), client.input.begin() + offset);
+                        issue(client);
+                    }
+                }
+                if (!flush(client)) throw runtime_error("Connection failed while sending");
+                bool pending = client.outputSent < client.output.size();
+                if (pending != client.writing) {
+                    epoll_event event = {};
+                    event.events = EPOLLIN;
+                    if (pending) event.events |= EPOLLOUT;
+                    event.data.u32 = events[i].data.u32;
+                    epoll_ctl(epollFd, EPOLL_CTL_MOD, client.fd, &event);
+                    client.writing = pending;
+                }
+            }
+        }
+        double seconds = (nowNanos() - start) / 1e9;
+
+        for (auto& client : clients) {
+            close(client.fd);
+        }
+        close(epollFd);
+
+        sort(latencies.begin(), latencies.end());
+        cout << fixed << setprecision(1);
+        cout << options.requests << " requests over " << options.clients << " connections, pipeline depth "
+             << options.pipeline << endl;
+        cout << "Throughput: " << options.requests / seconds << " requests/sec (" << setprecision(3)
+             << seconds << " s)" << endl;
+        cout << setprecision(1) << "Latency us: p50 " << percentile(latencies, 0.50)
+             << ", p90 " << percentile(latencies, 0.90) << ", p99 " << percentile(latencies, 0.99)
+             << ", p99.9 " << percentile(latencies, 0.999) << ", max " << latencies.back() / 1000.0 << endl;
+        cout << "Error responses: " << errors << endl;
+    } catch (const exception& e) {
+        cerr << "Load generator error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "DeckProtocol.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace DeckProtocol {
+    void appendFrame(vector<char>& out, uint32_t id, uint8_t code, const void* payload, size_t size) {
+        if (size > MAX_FRAME - (HEADER_SIZE - sizeof(uint32_t))) {
+            throw runtime_error("Frame payload is too large");
+        }
+        uint32_t length = static_cast<uint32_t>(HEADER_SIZE - sizeof(uint32_t) + size);
+        size_t start = out.size();
+        out.resize(start + HEADER_SIZE + size);
+        char* frame = out.data() + start;
+        memcpy(frame, &length, sizeof(length));
+        memcpy(frame + 4, &id, sizeof(id));
+        frame[8] = static_cast<char>(code);
+        if (size > 0) {
+            memcpy(frame + HEADER_SIZE, payload, size);
+        }
+    }
+
+    size_t parseFrame(const char* data, size_t size, Frame& frame) {
+        if (size < sizeof(uint32_t)) {
+            return 0;
+        }
+        uint32_t length;
+        memcpy(&length, data, sizeof(length));
+        if (length < HEADER_SIZE - sizeof(uint32_t) || length > MAX_FRAME) {
+            throw runtime_error("Invalid frame length " + to_string(length));
+        }
+        if (size < sizeof(uint32_t) + length) {
+            return 0;
+        }
+        memcpy(&frame.id, data + 4, sizeof(frame.id));
+        frame.code = static_cast<uint8_t>(data[8]);
+        frame.payload = data + HEADER_SIZE;
+        frame.payloadSize = length - (HEADER_SIZE - sizeof(uint32_t));
+        return sizeof(uint32_t) + length;
+    }
+
+    const char* requestName(uint8_t code) {
+        switch (code) {
+            case REQ_ADD: return "add";
+            case REQ_DRAW: return "draw";
+            case REQ_SHUFFLE: return "shuffle";
+            case REQ_QUERY: return "query";
+            case REQ_PEEK: return "peek";
+            case REQ_STATS: return "stats";
+            case REQ_SAVE: return "save";
+        }
+        return "unknown";
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef DECKPROTOCOL_H
+#define DECKPROTOCOL_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Wire format shared by the deck server and its clients. Requests and
+// responses are frames laid out as
+//   uint32 length   bytes after this field (id, code and payload)
+//   uint32 id       chosen by the client and echoed in the response
+//   uint8  code     Request in requests, Status in responses
+//   payload
+// in host byte order, since both ends are on the same machine. A client may
+// send many frames without waiting; responses come back in request order.
+namespace DeckProtocol {
+    const size_t HEADER_SIZE = 9;
+    const uint32_t MAX_FRAME = 1 << 20;   // Longer frames close the connection
+
+    enum Request : uint8_t {
+        REQ_ADD = 1,     // Typed card encoding -> nothing
+        REQ_DRAW,        // Nothing -> typed card encoding of the top card
+        REQ_SHUFFLE,     // Optional uint64 seed -> nothing
+        REQ_QUERY,       // Nothing -> int32 size, int32 max size, int64 total value, uint64 generation
+        REQ_PEEK,        // int32 index -> typed card encoding
+        REQ_STATS,       // Nothing -> ServerCounters
+        REQ_SAVE         // File name, no directories -> nothing
+    };
+
+    enum Status : uint8_t {
+        STATUS_OK = 0,
+        STATUS_ERROR = 1   // Payload is the error message
+    };
+
+    struct ServerCounters {
+        uint64_t connectionsAccepted = 0;
+        uint64_t activeConnections = 0;
+        uint64_t requests = 0;
+        uint64_t errors = 0;
+        uint64_t bytesIn = 0;
+        uint64_t bytesOut = 0;
+    };
+
+    struct Frame {
+        uint32_t id = 0;
+        uint8_t code = 0;
+        const char* payload = nullptr;   // Points into the buffer that was parsed
+        size_t payloadSize = 0;
+    };
+
+    void appendFrame(vector<char>& out, uint32_t id, uint8_t code, const void* payload, size_t size);
+
+    // Bytes taken by the first frame in data, or 0 if it has not fully arrived.
+    // Throws if the frame is malformed or longer than MAX_FRAME.
+    size_t parseFrame(const char* data, size_t size, Frame& frame);
+
+    const char* requestName(uint8_t code);
+}
+
+#endif // DECKPROTOCOL_H
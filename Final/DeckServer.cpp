@@ -0,0 +1,309 @@
+#include "DeckServer.h"
+#include "CardSerialization.h"
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace DeckProtocol;
+
+// Bytes read per call; large enough to take many pipelined requests at once
+static const size_t READ_CHUNK = 64 * 1024;
+static const int MAX_EVENTS = 256;
+
+static runtime_error systemError(const string& what) {
+    return runtime_error(what + ": " + strerror(errno));
+}
+
+// Constructor
+DeckServer::DeckServer(Deck& servedDeck, const string& path, const string& saveDir)
+    : deck(servedDeck), socketPath(path), saveDirectory(saveDir), listenFd(-1), epollFd(-1), wakeFd(-1),
+      acceptPaused(false), readBuffer(READ_CHUNK) {
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw runtime_error("Socket path must be between 1 and " + to_string(sizeof(address.sun_path) - 1)
+                            + " characters");
+    }
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    // Replace a socket left behind by an earlier server, but never any other file
+    struct stat existing;
+    if (lstat(path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            throw runtime_error(path + " exists and is not a socket");
+        }
+        unlink(path.c_str());
+    }
+
+    try {
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) throw systemError("Cannot create socket");
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            throw systemError("Cannot bind " + path);
+        }
+        if (listen(listenFd, SOMAXCONN) < 0) throw systemError("Cannot listen on " + path);
+
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) throw systemError("Cannot create epoll instance");
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeFd < 0) throw systemError("Cannot create eventfd");
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = listenFd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event) < 0) throw systemError("Cannot watch socket");
+        event.data.fd = wakeFd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) < 0) throw systemError("Cannot watch eventfd");
+    } catch (...) {
+        if (wakeFd >= 0) close(wakeFd);
+        if (epollFd >= 0) close(epollFd);
+        if (listenFd >= 0) {
+            close(listenFd);
+            unlink(path.c_str());
+        }
+        throw;
+    }
+}
+
+// Destructor
+DeckServer::~DeckServer() {
+    for (auto& entry : connections) {
+        close(entry.first);
+    }
+    close(wakeFd);
+    close(epollFd);
+    close(listenFd);
+    unlink(socketPath.c_str());
+}
+
+// Core functionality implementations
+void DeckServer::run() {
+    epoll_event events[MAX_EVENTS];
+    while (true) {
+        int ready = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("epoll_wait failed");
+        }
+        for (int i = 0; i < ready; i++) {
+            int fd = events[i].data.fd;
+            if (fd == wakeFd) {
+                uint64_t value;
+                ssize_t drained = read(wakeFd, &value, sizeof(value));
+                (void)drained;
+                return;
+            }
+            if (fd == listenFd) {
+                acceptClients();
+                continue;
+            }
+            auto it = connections.find(fd);
+            if (it == connections.end()) {
+                continue;   // Closed earlier in this batch
+            }
+            Connection& connection = *it->second;
+            // A hang-up means replies can no longer be delivered
+            bool open = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (open && (events[i].events & EPOLLIN)) open = readFrom(connection);
+            if (open && (events[i].events & EPOLLOUT)) open = writeTo(connection);
+            if (open) {
+                updateInterest(connection);
+            } else {
+                closeConnection(fd);
+            }
+        }
+    }
+}
+
+void DeckServer::stop() {
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+const ServerCounters& DeckServer::getCounters() const {
+    return counters;
+}
+
+string DeckServer::getSocketPath() const {
+    return socketPath;
+}
+
+// Private helper implementations
+void DeckServer::acceptClients() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE) {
+                // The listener is level-triggered, so leaving it watched would wake
+                // epoll_wait at once, forever. Park the backlog until a client leaves.
+                watchListener(false);
+            }
+            return;     // EAGAIN: the backlog is empty
+        }
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            close(fd);
+            continue;
+        }
+        unique_ptr<Connection> connection(new Connection());
+        connection->fd = fd;
+        connections[fd] = move(connection);
+        counters.connectionsAccepted++;
+        counters.activeConnections++;
+    }
+}
+
+bool DeckServer::readFrom(Connection& connection) {
+    ssize_t received = recv(connection.fd, readBuffer.data(), readBuffer.size(), 0);
+    if (received <= 0) {
+        return received < 0 && (errno == EAGAIN || errno == EINTR);
+    }
+    counters.bytesIn += received;
+
+    // Parse straight from the shared buffer unless part of a request is already waiting
+    const char* data = readBuffer.data();
+    size_t length = static_cast<size_t>(received);
+    bool buffered = !connection.input.empty();
+    if (buffered) {
+        connection.input.insert(connection.input.end(), data, data + length);
+        data = connection.input.data();
+        length = connection.input.size();
+    }
+
+    // Answer every complete request, then send the replies together
+    size_t offset = 0;
+    try {
+        Frame request;
+        while (size_t used = parseFrame(data + offset, length - offset, request)) {
+            handle(request, connection.output);
+            offset += used;
+        }
+    } catch (const runtime_error&) {
+        return false;   // Malformed framing; the stream cannot be resynchronized
+    }
+    if (buffered) {
+        connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    } else {
+        connection.input.assign(data + offset, data + length);
+    }
+    return writeTo(connection);
+}
+
+bool DeckServer::writeTo(Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.outputSent,
+                            connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            return errno == EAGAIN || errno == EINTR;
+        }
+        connection.outputSent += sent;
+        counters.bytesOut += sent;
+    }
+    connection.output.clear();
+    connection.outputSent = 0;
+    return true;
+}
+
+void DeckServer::handle(const Frame& request, vector<char>& reply) {
+    counters.requests++;
+    ByteWriter body;
+    try {
+        ByteReader in(request.payload, request.payloadSize);
+        switch (request.code) {
+            case REQ_ADD: {
+                unique_ptr<Card> card(CardTypeRegistry::instance().decode(in));
+                deck.addCard(card.get());
+                card.release();
+                break;
+            }
+            case REQ_DRAW: {
+                unique_ptr<Card> card(deck.drawCard());
+                CardTypeRegistry::instance().encode(*card, body);
+                break;
+            }
+            case REQ_SHUFFLE:
+                if (in.remaining() >= sizeof(uint64_t)) {
+                    deck.shuffle(in.read<uint64_t>());
+                } else {
+                    deck.shuffle();
+                }
+                break;
+            case REQ_QUERY:
+                body.write<int32_t>(deck.getCurrentSize());
+                body.write<int32_t>(deck.getMaxSize());
+                body.write<int64_t>(deck.getTotalValue());
+                body.write<uint64_t>(deck.getGeneration());
+                break;
+            case REQ_PEEK:
+                CardTypeRegistry::instance().encode(*deck.getCard(in.read<int32_t>()), body);
+                break;
+            case REQ_STATS:
+                body.write(counters);
+                break;
+            case REQ_SAVE: {
+                string name(request.payload, request.payloadSize);
+                if (name.empty() || name.find('/') != string::npos || name == "." || name == "..") {
+                    throw runtime_error("Save name must be a plain file name");
+                }
+                fs::create_directories(saveDirectory);
+                deck.saveToBinary((fs::path(saveDirectory) / name).string());
+                break;
+            }
+            default:
+                throw runtime_error("Unknown request " + to_string(request.code));
+        }
+    } catch (const exception& e) {
+        counters.errors++;
+        string message = e.what();
+        appendFrame(reply, request.id, STATUS_ERROR, message.data(), message.size());
+        return;
+    }
+    appendFrame(reply, request.id, STATUS_OK, body.data(), body.size());
+}
+
+void DeckServer::updateInterest(Connection& connection) {
+    bool pending = connection.outputSent < connection.output.size();
+    bool wantRead = connection.output.size() - connection.outputSent < MAX_PENDING_OUTPUT;
+    if (pending == connection.writing && wantRead == connection.reading) {
+        return;
+    }
+    epoll_event event = {};
+    if (wantRead) event.events |= EPOLLIN;
+    if (pending) event.events |= EPOLLOUT;
+    event.data.fd = connection.fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.writing = pending;
+    connection.reading = wantRead;
+}
+
+void DeckServer::closeConnection(int fd) {
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+    counters.activeConnections--;
+    if (acceptPaused) {
+        watchListener(true);    // A descriptor is free again
+    }
+}
+
+void DeckServer::watchListener(bool watch) {
+    epoll_event event = {};
+    if (watch) event.events |= EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, listenFd, &event);
+    acceptPaused = !watch;
+}
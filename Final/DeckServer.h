@@ -0,0 +1,67 @@
+#ifndef DECKSERVER_H
+#define DECKSERVER_H
+
+#include "Deck.h"
+#include "DeckProtocol.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Serves one deck to local clients over a Unix domain socket (Linux only).
+// A single thread runs an epoll loop over non-blocking sockets, so deck
+// operations never need a lock. Every complete request in a read is handled
+// before replying, and all of the replies go out in one write, so pipelined
+// clients cost one system call per batch rather than per request. A client
+// that stops reading its replies is not read from again until it catches up.
+class DeckServer {
+private:
+    static const size_t MAX_PENDING_OUTPUT = 4 << 20;
+
+    struct Connection {
+        int fd;
+        vector<char> input;
+        vector<char> output;
+        size_t outputSent = 0;
+        bool reading = true;     // EPOLLIN is registered
+        bool writing = false;    // EPOLLOUT is registered
+    };
+
+    Deck& deck;
+    string socketPath;
+    string saveDirectory;
+    int listenFd;
+    int epollFd;
+    int wakeFd;
+    bool acceptPaused;           // Out of descriptors; listenFd is unwatched until a connection closes
+    unordered_map<int, unique_ptr<Connection>> connections;
+    vector<char> readBuffer;     // Every recv lands here; only unfinished requests are copied out
+    DeckProtocol::ServerCounters counters;
+
+public:
+    // Constructor; listens on socketPath straight away
+    DeckServer(Deck& servedDeck, const string& path, const string& saveDir = "./saves/");
+
+    // Destructor; closes every connection and removes the socket file
+    ~DeckServer();
+
+    DeckServer(const DeckServer&) = delete;
+    DeckServer& operator=(const DeckServer&) = delete;
+
+    void run();    // Serves until stop() is called
+    void stop();   // Safe from signal handlers and other threads
+
+    const DeckProtocol::ServerCounters& getCounters() const;  // Only while run() is not running
+    string getSocketPath() const;
+
+private:
+    void acceptClients();
+    void watchListener(bool watch);
+    bool readFrom(Connection& connection);    // False once the connection should close
+    bool writeTo(Connection& connection);
+    void handle(const DeckProtocol::Frame& request, vector<char>& reply);
+    void updateInterest(Connection& connection);
+    void closeConnection(int fd);
+};
+
+#endif // DECKSERVER_H
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <csignal>
+#include <string>
+#include "PlayingCard.h"
+#include "Deck.h"
+#include "DeckServer.h"
+
+using namespace std;
+
+static DeckServer* runningServer = nullptr;
+
+void handleSignal(int) {
+    if (runningServer) {
+        runningServer->stop();
+    }
+}
+
+void printUsage() {
+    cout << "Usage: deck_server --socket PATH [--max-size N] [--cards N] [--load FILE] [--saves DIR]\n"
+         << "Serves one deck over a Unix domain socket until interrupted. The deck starts\n"
+         << "with N generated playing cards (default 52), or the cards of a saved .dat file.\n"
+         << "Save requests write into DIR (default ./saves/)." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string socketPath, loadFile, saveDirectory = "./saves/";
+    int maxSize = 100000;
+    int cardCount = 52;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--socket" && hasValue) {
+                socketPath = argv[++i];
+            } else if (arg == "--max-size" && hasValue) {
+                maxSize = stoi(argv[++i]);
+            } else if (arg == "--cards" && hasValue) {
+                cardCount = stoi(argv[++i]);
+            } else if (arg == "--load" && hasValue) {
+                loadFile = argv[++i];
+            } else if (arg == "--saves" && hasValue) {
+                saveDirectory = argv[++i];
+            } else {
+                printUsage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+        if (socketPath.empty()) {
+            printUsage();
+            return 1;
+        }
+
+        Deck deck(maxSize, "Served Deck", "Server");
+        if (loadFile.empty()) {
+            const string suits[] = {"Hearts", "Diamonds", "Clubs", "Spades"};
+            for (int i = 0; i < cardCount; i++) {
+                int rank = i % 13;
+                deck.addCard(new PlayingCard("Card " + to_string(i), rank + 2, suits[(i / 13) % 4], rank >= 9 && rank <= 11));
+            }
+        } else {
+            deck.loadFromBinary(loadFile);
+        }
+
+        DeckServer server(deck, socketPath, saveDirectory);
+        runningServer = &server;
+        signal(SIGINT, handleSignal);
+        signal(SIGTERM, handleSignal);
+        cout << "Serving " << deck.getCurrentSize() << " cards on " << socketPath << endl;
+        server.run();
+        runningServer = nullptr;
+
+        const DeckProtocol::ServerCounters& counters = server.getCounters();
+        cout << "Served " << counters.requests << " requests (" << counters.errors << " errors) over "
+             << counters.connectionsAccepted << " connections" << endl;
+    } catch (const exception& e) {
+        cerr << "Server error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,333 @@
+#include "DeckSorter.h"
+#include "PlayingCard.h"
+#include "GameCard.h"
+#include "CardTraits.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <numeric>
+#include <typeinfo>
+
+// Stand-ins for missing attributes, one past the largest valid value
+static const uint64_t NO_SUIT = 4;
+static const uint64_t NO_CONDITION = 11;
+static const uint64_t NO_RARITY = 11;
+
+static const long long PREFETCH_DISTANCE = 32;
+
+// Bits each key takes in a packed word
+static int keyWidth(DeckSortKey key) {
+    switch (key) {
+        case SORT_BY_SUIT: return 3;
+        case SORT_BY_RARITY: return 4;
+        case SORT_BY_CONDITION: return 4;
+        default: return 32;
+    }
+}
+
+// Bits needed to hold every value in [0, range]
+static int bitsFor(uint64_t range) {
+    int bits = 0;
+    while (bits < 64 && (range >> bits) != 0) {
+        bits++;
+    }
+    return bits;
+}
+
+// Starts loading the first two cache lines of a card, which hold its vtable
+// pointer, value and the attributes sorted on
+static inline void prefetchCard(const Card* card) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(card);
+    __builtin_prefetch(reinterpret_cast<const char*>(card) + 64);
+#else
+    (void)card;
+#endif
+}
+
+// Stable LSD radix sort of keys, moving payload along with them. Only the low
+// bits are compared. Work is split into fixed blocks rather than per-worker
+// slices, so every block scatters to the same place whichever worker runs it.
+template<typename Payload>
+static void radixSort(vector<uint64_t>& keys, vector<Payload>& payload, int bits, WorkStealingPool& pool) {
+    const size_t buckets = size_t(1) << DeckSorter::RADIX_BITS;
+    const uint64_t mask = buckets - 1;
+    size_t n = keys.size();
+    if (n < 2 || bits == 0) {
+        return;
+    }
+
+    int threads = pool.getThreadCount();
+    size_t blockCount = threads > 1 ? static_cast<size_t>(threads) * 4 : 1;
+    size_t blockSize = (n + blockCount - 1) / blockCount;
+    blockCount = (n + blockSize - 1) / blockSize;
+
+    vector<uint64_t> keysOut(n);
+    vector<Payload> payloadOut(n);
+    vector<size_t> offsets(blockCount * buckets);
+    int passes = (bits + DeckSorter::RADIX_BITS - 1) / DeckSorter::RADIX_BITS;
+
+    // A pass only reorders keys, so with a single block the digit counts of
+    // every pass come from one read of the keys. With several blocks the keys
+    // each block holds change between passes, so blocks count once per pass.
+    vector<size_t> serialCounts;
+    if (blockCount == 1) {
+        serialCounts.assign(passes * buckets, 0);
+        for (size_t i = 0; i < n; i++) {
+            for (int pass = 0; pass < passes; pass++) {
+                serialCounts[pass * buckets + ((keys[i] >> (pass * DeckSorter::RADIX_BITS)) & mask)]++;
+            }
+        }
+    }
+
+    for (int pass = 0; pass < passes; pass++) {
+        int shift = pass * DeckSorter::RADIX_BITS;
+        if (blockCount == 1) {
+            copy(serialCounts.begin() + pass * buckets, serialCounts.begin() + (pass + 1) * buckets,
+                 offsets.begin());
+        } else {
+            fill(offsets.begin(), offsets.end(), 0);
+            pool.parallelFor(static_cast<long long>(blockCount), 1, [&](int, long long begin, long long end) {
+                for (long long block = begin; block < end; block++) {
+                    size_t* count = &offsets[block * buckets];
+                    size_t stop = min(n, static_cast<size_t>(block + 1) * blockSize);
+                    for (size_t i = static_cast<size_t>(block) * blockSize; i < stop; i++) {
+                        count[(keys[i] >> shift) & mask]++;
+                    }
+                }
+            });
+        }
+
+        // Turn counts into each block's starting position per digit
+        size_t position = 0;
+        for (size_t digit = 0; digit < buckets; digit++) {
+            for (size_t block = 0; block < blockCount; block++) {
+                size_t count = offsets[block * buckets + digit];
+                offsets[block * buckets + digit] = position;
+                position += count;
+            }
+        }
+
+        pool.parallelFor(static_cast<long long>(blockCount), 1, [&](int, long long begin, long long end) {
+            for (long long block = begin; block < end; block++) {
+                size_t* next = &offsets[block * buckets];
+                size_t stop = min(n, static_cast<size_t>(block + 1) * blockSize);
+                for (size_t i = static_cast<size_t>(block) * blockSize; i < stop; i++) {
+                    size_t target = next[(keys[i] >> shift) & mask]++;
+                    keysOut[target] = keys[i];
+                    payloadOut[target] = payload[i];
+                }
+            }
+        });
+        keys.swap(keysOut);
+        payload.swap(payloadOut);
+    }
+}
+
+// Core functionality implementations
+void DeckSorter::sort(vector<Card*>& cards, const vector<DeckSortKey>& keys, int threads) {
+    PackedKeys packed = packKeys(cards, keys, threads);
+    WorkStealingPool& pool = WorkStealingPool::shared(cards.size() < PARALLEL_THRESHOLD ? 1 : threads);
+    if (packed.words.size() == 1) {
+        // One word: sort the card pointers directly, with no permutation to apply
+        radixSort(packed.words[0], cards, packed.bits[0], pool);
+        return;
+    }
+    // Several words: sort positions by the keys already packed, then gather
+    vector<uint32_t> order = orderFromKeys(packed, cards.size(), pool);
+    vector<Card*> sorted(cards.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        sorted[i] = cards[order[i]];
+    }
+    cards.swap(sorted);
+}
+
+vector<uint32_t> DeckSorter::sortedOrder(const vector<Card*>& cards, const vector<DeckSortKey>& keys,
+                                         int threads) {
+    PackedKeys packed = packKeys(cards, keys, threads);
+    WorkStealingPool& pool = WorkStealingPool::shared(cards.size() < PARALLEL_THRESHOLD ? 1 : threads);
+    return orderFromKeys(packed, cards.size(), pool);
+}
+
+const char* DeckSorter::keyName(DeckSortKey key) {
+    switch (key) {
+        case SORT_BY_VALUE: return "value";
+        case SORT_BY_SUIT: return "suit";
+        case SORT_BY_RARITY: return "rarity";
+        case SORT_BY_CONDITION: return "condition";
+        case SORT_BY_NAME: return "name";
+    }
+    return "unknown";
+}
+
+// Private helper implementations
+vector<uint32_t> DeckSorter::orderFromKeys(PackedKeys& packed, size_t count, WorkStealingPool& pool) {
+    vector<uint32_t> order(count);
+    iota(order.begin(), order.end(), 0u);
+
+    // Sort by each word in turn, least significant first. Each pass is stable,
+    // so the words already sorted break ties.
+    bool first = true;
+    for (size_t w = 0; w < packed.words.size(); w++) {
+        if (packed.bits[w] == 0) {
+            continue;   // Every card ties on this word
+        }
+        vector<uint64_t> word;
+        if (first) {
+            word.swap(packed.words[w]);
+        } else {
+            word.resize(order.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                word[i] = packed.words[w][order[i]];
+            }
+        }
+        radixSort(word, order, packed.bits[w], pool);
+        first = false;
+    }
+    return order;
+}
+
+DeckSorter::PackedKeys DeckSorter::packKeys(const vector<Card*>& cards, const vector<DeckSortKey>& keys,
+                                            int threads) {
+    if (keys.empty()) {
+        throw runtime_error("At least one sort key is required");
+    }
+    if (threads < 0) {
+        throw runtime_error("Thread count cannot be negative");
+    }
+    if (cards.size() > UINT32_MAX) {
+        throw runtime_error("Deck is too large to sort");
+    }
+    size_t n = cards.size();
+    WorkStealingPool& pool = WorkStealingPool::shared(n < PARALLEL_THRESHOLD ? 1 : threads);
+
+    // Group keys into words from the least significant end; wordOf[k] is the
+    // word holding key k, which sits above the keys after it in that word
+    vector<int> wordOf(keys.size());
+    int wordCount = 1;
+    int used = 0;
+    for (int k = static_cast<int>(keys.size()) - 1; k >= 0; k--) {
+        if (used + keyWidth(keys[k]) > 64) {
+            wordCount++;
+            used = 0;
+        }
+        used += keyWidth(keys[k]);
+        wordOf[k] = wordCount - 1;
+    }
+
+    vector<uint32_t> names;
+    bool needsPlaying = false;
+    for (DeckSortKey key : keys) {
+        if (key == SORT_BY_NAME && names.empty()) {
+            names = nameRanks(cards);
+        }
+        needsPlaying = needsPlaying || (key != SORT_BY_VALUE && key != SORT_BY_NAME);
+    }
+
+    PackedKeys packed;
+    packed.words.resize(wordCount);
+    for (auto& word : packed.words) {
+        word.resize(n);
+    }
+    int workers = pool.getThreadCount();
+    vector<uint64_t> lowest(workers * wordCount, UINT64_MAX);
+    vector<uint64_t> highest(workers * wordCount, 0);
+
+    // Read every key from each card in one pass over the cards
+    pool.parallelFor(static_cast<long long>(n), 4096, [&](int worker, long long begin, long long end) {
+        // Remember which card classes are playing or game cards instead of
+        // casting every card
+        vector<pair<const type_info*, CardKind>> knownTypes;
+        uint64_t word[64];
+        for (long long i = begin; i < end; i++) {
+            // Cards are scattered over the heap once a deck has been shuffled;
+            // fetching ahead overlaps the cache misses
+            if (i + PREFETCH_DISTANCE < end) {
+                prefetchCard(cards[i + PREFETCH_DISTANCE]);
+            }
+            const Card* card = cards[i];
+            CardKind kind = KIND_OTHER;
+            if (needsPlaying) {
+                const type_info* type = &typeid(*card);
+                auto known = find_if(knownTypes.begin(), knownTypes.end(),
+                                     [type](const pair<const type_info*, CardKind>& entry) { return entry.first == type; });
+                if (known == knownTypes.end()) {
+                    kind = dynamic_cast<const GameCard*>(card) ? KIND_GAME
+                         : dynamic_cast<const PlayingCard*>(card) ? KIND_PLAYING : KIND_OTHER;
+                    knownTypes.push_back({type, kind});
+                } else {
+                    kind = known->second;
+                }
+            }
+            const PlayingCard* playing = kind != KIND_OTHER ? static_cast<const PlayingCard*>(card) : nullptr;
+
+            fill(word, word + wordCount, 0);
+            for (size_t k = 0; k < keys.size(); k++) {
+                uint64_t field = 0;
+                switch (keys[k]) {
+                    case SORT_BY_VALUE:
+                        // Flipping the sign bit keeps signed order in unsigned keys
+                        field = static_cast<uint32_t>(card->getValue()) ^ 0x80000000u;
+                        break;
+                    case SORT_BY_SUIT: {
+                        int suit = playing ? CardTraits::suitIndex(playing->getSuit()) : -1;
+                        field = suit >= 0 ? static_cast<uint64_t>(suit) : NO_SUIT;   // Suits may be left blank
+                        break;
+                    }
+                    case SORT_BY_CONDITION:
+                        field = playing ? static_cast<uint64_t>(playing->getCondition()) : NO_CONDITION;
+                        break;
+                    case SORT_BY_RARITY:
+                        field = kind == KIND_GAME ? static_cast<uint64_t>(static_cast<const GameCard*>(card)->getRarity())
+                                                  : NO_RARITY;
+                        break;
+                    case SORT_BY_NAME:
+                        field = names[i];
+                        break;
+                }
+                uint64_t& target = word[wordOf[k]];
+                target = (target << keyWidth(keys[k])) | field;
+            }
+            for (int w = 0; w < wordCount; w++) {
+                packed.words[w][i] = word[w];
+                lowest[worker * wordCount + w] = min(lowest[worker * wordCount + w], word[w]);
+                highest[worker * wordCount + w] = max(highest[worker * wordCount + w], word[w]);
+            }
+        }
+    });
+
+    // Every key lies between the smallest and largest, so bits above their
+    // highest difference are shared by all cards and need no radix pass
+    packed.bits.assign(wordCount, 0);
+    for (int w = 0; w < wordCount; w++) {
+        uint64_t low = UINT64_MAX;
+        uint64_t high = 0;
+        for (int worker = 0; worker < workers; worker++) {
+            low = min(low, lowest[worker * wordCount + w]);
+            high = max(high, highest[worker * wordCount + w]);
+        }
+        packed.bits[w] = n > 0 ? bitsFor(low ^ high) : 0;
+    }
+    return packed;
+}
+
+vector<uint32_t> DeckSorter::nameRanks(const vector<Card*>& cards) {
+    // Names are the one key that needs string compares: sort positions by name
+    // once, then hand out dense ranks so equal names share one
+    vector<string> names(cards.size());
+    for (size_t i = 0; i < cards.size(); i++) {
+        names[i] = cards[i]->getName();
+    }
+    vector<uint32_t> byName(cards.size());
+    iota(byName.begin(), byName.end(), 0u);
+    std::sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+
+    vector<uint32_t> ranks(cards.size());
+    uint32_t rank = 0;
+    for (size_t i = 0; i < byName.size(); i++) {
+        if (i > 0 && names[byName[i]] != names[byName[i - 1]]) {
+            rank++;
+        }
+        ranks[byName[i]] = rank;
+    }
+    return ranks;
+}
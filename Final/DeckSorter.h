@@ -0,0 +1,52 @@
+#ifndef DECKSORTER_H
+#define DECKSORTER_H
+
+#include "Card.h"
+#include <vector>
+#include <cstdint>
+
+class WorkStealingPool;
+
+// Attributes a deck can be sorted by. Cards without an attribute (no suit,
+// rarity or condition) sort after the cards that have it.
+enum DeckSortKey {
+    SORT_BY_VALUE,
+    SORT_BY_SUIT,        // Hearts, Diamonds, Clubs, Spades
+    SORT_BY_RARITY,
+    SORT_BY_CONDITION,
+    SORT_BY_NAME
+};
+
+// Stable multi-key sort for decks. Each card is read once and its keys packed
+// into 64-bit words (names first become dense ranks from one comparison sort),
+// then the words are LSD radix sorted, skipping the high bits every card
+// shares. Large decks split the key reads, histograms and scatters across a
+// WorkStealingPool; the result is the same for any thread count.
+class DeckSorter {
+public:
+    static const int RADIX_BITS = 8;
+    static const size_t PARALLEL_THRESHOLD = 1 << 16;   // Smaller decks sort on the calling thread
+
+    // Sorts cards in place, most significant key first; position 0 ends up
+    // with the smallest card. Zero threads means one per core.
+    static void sort(vector<Card*>& cards, const vector<DeckSortKey>& keys, int threads = 0);
+
+    // Positions of the cards in sorted order, leaving cards untouched
+    static vector<uint32_t> sortedOrder(const vector<Card*>& cards, const vector<DeckSortKey>& keys,
+                                        int threads = 0);
+
+    static const char* keyName(DeckSortKey key);
+
+private:
+    // Keys packed into words, least significant word first
+    struct PackedKeys {
+        vector<vector<uint64_t>> words;
+        vector<int> bits;                // Low bits that differ between cards, per word
+    };
+
+    static PackedKeys packKeys(const vector<Card*>& cards, const vector<DeckSortKey>& keys, int threads);
+    static vector<uint32_t> orderFromKeys(PackedKeys& packed, size_t count, WorkStealingPool& pool);  // Consumes packed
+    static vector<uint32_t> nameRanks(const vector<Card*>& cards);
+};
+
+#endif // DECKSORTER_H
@@ -0,0 +1,492 @@
+#include "DeckStore.h"
+#include "CardSerialization.h"
+#include "SplitMix64.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace fs = std::filesystem;
+
+const char* const DeckStore::REFERENCE_EXTENSION = ".cgref";
+
+static const char INDEX_MAGIC[8] = {'C', 'G', 'S', 'T', 'O', 'R', 'E', '2'};
+static const char LOG_MAGIC[8] = {'C', 'G', 'S', 'L', 'O', 'G', '0', '1'};
+static const size_t LOG_RECORD_BYTES = 32;
+static const char REFERENCE_MAGIC[8] = {'C', 'G', 'R', 'E', 'F', '0', '0', '1'};
+
+// Random value per byte for the gear hash; fixed so boundaries never move between runs
+static const uint64_t* gearTable() {
+    static uint64_t table[256];
+    static bool filled = [] {
+        SplitMix64 rng(0x6765617254616231ULL);
+        for (auto& value : table) {
+            value = rng.next();
+        }
+        return true;
+    }();
+    (void)filled;
+    return table;
+}
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    return x ^ (x >> 33);
+}
+
+static vector<char> readWholeFile(const string& path) {
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in) {
+        throw runtime_error("Cannot open " + path);
+    }
+    vector<char> bytes(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(bytes.data(), static_cast<streamsize>(bytes.size()));
+    if (!in) {
+        throw runtime_error("Failed to read " + path);
+    }
+    return bytes;
+}
+
+// Writes beside the target and renames over it, so readers see the old or new file
+static void replaceFile(const string& path, const ByteWriter& out) {
+    string temporary = path + ".tmp";
+    out.saveToFile(temporary);
+    fs::rename(temporary, path);
+}
+
+// Constructor
+DeckStore::DeckStore(const string& saveDirectory)
+    : storeDirectory((fs::path(saveDirectory) / ".store").string()), packGeneration(0), logSequence(0), indexBytes(0), logBytes(0),
+      packSize(0), liveBytes(0) {
+    fs::create_directories(storeDirectory);
+    loadIndex();
+}
+
+// Core functionality implementations
+StoreWriteStats DeckStore::put(const string& referencePath, const char* data, size_t size) {
+    StoreWriteStats stats;
+    stats.logicalBytes = size;
+    vector<ChunkId> chunks;
+    vector<ChunkId> added;
+    vector<ChunkId> replaced;
+    bool replacing = false;
+    bool logged = false;
+    uint64_t packStart = packSize;
+    try {
+        ofstream pack;
+        size_t start = 0;
+        for (size_t end : chunkEnds(data, size)) {
+            size_t length = end - start;
+            ChunkId id = hashChunk(data + start, length);
+            auto it = index.find(id);
+            if (it != index.end()) {
+                if (it->second.length != length) {
+                    throw runtime_error("Deck store hash collision");
+                }
+                it->second.refs++;
+            } else {
+                if (!pack.is_open()) {
+                    pack.open(packPath(packGeneration), ios::binary | ios::app);
+                    if (!pack) {
+                        throw runtime_error("Could not open the deck store pack for writing");
+                    }
+                }
+                pack.write(data + start, static_cast<streamsize>(length));
+                index.emplace(id, Entry{packSize, static_cast<uint32_t>(length), 1});
+                added.push_back(id);
+                packSize += length;
+                liveBytes += length;
+                stats.newChunks++;
+                stats.bytesWritten += length;
+            }
+            chunks.push_back(id);
+            start = end;
+        }
+        if (pack.is_open()) {
+            pack.close();
+            if (!pack) {
+                throw runtime_error("Error occurred while writing the deck store pack");
+            }
+        }
+        stats.chunks = static_cast<int>(chunks.size());
+        logged = true;
+        stats.bytesWritten += appendLog(chunks);
+
+        // Only now can the reference point at the chunks; a replaced deck lets go of its old ones
+        replacing = fs::exists(referencePath);
+        if (replacing) {
+            uint64_t oldSize;
+            replaced = readReference(referencePath, oldSize);
+        }
+        ByteWriter out;
+        out.reserve(sizeof(REFERENCE_MAGIC) + 12 + chunks.size() * 16);
+        out.writeRaw(REFERENCE_MAGIC, sizeof(REFERENCE_MAGIC));
+        out.write<uint64_t>(size);
+        out.write<uint32_t>(static_cast<uint32_t>(chunks.size()));
+        for (const ChunkId& id : chunks) {
+            out.write(id.high);
+            out.write(id.low);
+        }
+        replaceFile(referencePath, out);
+        stats.bytesWritten += out.size();
+    } catch (...) {
+        // Take back this save's references; once logged, the log gets the old
+        // counts again so they cannot leak
+        for (const ChunkId& id : chunks) {
+            index[id].refs--;
+        }
+        for (const ChunkId& id : added) {
+            liveBytes -= index[id].length;
+            index.erase(id);
+        }
+        bool reloaded = false;
+        if (logged) {
+            try {
+                appendLog(chunks);
+            } catch (...) {
+                loadIndex();
+                reloaded = true;
+            }
+        }
+        if (!added.empty() && !reloaded) {
+            // The pack may hold all, part or none of the new chunks; cut it back so
+            // the next save appends exactly where its index entries will say
+            string pack = packPath(packGeneration);
+            error_code error;
+            fs::resize_file(pack, packStart, error);
+            uint64_t actual = fs::file_size(pack, error);
+            packSize = error ? packStart : actual;
+        }
+        throw;
+    }
+    if (replacing) {
+        release(replaced);
+    }
+    return stats;
+}
+
+vector<char> DeckStore::get(const string& referencePath) const {
+    uint64_t size;
+    vector<ChunkId> chunks = readReference(referencePath, size);
+    vector<char> bytes;
+    bytes.reserve(static_cast<size_t>(size));
+    ifstream pack(packPath(packGeneration), ios::binary);
+    for (const ChunkId& id : chunks) {
+        auto it = index.find(id);
+        if (it == index.end() || !pack) {
+            throw runtime_error("Deck store is missing data for " + fs::path(referencePath).filename().string());
+        }
+        size_t at = bytes.size();
+        bytes.resize(at + it->second.length);
+        pack.seekg(static_cast<streamoff>(it->second.offset));
+        pack.read(bytes.data() + at, it->second.length);
+        if (!pack || !(hashChunk(bytes.data() + at, it->second.length) == id)) {
+            throw runtime_error("Deck store data is corrupt for " + fs::path(referencePath).filename().string());
+        }
+    }
+    if (bytes.size() != size) {
+        throw runtime_error("Deck store reference has the wrong size: " + referencePath);
+    }
+    return bytes;
+}
+
+void DeckStore::remove(const string& referencePath) {
+    uint64_t size;
+    vector<ChunkId> chunks = readReference(referencePath, size);
+    fs::remove(referencePath);
+    release(chunks);
+}
+
+uint64_t DeckStore::storedSize(const string& referencePath) const {
+    uint64_t size;
+    readReference(referencePath, size);
+    return size;
+}
+
+StoreUsage DeckStore::usage() const {
+    StoreUsage result;
+    result.chunks = static_cast<int>(index.size());
+    result.chunkBytes = liveBytes;
+    result.packBytes = packSize;
+    return result;
+}
+
+bool DeckStore::isReference(const string& filename) {
+    size_t length = strlen(REFERENCE_EXTENSION);
+    return filename.size() > length && filename.compare(filename.size() - length, length, REFERENCE_EXTENSION) == 0;
+}
+
+vector<size_t> DeckStore::chunkEnds(const char* data, size_t size) {
+    // The gear hash's top bits depend on the last 64 bytes, so a boundary is
+    // decided by nearby content only and edits move just the boundaries around them
+    const uint64_t* gear = gearTable();
+    vector<size_t> ends;
+    ends.reserve(size / (MIN_CHUNK + (1 << BOUNDARY_BITS)) + 1);
+    size_t start = 0;
+    uint64_t hash = 0;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash << 1) + gear[static_cast<unsigned char>(data[i])];
+        size_t length = i + 1 - start;
+        if ((length >= MIN_CHUNK && (hash >> (64 - BOUNDARY_BITS)) == 0) || length >= MAX_CHUNK) {
+            ends.push_back(i + 1);
+            start = i + 1;
+            hash = 0;
+        }
+    }
+    if (start < size) {
+        ends.push_back(size);
+    }
+    return ends;
+}
+
+ChunkId DeckStore::hashChunk(const char* data, size_t size) {
+    // Two independently mixed 64-bit lanes; not cryptographic. A chunk whose id
+    // is already stored is trusted to hold the same bytes; only a length
+    // mismatch is caught, so a same-length collision would go unnoticed
+    uint64_t high = 0x9E3779B97F4A7C15ULL ^ size;
+    uint64_t low = 0xC2B2AE3D27D4EB4FULL + size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        high = mix64(high ^ word);
+        low = (low ^ word) * 0x100000001B3ULL + (low >> 29);
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, size - i);
+    ChunkId id;
+    id.high = mix64(high ^ tail);
+    id.low = mix64(low ^ tail ^ id.high);
+    return id;
+}
+
+// Private helper implementations
+string DeckStore::packPath(uint64_t generation) const {
+    return (fs::path(storeDirectory) / ("chunks-" + to_string(generation) + ".pack")).string();
+}
+
+string DeckStore::indexPath() const {
+    return (fs::path(storeDirectory) / "chunks.idx").string();
+}
+
+void DeckStore::loadIndex() {
+    index.clear();
+    packGeneration = 0;
+    logSequence = 0;
+    indexBytes = 0;
+    liveBytes = 0;
+    if (fs::exists(indexPath())) {
+        vector<char> bytes = readWholeFile(indexPath());
+        ByteReader in(bytes.data(), bytes.size());
+        char magic[sizeof(INDEX_MAGIC)];
+        in.readRaw(magic, sizeof(magic));
+        if (memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0) {
+            throw runtime_error("Not a deck store index: " + indexPath());
+        }
+        packGeneration = in.read<uint64_t>();
+        logSequence = in.read<uint64_t>();
+        uint32_t count = in.read<uint32_t>();
+        index.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            ChunkId id;
+            id.high = in.read<uint64_t>();
+            id.low = in.read<uint64_t>();
+            Entry entry;
+            entry.offset = in.read<uint64_t>();
+            entry.length = in.read<uint32_t>();
+            entry.refs = in.read<uint32_t>();
+            index.emplace(id, entry);
+        }
+        indexBytes = bytes.size();
+    }
+
+    // The log holds whole entries in the order they changed. One left behind by an
+    // index rewrite that was cut short carries an older sequence and is dropped;
+    // a torn last record is cut off so later records line up again.
+    logBytes = 0;
+    if (fs::exists(logPath())) {
+        vector<char> bytes = readWholeFile(logPath());
+        ByteReader in(bytes.data(), bytes.size());
+        char magic[sizeof(LOG_MAGIC)];
+        if (in.remaining() >= sizeof(magic) + sizeof(uint64_t)) {
+            in.readRaw(magic, sizeof(magic));
+            if (memcmp(magic, LOG_MAGIC, sizeof(magic)) == 0 && in.read<uint64_t>() == logSequence) {
+                while (in.remaining() >= LOG_RECORD_BYTES) {
+                    ChunkId id;
+                    id.high = in.read<uint64_t>();
+                    id.low = in.read<uint64_t>();
+                    Entry entry;
+                    entry.offset = in.read<uint64_t>();
+                    entry.length = in.read<uint32_t>();
+                    entry.refs = in.read<uint32_t>();
+                    if (entry.refs == 0) {
+                        index.erase(id);
+                    } else {
+                        index[id] = entry;
+                    }
+                }
+                logBytes = bytes.size() - in.remaining();
+            }
+        }
+        if (logBytes == 0) {
+            fs::remove(logPath());
+        } else if (logBytes < bytes.size()) {
+            fs::resize_file(logPath(), logBytes);
+        }
+    }
+    for (const auto& item : index) {
+        liveBytes += item.second.length;
+    }
+
+    // Chunks appended before a crash lie past the last indexed one and count as free space
+    error_code error;
+    uintmax_t size = fs::file_size(packPath(packGeneration), error);
+    packSize = error ? 0 : size;
+    for (const auto& item : index) {
+        if (item.second.offset + item.second.length > packSize) {
+            throw runtime_error("Deck store index does not match its pack: " + storeDirectory);
+        }
+    }
+}
+
+string DeckStore::logPath() const {
+    return (fs::path(storeDirectory) / "chunks.log").string();
+}
+
+size_t DeckStore::saveIndex() {
+    ByteWriter out;
+    out.reserve(sizeof(INDEX_MAGIC) + 20 + index.size() * 32);
+    out.writeRaw(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    out.write(packGeneration);
+    out.write(logSequence + 1);
+    out.write<uint32_t>(static_cast<uint32_t>(index.size()));
+    for (const auto& item : index) {
+        out.write(item.first.high);
+        out.write(item.first.low);
+        out.write(item.second.offset);
+        out.write(item.second.length);
+        out.write(item.second.refs);
+    }
+    replaceFile(indexPath(), out);
+    logSequence++;
+    fs::remove(logPath());
+    indexBytes = out.size();
+    logBytes = 0;
+    return out.size();
+}
+
+size_t DeckStore::appendLog(const vector<ChunkId>& chunks) {
+    // Once the log is larger than the index, replaying it costs more than
+    // rewriting the index, so fold it in
+    if (logBytes + chunks.size() * LOG_RECORD_BYTES > max<uint64_t>(indexBytes, 64 * 1024)) {
+        return saveIndex();
+    }
+    ByteWriter out;
+    out.reserve(sizeof(LOG_MAGIC) + 8 + chunks.size() * LOG_RECORD_BYTES);
+    if (logBytes == 0) {
+        out.writeRaw(LOG_MAGIC, sizeof(LOG_MAGIC));
+        out.write(logSequence);
+    }
+    vector<ChunkId> changed = chunks;
+    sort(changed.begin(), changed.end(), [](const ChunkId& a, const ChunkId& b) {
+        return a.high != b.high ? a.high < b.high : a.low < b.low;
+    });
+    changed.erase(unique(changed.begin(), changed.end()), changed.end());
+    for (const ChunkId& id : changed) {
+        auto it = index.find(id);
+        Entry entry = it == index.end() ? Entry{0, 0, 0} : it->second;
+        out.write(id.high);
+        out.write(id.low);
+        out.write(entry.offset);
+        out.write(entry.length);
+        out.write(entry.refs);
+    }
+    ofstream log(logPath(), ios::binary | ios::app);
+    log.write(out.data(), static_cast<streamsize>(out.size()));
+    log.close();
+    if (!log) {
+        throw runtime_error("Error occurred while writing the deck store index log");
+    }
+    logBytes += out.size();
+    return out.size();
+}
+
+void DeckStore::release(const vector<ChunkId>& chunks) {
+    for (const ChunkId& id : chunks) {
+        auto it = index.find(id);
+        if (it != index.end() && --it->second.refs == 0) {
+            liveBytes -= it->second.length;
+            index.erase(it);
+        }
+    }
+    if (packSize - liveBytes > liveBytes) {
+        compact();
+    } else {
+        appendLog(chunks);
+    }
+}
+
+void DeckStore::compact() {
+    // Live chunks are copied into a pack with the next generation number; the
+    // index switching to it is the commit point, then the old pack goes
+    uint64_t oldGeneration = packGeneration;
+    string newPack = packPath(oldGeneration + 1);
+    try {
+        vector<Entry*> entries;
+        entries.reserve(index.size());
+        for (auto& item : index) {
+            entries.push_back(&item.second);
+        }
+        sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) { return a->offset < b->offset; });
+
+        ifstream in(packPath(oldGeneration), ios::binary);
+        ofstream out(newPack, ios::binary | ios::trunc);
+        vector<char> buffer(MAX_CHUNK);
+        uint64_t offset = 0;
+        for (Entry* entry : entries) {
+            in.seekg(static_cast<streamoff>(entry->offset));
+            in.read(buffer.data(), entry->length);
+            out.write(buffer.data(), entry->length);
+            entry->offset = offset;
+            offset += entry->length;
+        }
+        out.close();
+        if (!in || !out) {
+            throw runtime_error("Error occurred while compacting the deck store");
+        }
+        packGeneration = oldGeneration + 1;
+        packSize = offset;
+        saveIndex();
+    } catch (...) {
+        fs::remove(newPack);
+        loadIndex();
+        throw;
+    }
+    fs::remove(packPath(oldGeneration));
+}
+
+vector<ChunkId> DeckStore::readReference(const string& referencePath, uint64_t& size) {
+    vector<char> bytes = readWholeFile(referencePath);
+    ByteReader in(bytes.data(), bytes.size());
+    char magic[sizeof(REFERENCE_MAGIC)];
+    in.readRaw(magic, sizeof(magic));
+    if (memcmp(magic, REFERENCE_MAGIC, sizeof(magic)) != 0) {
+        throw runtime_error("Not a deck store reference: " + referencePath);
+    }
+    size = in.read<uint64_t>();
+    uint32_t count = in.read<uint32_t>();
+    if (in.remaining() != static_cast<size_t>(count) * 16) {
+        throw runtime_error("Deck store reference is damaged: " + referencePath);
+    }
+    vector<ChunkId> chunks(count);
+    for (ChunkId& id : chunks) {
+        id.high = in.read<uint64_t>();
+        id.low = in.read<uint64_t>();
+    }
+    return chunks;
+}
@@ -0,0 +1,99 @@
+#ifndef DECKSTORE_H
+#define DECKSTORE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+using namespace std;
+
+// 128-bit content hash naming a chunk
+struct ChunkId {
+    uint64_t high = 0;
+    uint64_t low = 0;
+
+    bool operator==(const ChunkId& other) const { return high == other.high && low == other.low; }
+};
+
+struct ChunkIdHash {
+    size_t operator()(const ChunkId& id) const { return static_cast<size_t>(id.low); }
+};
+
+struct StoreWriteStats {
+    size_t logicalBytes = 0;     // Size of the deck file that was stored
+    int chunks = 0;
+    int newChunks = 0;           // Chunks not already in the store
+    size_t bytesWritten = 0;     // New chunk data, the reference file and the index
+};
+
+struct StoreUsage {
+    int chunks = 0;
+    uint64_t chunkBytes = 0;     // Bytes of chunks still referenced
+    uint64_t packBytes = 0;      // Size of the pack file, including freed chunks
+};
+
+// Deduplicated storage for deck files. A saved deck becomes a small reference
+// file (name.cgref) listing its chunks; the chunks live once each in a pack
+// file under .store/ next to it. Chunk boundaries depend on content (a gear
+// rolling hash), so a variant that changes a few cards shares every chunk
+// except the few around the changes. The index keeps a reference count per
+// chunk; deleting a deck releases its chunks, and the pack is rewritten once
+// more than half of it is unreferenced. A save or delete appends the entries it
+// changed to an index log rather than rewriting the index, so its writes do not
+// grow with the store; the log is folded into the index once it outgrows it.
+// Writes go pack, index log, reference file, so a crash can leak chunks but
+// never leaves a reference to missing data.
+// Not safe for several processes writing the same directory.
+class DeckStore {
+public:
+    static const char* const REFERENCE_EXTENSION;
+    static const size_t MIN_CHUNK = 256;
+    static const size_t MAX_CHUNK = 8192;
+    static const int BOUNDARY_BITS = 10;   // A boundary every 2^10 bytes on average past MIN_CHUNK
+
+private:
+    struct Entry {
+        uint64_t offset;
+        uint32_t length;
+        uint32_t refs;
+    };
+
+    string storeDirectory;
+    uint64_t packGeneration;
+    uint64_t logSequence;      // Names the log that belongs on top of chunks.idx
+    uint64_t indexBytes;       // Size of chunks.idx as last written
+    uint64_t logBytes;         // Size of that log
+    uint64_t packSize;
+    uint64_t liveBytes;
+    unordered_map<ChunkId, Entry, ChunkIdHash> index;
+
+public:
+    // Constructor; opens or creates the store for a save directory
+    DeckStore(const string& saveDirectory);
+
+    // Core functionality
+    StoreWriteStats put(const string& referencePath, const char* data, size_t size);
+    vector<char> get(const string& referencePath) const;
+    void remove(const string& referencePath);
+    uint64_t storedSize(const string& referencePath) const;   // Size of the deck file it rebuilds
+
+    StoreUsage usage() const;
+
+    static bool isReference(const string& filename);
+    static vector<size_t> chunkEnds(const char* data, size_t size);
+    static ChunkId hashChunk(const char* data, size_t size);
+
+private:
+    string packPath(uint64_t generation) const;
+    string indexPath() const;
+    string logPath() const;
+    void loadIndex();
+    size_t saveIndex();
+    size_t appendLog(const vector<ChunkId>& chunks);
+    void release(const vector<ChunkId>& chunks);
+    void compact();
+    static vector<ChunkId> readReference(const string& referencePath, uint64_t& size);
+};
+
+#endif // DECKSTORE_H
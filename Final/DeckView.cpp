@@ -0,0 +1,32 @@
+#include "DeckView.h"
+
+// Accessor implementations
+Card* DeckView::at(int index) const {
+    if (index < 0 || static_cast<size_t>(index) >= count) {
+        throw runtime_error("Card index out of range");
+    }
+    return first[index];
+}
+
+Card* DeckView::top() const {
+    if (count == 0) {
+        throw runtime_error("Cannot take the top card of an empty view");
+    }
+    return first[count - 1];
+}
+
+// Core functionality implementations
+DeckView DeckView::slice(int begin, int length) const {
+    if (begin < 0 || length < 0 || static_cast<size_t>(begin) + static_cast<size_t>(length) > count) {
+        throw runtime_error("Slice is outside the view");
+    }
+    return DeckView(first + begin, length);
+}
+
+long long DeckView::totalValue() const {
+    long long total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += first[i]->getValue();
+    }
+    return total;
+}
@@ -0,0 +1,34 @@
+#ifndef DECKVIEW_H
+#define DECKVIEW_H
+
+#include "Card.h"
+#include <cstddef>
+
+// Non-owning, read-only window onto a run of cards in a deck, from the
+// bottom (index 0) up to the top. Copying a view copies two words, never
+// cards. A view is invalidated by any change to the deck it came from.
+class DeckView {
+private:
+    Card* const* first;
+    size_t count;
+
+public:
+    // Constructor
+    DeckView(Card* const* cards = nullptr, size_t size = 0) : first(cards), count(size) {}
+
+    // Accessors
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    Card* operator[](size_t index) const { return first[index]; }   // Unchecked
+    Card* at(int index) const;
+    Card* top() const;
+    Card* const* begin() const { return first; }
+    Card* const* end() const { return first + count; }
+
+    // Sub-range of this view, without copying
+    DeckView slice(int begin, int length) const;
+
+    long long totalValue() const;
+};
+
+#endif // DECKVIEW_H
@@ -0,0 +1,97 @@
+#include "EffectTicker.h"
+#include "Stats.h"
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+// Constructor
+EffectTicker::EffectTicker(const EffectTickRule& tickRule)
+    : special(BLOCK_SIZE), positions(BLOCK_SIZE), durability(BLOCK_SIZE), power(BLOCK_SIZE) {
+    setRule(tickRule);
+}
+
+// Core functionality implementations
+EffectTickReport EffectTicker::tick(Deck& deck) {
+    STATS_TIMER(TIMER_EFFECT_TICK);
+    auto start = chrono::steady_clock::now();
+
+    EffectTickReport report;
+    expiredPositions.clear();
+    int size = deck.getCurrentSize();
+    for (int blockStart = 0; blockStart < size; blockStart += BLOCK_SIZE) {
+        int blockEnd = min(size, blockStart + BLOCK_SIZE);
+
+        // Gather the block's special cards into contiguous arrays
+        int count = 0;
+        for (int i = blockStart; i < blockEnd; i++) {
+            if (SpecialCardBase* card = asSpecial(deck.getCard(i))) {
+                special[count] = card;
+                positions[count] = i;
+                durability[count] = card->getDurability();
+                power[count] = card->getPowerLevel();
+                count++;
+            }
+        }
+
+        report.specialCards += count;
+        report.expired += advance(durability.data(), power.data(), count, rule);
+
+        // Write surviving state back and collect expired cards
+        for (int i = 0; i < count; i++) {
+            if (durability[i] < 1) {
+                expiredPositions.push_back(positions[i]);
+            } else {
+                special[i]->setDurability(durability[i]);
+                special[i]->setPowerLevel(power[i]);
+            }
+        }
+    }
+    if (!expiredPositions.empty()) {
+        deck.removeCards(expiredPositions);
+    }
+
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+int EffectTicker::advance(int32_t* durability, double* power, size_t count, const EffectTickRule& rule) {
+    const int32_t loss = rule.durabilityLoss;
+    const double scale = rule.powerScale;
+    int expired = 0;
+    for (size_t i = 0; i < count; i++) {
+        durability[i] -= loss;
+        power[i] = min(10.0, max(0.1, power[i] * scale));
+        expired += durability[i] < 1;
+    }
+    return expired;
+}
+
+// Accessor and mutator implementations with validation
+void EffectTicker::setRule(const EffectTickRule& tickRule) {
+    if (tickRule.durabilityLoss < 0) {
+        throw runtime_error("Durability loss cannot be negative");
+    }
+    if (!(tickRule.powerScale > 0.0) || !isfinite(tickRule.powerScale)) {
+        throw runtime_error("Power scale must be a positive number");
+    }
+    rule = tickRule;
+}
+
+const EffectTickRule& EffectTicker::getRule() const {
+    return rule;
+}
+
+// Private helper implementations
+SpecialCardBase* EffectTicker::asSpecial(Card* card) {
+    // A deck holds few card classes, so remember each class's answer instead
+    // of paying for a dynamic_cast per card
+    const type_info* type = &typeid(*card);
+    for (const auto& known : knownTypes) {
+        if (known.first == type) {
+            return known.second ? static_cast<SpecialCardBase*>(card) : nullptr;
+        }
+    }
+    SpecialCardBase* special = dynamic_cast<SpecialCardBase*>(card);
+    knownTypes.push_back({type, special != nullptr});
+    return special;
+}
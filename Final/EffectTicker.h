@@ -0,0 +1,60 @@
+#ifndef EFFECTTICKER_H
+#define EFFECTTICKER_H
+
+#include "Deck.h"
+#include "SpecialCard.h"
+#include <vector>
+#include <cstdint>
+#include <typeinfo>
+
+// What one turn does to every special card
+struct EffectTickRule {
+    int durabilityLoss = 1;      // Cards reaching zero durability expire
+    double powerScale = 1.0;     // Power is multiplied, then clamped to 0.1-10.0
+};
+
+struct EffectTickReport {
+    int specialCards = 0;        // Special cards ticked, including expired ones
+    int expired = 0;             // Removed from the deck and deleted
+    double seconds = 0.0;
+};
+
+// Advances every special card in a deck by one turn. The deck is walked in
+// blocks: the durability and power of a block's special cards are gathered
+// into contiguous arrays, updated in one branch-free sweep the compiler
+// vectorizes, and written back through the validating setters while the cards
+// are still in cache, so getValue() reflects the new state and each card is
+// pulled from memory once per turn. Expired cards are removed with a single
+// compaction of the deck. Not thread-safe.
+class EffectTicker {
+public:
+    static const int BLOCK_SIZE = 2048;
+
+private:
+    EffectTickRule rule;
+    vector<SpecialCardBase*> special;    // Scratch for one block
+    vector<int> positions;               // Deck position of each special card
+    vector<int32_t> durability;
+    vector<double> power;
+    vector<int> expiredPositions;
+    vector<pair<const type_info*, bool>> knownTypes;   // Card classes already checked
+
+public:
+    // Constructor
+    EffectTicker(const EffectTickRule& tickRule = EffectTickRule());
+
+    // Core functionality
+    EffectTickReport tick(Deck& deck);
+
+    // Applies the rule to raw arrays; returns how many cards expired
+    static int advance(int32_t* durability, double* power, size_t count, const EffectTickRule& rule);
+
+    // Accessors and mutators with validation
+    void setRule(const EffectTickRule& tickRule);
+    const EffectTickRule& getRule() const;
+
+private:
+    SpecialCardBase* asSpecial(Card* card);
+};
+
+#endif // EFFECTTICKER_H
@@ -1,4 +1,8 @@
 #include "FileManager.h"
+#include "Stats.h"
+#include "DeckCollectionLoader.h"
+#include "CompactDeck.h"
+#include "CardSerialization.h"
 #include <iomanip>
 #include <algorithm>
 #include <limits>
@@ -6,9 +10,10 @@
 #include <fstream>
 #include <chrono>
 #include <ctime>
+#include <cstring>
 
 // Constructor implementation
-FileManager::FileManager(string directory) : saveDirectory(directory) {
+FileManager::FileManager(string directory) : saveDirectory(directory), deduplicatedSaves(false) {
     createSaveDirectory();
     refreshFileList();
 }
@@ -29,22 +34,32 @@ void FileManager::listSavedDecks() {
          << setw(20) << "Deck Name" << "File Size" << endl;
     cout << string(70, '-') << endl;
     
+    uintmax_t referencedBytes = 0;
     for (size_t i = 0; i < deckFiles.size(); i++) {
         string fullPath = saveDirectory + deckFiles[i];
         string deckName = extractDeckName(deckFiles[i]);
+        bool reference = DeckStore::isReference(deckFiles[i]);
         
-        // Get file size
+        // Get file size; a stored deck reports the size of the deck it rebuilds
         uintmax_t fileSize = 0;
         try {
-            fileSize = fs::file_size(fullPath);
-        } catch (const fs::filesystem_error&) {
+            fileSize = reference ? deckStore().storedSize(fullPath) : fs::file_size(fullPath);
+        } catch (const exception&) {
             fileSize = 0;
         }
+        if (reference) {
+            referencedBytes += fileSize;
+        }
         
         cout << left << setw(5) << (i + 1) 
              << setw(25) << deckFiles[i]
              << setw(20) << deckName
-             << fileSize << " bytes" << endl;
+             << fileSize << " bytes" << (reference ? " (deduplicated)" : "") << endl;
+    }
+    if (referencedBytes > 0) {
+        StoreUsage usage = deckStore().usage();
+        cout << "\nDeduplicated decks: " << referencedBytes << " bytes stored as " << usage.chunkBytes
+             << " bytes in " << usage.chunks << " chunks (pack file: " << usage.packBytes << " bytes)" << endl;
     }
     cout << endl;
 }
@@ -88,7 +103,12 @@ bool FileManager::loadSelectedDeck(Deck& deck) {
     }
     
     try {
-        deck.loadFromBinary(filename);
+        if (DeckStore::isReference(filename)) {
+            vector<char> bytes = deckStore().get(filename);
+            deck.loadFromBuffer(bytes.data(), bytes.size());
+        } else {
+            deck.loadFromBinary(filename);
+        }
         cout << "Deck loaded successfully from: " << filename << endl;
         return true;
     } catch (const runtime_error& e) {
@@ -98,42 +118,11 @@ bool FileManager::loadSelectedDeck(Deck& deck) {
 }
 
 void FileManager::saveNewDeck(const Deck& deck) {
-    displayHeader("SAVE DECK TO FILE");
-    
-    string baseName;
-    cout << "Enter a name for your deck file (without extension): ";
-    getline(cin, baseName);
-    
-    if (baseName.empty()) {
-        baseName = deck.getDeckName();
-    }
-    
-    // Sanitize filename
-    string filename = sanitizeFilename(baseName) + ".dat";
-    string fullPath = saveDirectory + filename;
-    
-    // Check if file exists
-    if (fs::exists(fullPath)) {
-        cout << "File '" << filename << "' already exists." << endl;
-        if (!confirmAction("overwrite it")) {
-            cout << "Save operation cancelled." << endl;
-            return;
-        }
-    }
-    
-    try {
-        // Open file in binary mode
-        ofstream file(fullPath, ios::binary);
-        if (!file) {
-            throw runtime_error("Could not open file for writing: " + fullPath);
-        }
-        // Create a non-const reference to call saveToBinary
-        const_cast<Deck&>(deck).saveToBinary(fullPath);
-        cout << "Deck saved successfully as: " << filename << endl;
-        refreshFileList();
-    } catch (const runtime_error& e) {
-        cout << "Error saving deck: " << e.what() << endl;
-    }
+    saveDeck(deck);
+}
+
+void FileManager::saveNewDeck(const DeckSnapshot& deck) {
+    saveDeck(deck);
 }
 
 void FileManager::deleteSelectedDeck() {
@@ -163,10 +152,15 @@ void FileManager::deleteSelectedDeck() {
     
     if (confirmAction("permanently delete this deck file")) {
         try {
-            fs::remove(fullPath);
+            if (DeckStore::isReference(selectedFile)) {
+                // Releases the deck's chunks; ones no other deck uses are freed
+                deckStore().remove(fullPath);
+            } else {
+                fs::remove(fullPath);
+            }
             cout << "Deck file deleted successfully: " << selectedFile << endl;
             refreshFileList();
-        } catch (const fs::filesystem_error& e) {
+        } catch (const exception& e) {
             cout << "Error deleting file: " << e.what() << endl;
         }
     } else {
@@ -174,13 +168,109 @@ void FileManager::deleteSelectedDeck() {
     }
 }
 
+void FileManager::loadAllDecks() {
+    refreshFileList();
+    displayHeader("LOAD ALL SAVED DECKS");
+    
+    if (deckFiles.empty()) {
+        cout << "No saved deck files found in: " << saveDirectory << endl;
+        return;
+    }
+    
+    vector<string> paths, references;
+    for (const auto& file : deckFiles) {
+        (DeckStore::isReference(file) ? references : paths).push_back(saveDirectory + file);
+    }
+    
+    DeckCollectionLoader loader;
+    DeckLoadResult result = loader.loadFiles(paths);
+    for (const auto& path : references) {
+        try {
+            vector<char> bytes = deckStore().get(path);
+            unique_ptr<Deck> deck(new Deck());
+            deck->loadFromBuffer(bytes.data(), bytes.size());
+            result.decks.push_back(move(deck));
+            result.files.push_back(path);
+            result.bytesRead += static_cast<long long>(bytes.size());
+        } catch (const exception& e) {
+            result.failures.push_back({path, e.what()});
+        }
+    }
+    
+    long long totalCards = 0;
+    for (const auto& deck : result.decks) {
+        totalCards += deck->getCurrentSize();
+    }
+    cout << "Loaded " << result.decks.size() << " of " << deckFiles.size() << " decks ("
+         << totalCards << " cards, " << result.bytesRead << " bytes) in "
+         << fixed << setprecision(3) << result.seconds * 1000.0 << " ms using "
+         << (result.usedIoUring ? "io_uring" : "a thread pool") << "." << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    for (const auto& failure : result.failures) {
+        cout << "  Failed: " << failure.file << " - " << failure.error << endl;
+    }
+    
+    // Identical cards across the collection share one catalog entry
+    CardCatalog catalog;
+    size_t compactBytes = 0;
+    for (const auto& deck : result.decks) {
+        CompactDeck compact(catalog, max(1, deck->getMaxSize()), deck->getDeckName(), deck->getOwner());
+        compact.addAll(*deck);
+        compactBytes += compact.memoryUsage();
+    }
+    compactBytes += catalog.memoryUsage();
+    cout << "Distinct cards: " << catalog.size() << " (compact collection size: "
+         << compactBytes << " bytes)" << endl;
+}
+
+void FileManager::findDecksWithCard() {
+    refreshFileList();
+    displayHeader("FIND DECKS CONTAINING A CARD");
+    
+    string cardName;
+    cout << "Enter the card name: ";
+    getline(cin, cardName);
+    if (cardName.empty()) {
+        cout << "Search cancelled." << endl;
+        return;
+    }
+    
+    try {
+        // Only decks saved or changed since the last search are read to update the index
+        bool references = any_of(deckFiles.begin(), deckFiles.end(),
+                                 [](const string& file) { return DeckStore::isReference(file); });
+        DeckStore* reader = references ? &deckStore() : nullptr;
+        SaveIndexRefresh refreshed = saveIndex().refresh(reader);
+        if (refreshed.indexed > 0) {
+            cout << "Indexed " << refreshed.indexed << " new or changed deck files." << endl;
+        }
+        
+        CardSearchResult result = saveIndex().findCard(cardName, reader);
+        if (result.files.empty()) {
+            cout << "No saved deck contains \"" << cardName << "\"." << endl;
+        } else {
+            cout << "\"" << cardName << "\" is in " << result.files.size() << " saved deck(s):" << endl;
+            for (const auto& file : result.files) {
+                cout << "  " << extractDeckName(file) << " (" << file << ")" << endl;
+            }
+        }
+        cout << "Opened " << result.candidates << " of " << refreshed.files << " deck files ("
+             << result.falsePositives << " false matches)." << endl;
+    } catch (const exception& e) {
+        cout << "Error searching saved decks: " << e.what() << endl;
+    }
+}
+
 // File operations implementations
 void FileManager::refreshFileList() {
+    STATS_TIMER(TIMER_FILE_SCAN);
     deckFiles.clear();
     
     try {
         if (fs::exists(saveDirectory) && fs::is_directory(saveDirectory)) {
             for (const auto& entry : fs::directory_iterator(saveDirectory)) {
+                STATS_COUNT(COUNTER_FILES_SCANNED, 1);
                 if (entry.is_regular_file()) {
                     string filename = entry.path().filename().string();
                     if (isValidDeckFile(filename)) {
@@ -215,38 +305,28 @@ void FileManager::displayDeckPreview(const string& filename) {
     cout << "\n--- DECK PREVIEW ---" << endl;
     
     try {
-        ifstream file(filename, ios::binary);
-        if (!file) {
-            cout << "Cannot read file for preview." << endl;
-            return;
-        }
-        
-        // Read deck name
-        int nameLength;
-        file.read(reinterpret_cast<char*>(&nameLength), sizeof(nameLength));
-        if (nameLength > 0 && nameLength < 1000) {  // Sanity check
-            char* nameBuffer = new char[nameLength + 1];
-            file.read(nameBuffer, nameLength);
-            nameBuffer[nameLength] = '\0';
-            cout << "Deck Name: " << string(nameBuffer) << endl;
-            delete[] nameBuffer;
+        // The header is all a preview needs; stored decks are rebuilt first
+        vector<char> header;
+        if (DeckStore::isReference(filename)) {
+            header = deckStore().get(filename);
+        } else {
+            ifstream file(filename, ios::binary);
+            if (!file) {
+                cout << "Cannot read file for preview." << endl;
+                return;
+            }
+            header.resize(4096);
+            file.read(header.data(), static_cast<streamsize>(header.size()));
+            header.resize(static_cast<size_t>(file.gcount()));
         }
+        ByteReader in(header.data(), header.size());
         
-        // Read owner name
-        int ownerLength;
-        file.read(reinterpret_cast<char*>(&ownerLength), sizeof(ownerLength));
-        if (ownerLength > 0 && ownerLength < 1000) {  // Sanity check
-            char* ownerBuffer = new char[ownerLength + 1];
-            file.read(ownerBuffer, ownerLength);
-            ownerBuffer[ownerLength] = '\0';
-            cout << "Owner: " << string(ownerBuffer) << endl;
-            delete[] ownerBuffer;
-        }
+        cout << "Deck Name: " << in.read<string>() << endl;
+        cout << "Owner: " << in.read<string>() << endl;
         
         // Read max size and current size
-        int maxSize, currentSize;
-        file.read(reinterpret_cast<char*>(&maxSize), sizeof(maxSize));
-        file.read(reinterpret_cast<char*>(&currentSize), sizeof(currentSize));
+        int maxSize = in.read<int32_t>();
+        int currentSize = in.read<int32_t>();
         
         cout << "Cards: " << currentSize << "/" << maxSize << endl;
         
@@ -272,11 +352,14 @@ bool FileManager::isValidDeckFile(const string& filename) {
     string extension = filename.substr(filename.length() - 4);
     transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
     
-    return extension == ".dat";
+    return extension == ".dat" || DeckStore::isReference(filename);
 }
 
 string FileManager::extractDeckName(const string& filename) {
-    // Remove .dat extension and return as deck name
+    // Remove .dat or .cgref extension and return as deck name
+    if (DeckStore::isReference(filename)) {
+        return filename.substr(0, filename.length() - strlen(DeckStore::REFERENCE_EXTENSION));
+    }
     if (filename.length() >= 4) {
         return filename.substr(0, filename.length() - 4);
     }
@@ -291,7 +374,10 @@ void FileManager::displayFileMenu() {
     cout << "4. Delete Saved Deck" << endl;
     cout << "5. Change Save Directory" << endl;
     cout << "6. Refresh File List" << endl;
-    cout << "7. Return to Main Menu" << endl;
+    cout << "7. Load All Saved Decks" << endl;
+    cout << "8. Deduplicated Saves: " << (deduplicatedSaves ? "On" : "Off") << " (toggle)" << endl;
+    cout << "9. Find Decks Containing a Card" << endl;
+    cout << "10. Return to Main Menu" << endl;
     cout << endl;
 }
 
@@ -309,10 +395,20 @@ void FileManager::setSaveDirectory(const string& directory) {
     if (saveDirectory.back() != '/' && saveDirectory.back() != '\\') {
         saveDirectory += "/";
     }
+    store.reset();
+    index.reset();
     createSaveDirectory();
     refreshFileList();
 }
 
+bool FileManager::getDeduplicatedSaves() const {
+    return deduplicatedSaves;
+}
+
+void FileManager::setDeduplicatedSaves(bool enabled) {
+    deduplicatedSaves = enabled;
+}
+
 // Private helper function implementations
 void FileManager::displayHeader(const string& title) const {
     string border(title.length() + 4, '=');
@@ -369,4 +465,81 @@ string FileManager::sanitizeFilename(const string& input) {
     }
     
     return result;
+}
+
+string FileManager::chooseSavePath(const string& defaultName) {
+    displayHeader("SAVE DECK TO FILE");
+    
+    string baseName;
+    cout << "Enter a name for your deck file (without extension): ";
+    getline(cin, baseName);
+    
+    if (baseName.empty()) {
+        baseName = defaultName;
+    }
+    
+    // Sanitize filename
+    string filename = sanitizeFilename(baseName) + (deduplicatedSaves ? DeckStore::REFERENCE_EXTENSION : ".dat");
+    string fullPath = saveDirectory + filename;
+    
+    // Check if file exists
+    if (fs::exists(fullPath)) {
+        cout << "File '" << filename << "' already exists." << endl;
+        if (!confirmAction("overwrite it")) {
+            cout << "Save operation cancelled." << endl;
+            return "";
+        }
+    }
+    return fullPath;
+}
+
+DeckStore& FileManager::deckStore() {
+    if (!store) {
+        store.reset(new DeckStore(saveDirectory));
+    }
+    return *store;
+}
+
+SaveIndex& FileManager::saveIndex() {
+    if (!index) {
+        index.reset(new SaveIndex(saveDirectory));
+    }
+    return *index;
+}
+
+void FileManager::storeReference(const string& fullPath, const ByteWriter& out) {
+    StoreWriteStats stats = deckStore().put(fullPath, out.data(), out.size());
+    cout << "Stored " << stats.newChunks << " new of " << stats.chunks << " chunks ("
+         << stats.bytesWritten << " bytes written for a " << stats.logicalBytes << "-byte deck)" << endl;
+}
+
+// Encodes the deck once and writes it either as a .dat file or into the store
+template<typename DeckType>
+void FileManager::saveDeck(const DeckType& deck) {
+    string fullPath = chooseSavePath(deck.getDeckName());
+    if (fullPath.empty()) {
+        return;
+    }
+    
+    try {
+        {
+            STATS_TIMER(TIMER_DECK_SAVE);
+            ByteWriter out;
+            deck.writeTo(out);
+            if (DeckStore::isReference(fullPath)) {
+                storeReference(fullPath, out);
+            } else {
+                out.saveToFile(fullPath);
+            }
+        }
+        cout << "Deck saved successfully as: " << fs::path(fullPath).filename().string() << endl;
+        try {
+            saveIndex().update(fs::path(fullPath).filename().string(), deck);
+        } catch (const exception&) {
+            // Only the search index goes stale; the next search rereads this file
+        }
+        refreshFileList();
+    } catch (const runtime_error& e) {
+        cout << "Error saving deck: " << e.what() << endl;
+    }
 }
\ No newline at end of file
@@ -7,6 +7,10 @@
 #include <filesystem>
 #include <fstream>
 #include "Deck.h"
+#include "VersionedDeck.h"
+#include "DeckStore.h"
+#include "SaveIndex.h"
+#include <memory>
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -15,6 +19,9 @@ class FileManager {
 private:
     string saveDirectory;
     vector<string> deckFiles;
+    bool deduplicatedSaves;          // New saves go to the chunk store as .cgref files
+    unique_ptr<DeckStore> store;     // Opened on first use for the current directory
+    unique_ptr<SaveIndex> index;     // Card filters per deck file, opened on first search
     
 public:
     // Constructor
@@ -25,7 +32,10 @@ public:
     string chooseDeckToLoad();
     bool loadSelectedDeck(Deck& deck);
     void saveNewDeck(const Deck& deck);
+    void saveNewDeck(const DeckSnapshot& deck);
     void deleteSelectedDeck();
+    void loadAllDecks();
+    void findDecksWithCard();
     
     // File operations
     void refreshFileList();
@@ -41,6 +51,8 @@ public:
     vector<string> getAvailableDecks() const;
     string getSaveDirectory() const;
     void setSaveDirectory(const string& directory);
+    bool getDeduplicatedSaves() const;
+    void setDeduplicatedSaves(bool enabled);
     
 private:
     // Helper functions
@@ -48,6 +60,12 @@ private:
     int getValidChoice(int min, int max);
     bool confirmAction(const string& action);
     string sanitizeFilename(const string& input);
+    string chooseSavePath(const string& defaultName);
+    DeckStore& deckStore();
+    SaveIndex& saveIndex();
+    void storeReference(const string& fullPath, const ByteWriter& out);
+    template<typename DeckType>
+    void saveDeck(const DeckType& deck);      // Shared by both saveNewDeck overloads
 };
 
 #endif // FILEMANAGER_H
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "GameCard.h"
+#include "MemoryReport.h"
 
 // Constructor implementation with validation
 GameCard::GameCard(string name, int value, string suit, bool face, int rare, bool foil, string ed, int serial)
@@ -14,10 +15,12 @@ void GameCard::setRarity(int r) {
         throw runtime_error("Rarity must be between 1 and 10");
     }
     rarity = r;
+    invalidateValue();
 }
 
 void GameCard::setFoiled(bool foil) {
     foiled = foil;
+    invalidateValue();
 }
 
 void GameCard::setEdition(string ed) {
@@ -65,9 +68,21 @@ void GameCard::display() const {
 
 // Override getValue to factor in rarity, foil, and condition
 int GameCard::getValue() const {
-    int baseValue = PlayingCard::getValue(); // This includes condition factor
-    int multiplier = rarity * (foiled ? 3 : 1); // Foiled cards worth 3x more
-    return baseValue * multiplier;
+    return cachedValueOr([this] {
+        int baseValue = conditionValue(); // This includes condition factor
+        int multiplier = rarity * (foiled ? 3 : 1); // Foiled cards worth 3x more
+        return baseValue * multiplier;
+    });
+}
+
+Card* GameCard::clone() const {
+    return new GameCard(*this);
+}
+
+void GameCard::addMemoryUsage(CardMemory& usage) const {
+    PlayingCard::addMemoryUsage(usage);
+    usage.objectBytes = sizeof(GameCard);
+    usage.addString(edition);
 }
 
 // Operator overloading implementations
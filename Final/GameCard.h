@@ -31,6 +31,9 @@ public:
     // Override getValue to factor in rarity and foil
     int getValue() const override;
     
+    Card* clone() const override;
+    void addMemoryUsage(CardMemory& usage) const override;
+    
     // Operator overloading (BOTH required)
     friend ostream& operator<<(ostream& os, const GameCard& card);
     friend istream& operator>>(istream& is, GameCard& card);
@@ -0,0 +1,192 @@
+#include "GameSimulator.h"
+#include "WorkStealingPool.h"
+#include <iomanip>
+#include <memory>
+#include <chrono>
+
+// Games handed to a worker at a time; small enough for stealing to balance load
+static const long long GAME_GRAIN = 256;
+
+// SimulationStats implementations
+double SimulationStats::getGamesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(gamesPlayed) / seconds : 0.0;
+}
+
+double SimulationStats::getCardWinRate(int cardIndex) const {
+    long long played = cardTricksPlayed.at(cardIndex);
+    return played == 0 ? 0.0 : static_cast<double>(cardTricksWon.at(cardIndex)) / played;
+}
+
+void SimulationStats::merge(const SimulationStats& other) {
+    gamesPlayed += other.gamesPlayed;
+    player1Wins += other.player1Wins;
+    player2Wins += other.player2Wins;
+    drawnGames += other.drawnGames;
+    totalTricks += other.totalTricks;
+    tiedTricks += other.tiedTricks;
+    if (cardTricksWon.size() < other.cardTricksWon.size()) {
+        cardTricksWon.resize(other.cardTricksWon.size(), 0);
+        cardTricksPlayed.resize(other.cardTricksPlayed.size(), 0);
+    }
+    for (size_t i = 0; i < other.cardTricksWon.size(); i++) {
+        cardTricksWon[i] += other.cardTricksWon[i];
+        cardTricksPlayed[i] += other.cardTricksPlayed[i];
+    }
+}
+
+// Constructor implementations with validation
+GameSimulator::GameSimulator(const vector<Card*>& cards, string owner1, string owner2)
+    : cardSet(cards), player1(owner1), player2(owner2) {
+    if (cardSet.size() < 2) {
+        throw runtime_error("Simulation needs at least two cards");
+    }
+    for (auto card : cardSet) {
+        if (!card) {
+            throw runtime_error("Cannot simulate with a null card");
+        }
+    }
+    if (player1.empty() || player2.empty()) {
+        throw runtime_error("Owner name cannot be empty");
+    }
+}
+
+GameSimulator::GameSimulator(const Deck& deck, string owner1, string owner2)
+    : GameSimulator([&deck]() {
+          vector<Card*> cards;
+          for (int i = 0; i < deck.getCurrentSize(); i++) {
+              cards.push_back(deck.getCard(i));
+          }
+          return cards;
+      }(), owner1, owner2) {}
+
+GameSimulator::WorkerArena::WorkerArena(int cardCount, const string& owner1, const string& owner2)
+    : hand1(cardCount / 2, "Hand 1", owner1), hand2(cardCount / 2, "Hand 2", owner2), order(cardCount) {
+    for (int i = 0; i < cardCount; i++) {
+        order[i] = i;
+    }
+}
+
+GameSimulator::WorkerArena::~WorkerArena() {
+    // The hands only borrow cards from the card set, so empty them before Deck deletes anything
+    while (!hand1.isEmpty()) hand1.drawCard();
+    while (!hand2.isEmpty()) hand2.drawCard();
+}
+
+// Core functionality implementations
+SimulationStats GameSimulator::run(long long games, uint64_t seed, int threads) const {
+    if (games < 0) {
+        throw runtime_error("Number of games cannot be negative");
+    }
+
+    WorkStealingPool& pool = WorkStealingPool::shared(threads);
+    int cardCount = static_cast<int>(cardSet.size());
+    vector<unique_ptr<WorkerArena>> arenas;
+    for (int i = 0; i < pool.getThreadCount(); i++) {
+        arenas.push_back(make_unique<WorkerArena>(cardCount, player1, player2));
+        arenas.back()->stats.cardTricksWon.assign(cardSet.size(), 0);
+        arenas.back()->stats.cardTricksPlayed.assign(cardSet.size(), 0);
+    }
+
+    auto start = chrono::steady_clock::now();
+    pool.parallelFor(games, GAME_GRAIN, [&](int worker, long long begin, long long end) {
+        WorkerArena& arena = *arenas[worker];
+        for (long long game = begin; game < end; game++) {
+            playGame(game, seed, arena);
+        }
+    });
+
+    SimulationStats total;
+    total.cardTricksWon.assign(cardSet.size(), 0);
+    total.cardTricksPlayed.assign(cardSet.size(), 0);
+    for (const auto& arena : arenas) {
+        total.merge(arena->stats);
+    }
+    total.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    total.threads = pool.getThreadCount();
+    return total;
+}
+
+void GameSimulator::playGame(long long gameIndex, uint64_t seed, WorkerArena& arena) const {
+    SplitMix64 mixer(seed ^ (static_cast<uint64_t>(gameIndex) * 0xD1B54A32D192ED03ULL));
+    SplitMix64 rng(mixer.next());
+
+    // Partial Fisher-Yates: only the cards that get dealt need to be chosen
+    vector<int>& order = arena.order;
+    int total = static_cast<int>(order.size());
+    int handSize = total / 2;
+    for (int i = 0; i < handSize * 2; i++) {
+        int j = i + static_cast<int>(rng.nextBelow(total - i));
+        swap(order[i], order[j]);
+    }
+
+    // Add in reverse so the hands are drawn in deal order
+    for (int k = handSize - 1; k >= 0; k--) {
+        arena.hand1.addCard(cardSet[order[2 * k]]);
+        arena.hand2.addCard(cardSet[order[2 * k + 1]]);
+    }
+
+    SimulationStats& stats = arena.stats;
+    int tricks1 = 0, tricks2 = 0;
+    for (int k = 0; k < handSize; k++) {
+        int index1 = order[2 * k];
+        int index2 = order[2 * k + 1];
+        int value1 = arena.hand1.drawCard()->getValue();
+        int value2 = arena.hand2.drawCard()->getValue();
+        stats.cardTricksPlayed[index1]++;
+        stats.cardTricksPlayed[index2]++;
+        if (value1 > value2) {
+            tricks1++;
+            stats.cardTricksWon[index1]++;
+        } else if (value2 > value1) {
+            tricks2++;
+            stats.cardTricksWon[index2]++;
+        } else {
+            stats.tiedTricks++;
+        }
+    }
+
+    // Restore the identity permutation so every game depends only on its own seed
+    for (int i = 0; i < total; i++) {
+        order[i] = i;
+    }
+
+    stats.gamesPlayed++;
+    stats.totalTricks += handSize;
+    if (tricks1 > tricks2) {
+        stats.player1Wins++;
+    } else if (tricks2 > tricks1) {
+        stats.player2Wins++;
+    } else {
+        stats.drawnGames++;
+    }
+}
+
+void GameSimulator::printReport(const SimulationStats& stats, ostream& os) const {
+    auto percent = [&stats](long long part) {
+        return stats.gamesPlayed == 0 ? 0.0 : 100.0 * part / stats.gamesPlayed;
+    };
+
+    os << "\n=== Simulation Results ===" << endl;
+    os << "Games played: " << stats.gamesPlayed << " on " << stats.threads << " thread(s) in "
+       << fixed << setprecision(3) << stats.seconds << " s ("
+       << setprecision(0) << stats.getGamesPerSecond() << " games/sec)" << endl;
+    os << setprecision(2);
+    os << player1 << " wins: " << stats.player1Wins << " (" << percent(stats.player1Wins) << "%)" << endl;
+    os << player2 << " wins: " << stats.player2Wins << " (" << percent(stats.player2Wins) << "%)" << endl;
+    os << "Drawn games: " << stats.drawnGames << " (" << percent(stats.drawnGames) << "%)" << endl;
+    os << "Tied tricks: " << stats.tiedTricks << " of " << stats.totalTricks << endl;
+
+    os << "\n" << left << setw(30) << "Card" << right << setw(8) << "Value"
+       << setw(14) << "Tricks" << setw(12) << "Win rate" << endl;
+    os << string(64, '-') << endl;
+    for (size_t i = 0; i < cardSet.size() && i < stats.cardTricksPlayed.size(); i++) {
+        os << left << setw(30) << cardSet[i]->getName() << right << setw(8) << cardSet[i]->getValue()
+           << setw(14) << stats.cardTricksPlayed[i]
+           << setw(11) << fixed << setprecision(2) << stats.getCardWinRate(static_cast<int>(i)) * 100 << "%"
+           << endl;
+    }
+}
+
+const vector<Card*>& GameSimulator::getCardSet() const {
+    return cardSet;
+}
@@ -0,0 +1,64 @@
+#ifndef GAMESIMULATOR_H
+#define GAMESIMULATOR_H
+
+#include "Card.h"
+#include "Deck.h"
+#include "SplitMix64.h"
+#include <vector>
+#include <cstdint>
+
+struct SimulationStats {
+    long long gamesPlayed = 0;
+    long long player1Wins = 0;
+    long long player2Wins = 0;
+    long long drawnGames = 0;
+    long long totalTricks = 0;
+    long long tiedTricks = 0;
+    vector<long long> cardTricksWon;     // Per card in the card set
+    vector<long long> cardTricksPlayed;
+    double seconds = 0.0;
+    int threads = 0;
+
+    double getGamesPerSecond() const;
+    double getCardWinRate(int cardIndex) const;
+    void merge(const SimulationStats& other);
+};
+
+// Headless high-card simulator. Each game shuffles the card set, deals it into
+// two Decks (an odd card out sits the game out), and both owners draw one card
+// per trick; the higher getValue() takes the trick and the owner with more
+// tricks wins the game.
+class GameSimulator {
+private:
+    vector<Card*> cardSet;    // Shared read-only by every worker; not owned
+    string player1;
+    string player2;
+
+public:
+    // Constructors
+    GameSimulator(const vector<Card*>& cards, string owner1 = "Player 1", string owner2 = "Player 2");
+    GameSimulator(const Deck& deck, string owner1 = "Player 1", string owner2 = "Player 2");
+
+    // Plays games [0, games) across the given number of threads (0 = all cores)
+    SimulationStats run(long long games, uint64_t seed, int threads = 0) const;
+
+    // Report with outcome totals and per-card trick win rates
+    void printReport(const SimulationStats& stats, ostream& os) const;
+
+    const vector<Card*>& getCardSet() const;
+
+private:
+    // Per-worker scratch space reused across games, so play allocates nothing
+    struct WorkerArena {
+        Deck hand1;
+        Deck hand2;
+        vector<int> order;
+        SimulationStats stats;
+        WorkerArena(int cardCount, const string& owner1, const string& owner2);
+        ~WorkerArena();
+    };
+
+    void playGame(long long gameIndex, uint64_t seed, WorkerArena& arena) const;
+};
+
+#endif // GAMESIMULATOR_H
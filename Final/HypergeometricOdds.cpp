@@ -0,0 +1,175 @@
+#include "HypergeometricOdds.h"
+#include <cmath>
+#include <algorithm>
+
+// Largest dynamic-programming table a joint question may build
+static const long long MAX_JOINT_STATES = 20000000;
+
+// Constructor implementations
+HypergeometricOdds::HypergeometricOdds(const Deck& deck)
+    : HypergeometricOdds(CardTraits::fromDeck(deck)) {}
+
+HypergeometricOdds::HypergeometricOdds(const vector<CardTraits>& cards) : traits(cards) {
+    logFactorial.resize(traits.size() + 1);
+    logFactorial[0] = 0.0;
+    for (size_t i = 1; i < logFactorial.size(); i++) {
+        logFactorial[i] = logFactorial[i - 1] + log(static_cast<double>(i));
+    }
+}
+
+// Core functionality implementations
+double HypergeometricOdds::probabilityAtLeast(const CardPredicate& predicate, int draws, int minCount) const {
+    int matching = static_cast<int>(count_if(traits.begin(), traits.end(), predicate));
+    return probabilityAtLeast(matching, draws, minCount);
+}
+
+double HypergeometricOdds::probabilityAtLeast(int matching, int draws, int minCount) const {
+    validateDraws(draws);
+    int population = getDeckSize();
+    if (matching < 0 || matching > population) {
+        throw runtime_error("Matching card count must be between 0 and the deck size");
+    }
+    if (minCount <= 0) {
+        return 1.0;
+    }
+
+    string key = "A" + to_string(matching) + ":" + to_string(draws) + ":" + to_string(minCount);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    double total = 0.0;
+    for (int x = minCount; x <= min(matching, draws); x++) {
+        total += pmf(population, matching, draws, x);
+    }
+    total = min(1.0, total);
+    cache[key] = total;
+    return total;
+}
+
+double HypergeometricOdds::probabilityExactly(int matching, int draws, int count) const {
+    validateDraws(draws);
+    if (matching < 0 || matching > getDeckSize()) {
+        throw runtime_error("Matching card count must be between 0 and the deck size");
+    }
+    return pmf(getDeckSize(), matching, draws, count);
+}
+
+double HypergeometricOdds::jointProbability(const vector<DrawRequirement>& requirements, int draws) const {
+    validateDraws(draws);
+    int requirementCount = static_cast<int>(requirements.size());
+    if (requirementCount < 1 || requirementCount > MonteCarloEstimator::MAX_REQUIREMENTS) {
+        throw runtime_error("Between 1 and 8 draw requirements are supported");
+    }
+
+    // Cards satisfying the same set of requirements are interchangeable, so only
+    // the number of cards per requirement mask matters
+    vector<int> cellCounts(1 << requirementCount, 0);
+    vector<int> needed(requirementCount);
+    for (int r = 0; r < requirementCount; r++) {
+        if (requirements[r].minCount < 0) {
+            throw runtime_error("Minimum count cannot be negative");
+        }
+        needed[r] = requirements[r].minCount;
+    }
+    for (const auto& card : traits) {
+        int mask = 0;
+        for (int r = 0; r < requirementCount; r++) {
+            if (requirements[r].predicate(card)) mask |= 1 << r;
+        }
+        cellCounts[mask]++;
+    }
+
+    string key = "J" + to_string(draws);
+    for (int need : needed) key += ":" + to_string(need);
+    key += "|";
+    for (int count : cellCounts) key += to_string(count) + ",";
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    // State: cards drawn so far, plus each requirement's progress capped at its target
+    vector<long long> place(requirementCount);
+    long long capStates = 1;
+    for (int r = 0; r < requirementCount; r++) {
+        place[r] = capStates;
+        capStates *= needed[r] + 1;
+    }
+    if ((draws + 1) * capStates > MAX_JOINT_STATES) {
+        throw runtime_error("Joint question is too large to compute exactly");
+    }
+
+    vector<double> current((draws + 1) * capStates, 0.0);
+    vector<double> next(current.size());
+    current[0] = 1.0;
+    int remaining = getDeckSize();
+
+    for (int mask = 0; mask < static_cast<int>(cellCounts.size()); mask++) {
+        int cellSize = cellCounts[mask];
+        if (cellSize == 0) continue;
+        int population = remaining;
+        remaining -= cellSize;
+
+        fill(next.begin(), next.end(), 0.0);
+        for (int drawn = 0; drawn <= draws; drawn++) {
+            int left = draws - drawn;
+            int lowest = max(0, left - remaining);
+            int highest = min(cellSize, left);
+            for (long long state = 0; state < capStates; state++) {
+                double p = current[drawn * capStates + state];
+                if (p == 0.0) continue;
+                for (int x = lowest; x <= highest; x++) {
+                    // Chance this cell supplies exactly x of the cards still to be drawn
+                    double q = pmf(population, cellSize, left, x);
+                    long long advanced = state;
+                    for (int r = 0; r < requirementCount; r++) {
+                        if (!(mask & (1 << r))) continue;
+                        long long digit = (state / place[r]) % (needed[r] + 1);
+                        long long raised = min<long long>(needed[r], digit + x);
+                        advanced += (raised - digit) * place[r];
+                    }
+                    next[(drawn + x) * capStates + advanced] += p * q;
+                }
+            }
+        }
+        swap(current, next);
+    }
+
+    // Every requirement met means every digit sits at its cap
+    double result = min(1.0, current[draws * capStates + (capStates - 1)]);
+    cache[key] = result;
+    return result;
+}
+
+int HypergeometricOdds::getDeckSize() const {
+    return static_cast<int>(traits.size());
+}
+
+size_t HypergeometricOdds::getCacheSize() const {
+    return cache.size();
+}
+
+void HypergeometricOdds::clearCache() {
+    cache.clear();
+}
+
+// Private helper implementations
+double HypergeometricOdds::logChoose(int n, int k) const {
+    return logFactorial[n] - logFactorial[k] - logFactorial[n - k];
+}
+
+double HypergeometricOdds::pmf(int population, int successes, int draws, int x) const {
+    if (x < 0 || x > successes || draws - x < 0 || draws - x > population - successes) {
+        return 0.0;
+    }
+    return exp(logChoose(successes, x) + logChoose(population - successes, draws - x)
+               - logChoose(population, draws));
+}
+
+void HypergeometricOdds::validateDraws(int draws) const {
+    if (draws < 0 || draws > getDeckSize()) {
+        throw runtime_error("Number of draws must be between 0 and the deck size");
+    }
+}
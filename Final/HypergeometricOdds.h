@@ -0,0 +1,49 @@
+#ifndef HYPERGEOMETRICODDS_H
+#define HYPERGEOMETRICODDS_H
+
+#include "CardTraits.h"
+#include "MonteCarloEstimator.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+// Exact draw probabilities for a shuffled deck. Single questions ("at least k
+// Spades in the next n cards") use the hypergeometric tail; joint questions
+// split the deck into cells of cards satisfying the same set of requirements
+// and run a dynamic program over the multivariate hypergeometric distribution.
+// Log-factorials up to the deck size are tabulated once and every answer is
+// memoized, so repeated questions cost a hash lookup. Not thread-safe.
+class HypergeometricOdds {
+private:
+    vector<CardTraits> traits;
+    vector<double> logFactorial;     // logFactorial[i] = ln(i!)
+    mutable unordered_map<string, double> cache;
+
+public:
+    // Constructors
+    HypergeometricOdds(const Deck& deck);
+    HypergeometricOdds(const vector<CardTraits>& cards);
+
+    // P(at least minCount of the next draws cards match the predicate)
+    double probabilityAtLeast(const CardPredicate& predicate, int draws, int minCount) const;
+
+    // Same question when the number of matching cards is already known
+    double probabilityAtLeast(int matching, int draws, int minCount) const;
+
+    // P(exactly count matching cards among the next draws cards)
+    double probabilityExactly(int matching, int draws, int count) const;
+
+    // P(every requirement is met within the next draws cards)
+    double jointProbability(const vector<DrawRequirement>& requirements, int draws) const;
+
+    int getDeckSize() const;
+    size_t getCacheSize() const;
+    void clearCache();
+
+private:
+    double logChoose(int n, int k) const;
+    double pmf(int population, int successes, int draws, int x) const;
+    void validateDraws(int draws) const;
+};
+
+#endif // HYPERGEOMETRICODDS_H
@@ -0,0 +1,172 @@
+#include "MemoryReport.h"
+#include "Card.h"
+#include <algorithm>
+#include <iomanip>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+// glibc keeps one size word in front of every block
+static const size_t BLOCK_HEADER_BYTES = sizeof(size_t);
+
+static string readableTypeName(const type_info& type) {
+#ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    if (status == 0 && demangled) {
+        string name = demangled;
+        free(demangled);
+        // Drop the library's spelling of string inside template arguments
+        const string longString = "std::__cxx11::basic_string<char, std::char_traits<char>, std::allocator<char> >";
+        for (size_t at = name.find(longString); at != string::npos; at = name.find(longString)) {
+            bool closesTemplate = name.compare(at + longString.size(), 2, " >") == 0;
+            name.replace(at, longString.size() + (closesTemplate ? 1 : 0), "string");
+        }
+        return name;
+    }
+#endif
+    return type.name();
+}
+
+// Card memory implementations
+void CardMemory::addString(const string& text) {
+    strings++;
+    if (storedInline(text)) {
+        return;
+    }
+    stringHeapBytes += text.capacity() + 1;
+    allocatedBytes += blockSize(text.data(), text.capacity() + 1);
+    heapBlocks++;
+}
+
+void CardMemory::addHeap(const void* block, size_t requested) {
+    otherHeapBytes += requested;
+    allocatedBytes += blockSize(block, requested);
+    heapBlocks++;
+}
+
+size_t CardMemory::blockSize(const void* block, size_t requested) {
+#ifdef __GLIBC__
+    (void)requested;
+    return malloc_usable_size(const_cast<void*>(block));
+#else
+    // Typical 16-byte-aligned allocator with an 8-byte header and 24-byte minimum
+    (void)block;
+    size_t rounded = (requested + BLOCK_HEADER_BYTES + 15) / 16 * 16 - BLOCK_HEADER_BYTES;
+    return max<size_t>(rounded, 24);
+#endif
+}
+
+bool CardMemory::storedInline(const string& text) {
+    // Short strings keep their characters inside the string object itself
+    const char* data = text.data();
+    const char* object = reinterpret_cast<const char*>(&text);
+    return data >= object && data < object + sizeof(string);
+}
+
+// Deck report implementations
+void DeckMemoryReport::addBlock(const void* block, size_t requested) {
+    heapBlocks++;
+    requestedBytes += requested;
+    allocatedBytes += CardMemory::blockSize(block, requested);
+    headerBytes += BLOCK_HEADER_BYTES;
+}
+
+size_t DeckMemoryReport::addString(const string& text) {
+    if (CardMemory::storedInline(text)) {
+        return 0;
+    }
+    addBlock(text.data(), text.capacity() + 1);
+    return text.capacity() + 1;
+}
+
+void DeckMemoryReport::addCard(const Card& card) {
+    CardMemory usage;
+    card.addMemoryUsage(usage);
+    size_t objectAllocated = CardMemory::blockSize(&card, usage.objectBytes);
+
+    auto slot = typeSlots.find(typeid(card));
+    if (slot == typeSlots.end()) {
+        slot = typeSlots.emplace(typeid(card), byType.size()).first;
+        byType.push_back(TypeMemory());
+        byType.back().typeName = readableTypeName(typeid(card));
+    }
+    TypeMemory& type = byType[slot->second];
+    type.cards++;
+    type.objectBytes += usage.objectBytes;
+    type.stringHeapBytes += usage.stringHeapBytes;
+    type.otherHeapBytes += usage.otherHeapBytes;
+    type.allocatedBytes += objectAllocated + usage.allocatedBytes;
+
+    cards++;
+    cardObjectBytes += usage.objectBytes;
+    stringHeaderBytes += usage.strings * sizeof(string);
+    stringHeapBytes += usage.stringHeapBytes;
+    otherHeapBytes += usage.otherHeapBytes;
+    heapBlocks += 1 + usage.heapBlocks;
+    requestedBytes += usage.objectBytes + usage.stringHeapBytes + usage.otherHeapBytes;
+    allocatedBytes += objectAllocated + usage.allocatedBytes;
+    headerBytes += (1 + usage.heapBlocks) * BLOCK_HEADER_BYTES;
+}
+
+void DeckMemoryReport::finish() {
+    sort(byType.begin(), byType.end(),
+         [](const TypeMemory& a, const TypeMemory& b) { return a.allocatedBytes > b.allocatedBytes; });
+    typeSlots.clear();
+#ifdef __GLIBC__
+    struct mallinfo2 info = mallinfo2();
+    if (info.arena > 0) {
+        heapFreeFraction = static_cast<double>(info.fordblks) / static_cast<double>(info.arena);
+    }
+#endif
+}
+
+size_t DeckMemoryReport::heapBytes() const {
+    return allocatedBytes + headerBytes;
+}
+
+double DeckMemoryReport::internalFragmentation() const {
+    return allocatedBytes == 0 ? 0.0 : 1.0 - static_cast<double>(requestedBytes) / static_cast<double>(allocatedBytes);
+}
+
+void DeckMemoryReport::print(ostream& os) const {
+    auto perCard = [&](size_t bytes) { return cards == 0 ? 0.0 : static_cast<double>(bytes) / cards; };
+    ios::fmtflags flags = os.flags();
+    streamsize precision = os.precision();
+    os << fixed << setprecision(1);
+    os << "Cards: " << cards << ", heap: " << heapBytes() << " bytes in " << heapBlocks << " blocks ("
+       << perCard(heapBytes()) << " bytes per card)" << endl;
+
+    os << "\nBy card type:" << endl;
+    os << left << setw(28) << "  Type" << right << setw(10) << "Cards" << setw(14) << "Objects"
+       << setw(14) << "Strings" << setw(12) << "Other" << setw(14) << "Allocated" << endl;
+    for (const auto& type : byType) {
+        os << left << setw(28) << ("  " + type.typeName.substr(0, 25)) << right << setw(10) << type.cards
+           << setw(14) << type.objectBytes << setw(14) << type.stringHeapBytes << setw(12) << type.otherHeapBytes
+           << setw(14) << type.allocatedBytes << endl;
+    }
+
+    os << "\nBy field category:" << endl;
+    os << "  Deck object and its strings:    " << deckBytes << " bytes" << endl;
+    os << "  Card pointer array:             " << pointerArrayBytes << " bytes ("
+       << unusedPointerBytes << " unused capacity)" << endl;
+    os << "  Card objects:                   " << cardObjectBytes << " bytes (" << stringHeaderBytes
+       << " of them string headers)" << endl;
+    os << "  String characters on the heap:  " << stringHeapBytes << " bytes" << endl;
+    os << "  Other card heap data:           " << otherHeapBytes << " bytes" << endl;
+
+    os << "\nAllocator:" << endl;
+    os << "  Requested:                      " << requestedBytes << " bytes" << endl;
+    os << "  Handed out:                     " << allocatedBytes << " bytes" << endl;
+    os << "  Block headers:                  " << headerBytes << " bytes" << endl;
+    os << "  Internal fragmentation:         " << internalFragmentation() * 100.0 << "%" << endl;
+    if (heapFreeFraction >= 0.0) {
+        os << "  Free space held by the heap:    " << heapFreeFraction * 100.0 << "% (whole process)" << endl;
+    }
+    os.flags(flags);
+    os.precision(precision);
+}
@@ -0,0 +1,78 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <unordered_map>
+#include <typeindex>
+#include <cstdint>
+
+using namespace std;
+
+class Card;
+
+// Heap use of one card, filled in by Card::addMemoryUsage. Each class adds its
+// own string fields and sets objectBytes to its size, so after the override
+// chain runs objectBytes is the size of the most-derived class.
+struct CardMemory {
+    size_t objectBytes = 0;      // The card object: vtable pointer, numbers, string headers, padding
+    int strings = 0;
+    size_t stringHeapBytes = 0;  // Characters of strings too long for their inline buffer
+    size_t otherHeapBytes = 0;   // Other heap data the card owns, such as an effect's
+    size_t allocatedBytes = 0;   // Usable size of the heap blocks above, as handed out
+    long long heapBlocks = 0;    // Blocks beyond the card object itself
+
+    void addString(const string& text);
+    void addHeap(const void* block, size_t requested);
+
+    // Usable size of a heap block: exact on glibc, estimated elsewhere
+    static size_t blockSize(const void* block, size_t requested);
+    static bool storedInline(const string& text);   // Short enough for the string's own buffer
+};
+
+struct TypeMemory {
+    string typeName;
+    long long cards = 0;
+    size_t objectBytes = 0;
+    size_t stringHeapBytes = 0;
+    size_t otherHeapBytes = 0;
+    size_t allocatedBytes = 0;   // Card objects and their heap data as allocated
+};
+
+// What a deck costs, by card type and by kind of field, plus how much the
+// allocator adds on top. Built by Deck::memoryReport.
+struct DeckMemoryReport {
+    int cards = 0;
+    size_t deckBytes = 0;            // The Deck object itself, including its name and owner strings
+    size_t pointerArrayBytes = 0;    // vector<Card*> storage at its current capacity
+    size_t unusedPointerBytes = 0;   // Part of that beyond the current size
+    vector<TypeMemory> byType;       // Largest first once finished
+
+    // By field category, over every card
+    size_t cardObjectBytes = 0;
+    size_t stringHeaderBytes = 0;    // sizeof(string) per string field; part of cardObjectBytes
+    size_t stringHeapBytes = 0;
+    size_t otherHeapBytes = 0;
+
+    // Allocator view of every heap block the deck owns
+    long long heapBlocks = 0;
+    size_t requestedBytes = 0;       // Sizes asked for
+    size_t allocatedBytes = 0;       // Sizes handed out
+    size_t headerBytes = 0;          // Allocator bookkeeping in front of each block
+    double heapFreeFraction = -1.0;  // Free space kept by the process heap; -1 where unknown
+
+    void addBlock(const void* block, size_t requested);
+    size_t addString(const string& text);     // Returns the heap bytes it owns, if any
+    void addCard(const Card& card);
+    void finish();
+
+    size_t heapBytes() const;                 // allocatedBytes plus headerBytes
+    double internalFragmentation() const;     // Share of allocated bytes nobody asked for
+    void print(ostream& os) const;
+
+private:
+    unordered_map<type_index, size_t> typeSlots;   // Card type to its byType entry
+};
+
+#endif // MEMORYREPORT_H
@@ -0,0 +1,101 @@
+#include "MemoryTracker.h"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#if defined(CARDGAME_TRACK_MEMORY) && defined(__GLIBC__)
+#include <malloc.h>
+#define CARDGAME_TRACKING_ALLOCATOR
+#endif
+
+using namespace std;
+
+static atomic<long long> liveBytes(0);
+static atomic<long long> liveBlocks(0);
+static atomic<long long> peakBytes(0);
+static atomic<long long> allocations(0);
+
+#ifdef CARDGAME_TRACKING_ALLOCATOR
+// Blocks are counted at their usable size, which is also what free gives back
+static void* trackedAllocate(size_t size) {
+    void* block = malloc(size == 0 ? 1 : size);
+    if (!block) {
+        throw bad_alloc();
+    }
+    long long usable = static_cast<long long>(malloc_usable_size(block));
+    long long live = liveBytes.fetch_add(usable, memory_order_relaxed) + usable;
+    liveBlocks.fetch_add(1, memory_order_relaxed);
+    allocations.fetch_add(1, memory_order_relaxed);
+    long long peak = peakBytes.load(memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, memory_order_relaxed)) {
+    }
+    return block;
+}
+
+static void trackedFree(void* block) noexcept {
+    if (!block) {
+        return;
+    }
+    liveBytes.fetch_sub(static_cast<long long>(malloc_usable_size(block)), memory_order_relaxed);
+    liveBlocks.fetch_sub(1, memory_order_relaxed);
+    free(block);
+}
+
+void* operator new(size_t size) { return trackedAllocate(size); }
+void* operator new[](size_t size) { return trackedAllocate(size); }
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    try {
+        return trackedAllocate(size);
+    } catch (const bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    try {
+        return trackedAllocate(size);
+    } catch (const bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* block) noexcept { trackedFree(block); }
+void operator delete[](void* block) noexcept { trackedFree(block); }
+void operator delete(void* block, size_t) noexcept { trackedFree(block); }
+void operator delete[](void* block, size_t) noexcept { trackedFree(block); }
+void operator delete(void* block, const nothrow_t&) noexcept { trackedFree(block); }
+void operator delete[](void* block, const nothrow_t&) noexcept { trackedFree(block); }
+#endif
+
+// Core functionality implementations
+bool MemoryTracker::enabled() {
+#ifdef CARDGAME_TRACKING_ALLOCATOR
+    return true;
+#else
+    return false;
+#endif
+}
+
+MemoryCounters MemoryTracker::current() {
+    MemoryCounters counters;
+    counters.liveBytes = liveBytes.load(memory_order_relaxed);
+    counters.liveBlocks = liveBlocks.load(memory_order_relaxed);
+    counters.peakBytes = peakBytes.load(memory_order_relaxed);
+    counters.allocations = allocations.load(memory_order_relaxed);
+    return counters;
+}
+
+void MemoryTracker::resetPeak() {
+    peakBytes.store(liveBytes.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+// Scope implementations
+MemoryTracker::Scope::Scope() : start(current()) {}
+
+long long MemoryTracker::Scope::bytes() const {
+    return current().liveBytes - start.liveBytes;
+}
+
+long long MemoryTracker::Scope::blocks() const {
+    return current().liveBlocks - start.liveBlocks;
+}
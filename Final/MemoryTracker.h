@@ -0,0 +1,35 @@
+#ifndef MEMORYTRACKER_H
+#define MEMORYTRACKER_H
+
+#include <cstdint>
+
+struct MemoryCounters {
+    long long liveBytes = 0;     // Usable bytes of blocks not yet freed
+    long long liveBlocks = 0;
+    long long peakBytes = 0;     // Highest liveBytes since start or the last resetPeak
+    long long allocations = 0;   // Every operator new call
+};
+
+// Optional tracking allocator. Builds with CARDGAME_TRACK_MEMORY on glibc
+// replace the global operator new and delete to keep process-wide counters of
+// live heap bytes and blocks, at the cost of a few relaxed atomic operations
+// per allocation. Elsewhere enabled() is false and the counters stay zero.
+class MemoryTracker {
+public:
+    static bool enabled();
+    static MemoryCounters current();
+    static void resetPeak();
+
+    // Counts what is allocated and not freed between its construction and a call
+    class Scope {
+    private:
+        MemoryCounters start;
+
+    public:
+        Scope();
+        long long bytes() const;
+        long long blocks() const;
+    };
+};
+
+#endif // MEMORYTRACKER_H
@@ -0,0 +1,172 @@
+#include "MonteCarloEstimator.h"
+#include "WorkStealingPool.h"
+#include "SplitMix64.h"
+#include <cmath>
+#include <chrono>
+#include <memory>
+
+// Trials given to a worker at a time
+static const long long TRIAL_GRAIN = 1024;
+
+// Constructor implementations with validation
+MonteCarloEstimator::MonteCarloEstimator(const Deck& deck, int threadCount)
+    : MonteCarloEstimator(CardTraits::fromDeck(deck), threadCount) {}
+
+MonteCarloEstimator::MonteCarloEstimator(const vector<CardTraits>& cards, int threadCount)
+    : traits(cards), threads(threadCount), roundSize(1 << 16), maxTrials(10000000), confidenceZ(1.96) {
+    if (threadCount < 0) {
+        throw runtime_error("Thread count cannot be negative");
+    }
+}
+
+// Core functionality implementations
+ProbabilityEstimate MonteCarloEstimator::estimate(const CardPredicate& predicate, int draws, int minCount,
+                                                  double precision, uint64_t seed) const {
+    return estimate(vector<DrawRequirement>{{predicate, minCount}}, draws, precision, seed);
+}
+
+ProbabilityEstimate MonteCarloEstimator::estimate(const vector<DrawRequirement>& requirements, int draws,
+                                                  double precision, uint64_t seed) const {
+    int deckSize = getDeckSize();
+    int requirementCount = static_cast<int>(requirements.size());
+    if (requirementCount < 1 || requirementCount > MAX_REQUIREMENTS) {
+        throw runtime_error("Between 1 and 8 draw requirements are supported");
+    }
+    if (draws < 0 || draws > deckSize) {
+        throw runtime_error("Number of draws must be between 0 and the deck size");
+    }
+    if (precision <= 0.0) {
+        throw runtime_error("Target precision must be positive");
+    }
+
+    // Compact copy: one byte per card with a bit for each requirement it satisfies
+    vector<uint8_t> masks(deckSize, 0);
+    int needed[MAX_REQUIREMENTS] = {};
+    for (int r = 0; r < requirementCount; r++) {
+        if (requirements[r].minCount < 0) {
+            throw runtime_error("Minimum count cannot be negative");
+        }
+        needed[r] = requirements[r].minCount;
+        for (int i = 0; i < deckSize; i++) {
+            if (requirements[r].predicate(traits[i])) {
+                masks[i] |= static_cast<uint8_t>(1u << r);
+            }
+        }
+    }
+
+    struct WorkerState {
+        vector<uint8_t> cards;
+        vector<uint32_t> swaps;
+        alignas(64) long long successes = 0;
+    };
+
+    WorkStealingPool& pool = WorkStealingPool::shared(threads);
+    vector<unique_ptr<WorkerState>> workers;
+    for (int i = 0; i < pool.getThreadCount(); i++) {
+        workers.push_back(make_unique<WorkerState>());
+        workers.back()->cards = masks;
+        workers.back()->swaps.resize(draws);
+    }
+
+    ProbabilityEstimate result;
+    auto start = chrono::steady_clock::now();
+    while (result.trials < maxTrials) {
+        long long firstTrial = result.trials;
+        long long count = min(roundSize, maxTrials - firstTrial);
+
+        pool.parallelFor(count, TRIAL_GRAIN, [&](int worker, long long begin, long long end) {
+            WorkerState& state = *workers[worker];
+            uint8_t* cards = state.cards.data();
+            uint32_t* swaps = state.swaps.data();
+            long long successes = 0;
+            for (long long t = begin; t < end; t++) {
+                // Seed per trial so results do not depend on the thread count
+                SplitMix64 rng(seed ^ (static_cast<uint64_t>(firstTrial + t) * 0x9E3779B97F4A7C15ULL));
+                rng.next();
+                int counts[MAX_REQUIREMENTS] = {};
+                for (int i = 0; i < draws; i++) {
+                    uint32_t j = i + static_cast<uint32_t>(rng.nextBelow(deckSize - i));
+                    swap(cards[i], cards[j]);
+                    swaps[i] = j;
+                    uint8_t mask = cards[i];
+                    for (int r = 0; r < requirementCount; r++) {
+                        counts[r] += (mask >> r) & 1;
+                    }
+                }
+                bool success = true;
+                for (int r = 0; r < requirementCount; r++) {
+                    success = success && counts[r] >= needed[r];
+                }
+                successes += success;
+                // Undo the swaps so the next trial starts from the same order
+                for (int i = draws - 1; i >= 0; i--) {
+                    swap(cards[i], cards[swaps[i]]);
+                }
+            }
+            state.successes += successes;
+        });
+
+        result.trials += count;
+        result.successes = 0;
+        for (const auto& state : workers) {
+            result.successes += state->successes;
+        }
+        wilsonInterval(result.successes, result.trials, confidenceZ, result.lower, result.upper);
+        if (result.halfWidth() <= precision) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    result.probability = result.trials == 0 ? 0.0
+        : static_cast<double>(result.successes) / static_cast<double>(result.trials);
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// Tuning implementations
+void MonteCarloEstimator::setMaxTrials(long long trials) {
+    if (trials < 1) {
+        throw runtime_error("Maximum trials must be positive");
+    }
+    maxTrials = trials;
+}
+
+void MonteCarloEstimator::setRoundSize(long long trials) {
+    if (trials < 1) {
+        throw runtime_error("Round size must be positive");
+    }
+    roundSize = trials;
+}
+
+void MonteCarloEstimator::setConfidenceZ(double z) {
+    if (z <= 0.0) {
+        throw runtime_error("Confidence z-score must be positive");
+    }
+    confidenceZ = z;
+}
+
+long long MonteCarloEstimator::getMaxTrials() const {
+    return maxTrials;
+}
+
+int MonteCarloEstimator::getDeckSize() const {
+    return static_cast<int>(traits.size());
+}
+
+// Private helper implementation
+void MonteCarloEstimator::wilsonInterval(long long successes, long long trials, double z,
+                                         double& lower, double& upper) {
+    if (trials == 0) {
+        lower = 0.0;
+        upper = 1.0;
+        return;
+    }
+    double n = static_cast<double>(trials);
+    double p = static_cast<double>(successes) / n;
+    double z2 = z * z;
+    double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    double margin = z * sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    lower = max(0.0, center - margin);
+    upper = min(1.0, center + margin);
+}
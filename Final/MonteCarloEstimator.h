@@ -0,0 +1,67 @@
+#ifndef MONTECARLOESTIMATOR_H
+#define MONTECARLOESTIMATOR_H
+
+#include "CardTraits.h"
+#include <vector>
+#include <cstdint>
+
+// One condition of a draw question: at least minCount drawn cards match
+struct DrawRequirement {
+    CardPredicate predicate;
+    int minCount;
+};
+
+struct ProbabilityEstimate {
+    double probability = 0.0;
+    double lower = 0.0;        // Wilson score confidence interval
+    double upper = 0.0;
+    long long trials = 0;
+    long long successes = 0;
+    bool converged = false;    // Reached the target precision before maxTrials
+    double seconds = 0.0;
+
+    double halfWidth() const { return (upper - lower) / 2.0; }
+};
+
+// Estimates draw probabilities by simulating shuffles of a deck. The deck is
+// reduced once to one byte per card (a bit per requirement it satisfies), and
+// each trial partially shuffles a per-thread copy of those bytes, so trials
+// never touch Card objects. Trials run in rounds across all cores and stop as
+// soon as the confidence interval is narrower than the requested precision.
+class MonteCarloEstimator {
+public:
+    static const int MAX_REQUIREMENTS = 8;
+
+private:
+    vector<CardTraits> traits;
+    int threads;
+    long long roundSize;
+    long long maxTrials;
+    double confidenceZ;
+
+public:
+    // Constructors
+    MonteCarloEstimator(const Deck& deck, int threadCount = 0);
+    MonteCarloEstimator(const vector<CardTraits>& cards, int threadCount = 0);
+
+    // P(at least minCount of the next draws cards match the predicate)
+    ProbabilityEstimate estimate(const CardPredicate& predicate, int draws, int minCount,
+                                 double precision, uint64_t seed) const;
+
+    // P(every requirement is met within the next draws cards)
+    ProbabilityEstimate estimate(const vector<DrawRequirement>& requirements, int draws,
+                                 double precision, uint64_t seed) const;
+
+    // Tuning
+    void setMaxTrials(long long trials);
+    void setRoundSize(long long trials);
+    void setConfidenceZ(double z);     // 1.96 gives a 95% interval
+    long long getMaxTrials() const;
+    int getDeckSize() const;
+
+private:
+    static void wilsonInterval(long long successes, long long trials, double z,
+                               double& lower, double& upper);
+};
+
+#endif // MONTECARLOESTIMATOR_H
@@ -1,4 +1,5 @@
 #include "PlayingCard.h"
+#include "MemoryReport.h"
 
 // Constructor implementation with validation
 PlayingCard::PlayingCard(string name, int value, string s, bool face, int cond, string manuf) 
@@ -17,10 +18,25 @@ void PlayingCard::display() const {
 }
 
 int PlayingCard::getValue() const {
+    return cachedValueOr([this] { return conditionValue(); });
+}
+
+int PlayingCard::conditionValue() const {
     // Condition affects value (poor condition reduces value)
     return static_cast<int>(cardValue * (condition / 10.0));
 }
 
+Card* PlayingCard::clone() const {
+    return new PlayingCard(*this);
+}
+
+void PlayingCard::addMemoryUsage(CardMemory& usage) const {
+    Card::addMemoryUsage(usage);
+    usage.objectBytes = sizeof(PlayingCard);
+    usage.addString(suit);
+    usage.addString(manufacturer);
+}
+
 // Mutator implementations with validation
 void PlayingCard::setSuit(string s) {
     if (s != "Hearts" && s != "Diamonds" && s != "Clubs" && s != "Spades" && !s.empty()) {
@@ -38,6 +54,7 @@ void PlayingCard::setCondition(int cond) {
         throw runtime_error("Condition must be between 1 and 10");
     }
     condition = cond;
+    invalidateValue();
 }
 
 void PlayingCard::setManufacturer(string manuf) {
@@ -18,6 +18,8 @@ public:
     // Virtual functions implementation
     void display() const override;
     int getValue() const override;
+    Card* clone() const override;
+    void addMemoryUsage(CardMemory& usage) const override;
     
     // Accessors and mutators with validation
     void setSuit(string s);
@@ -32,6 +34,9 @@ public:
     // Operator overloading (BOTH required)
     friend ostream& operator<<(ostream& os, const PlayingCard& card);
     friend istream& operator>>(istream& is, PlayingCard& card);
+
+protected:
+    int conditionValue() const;   // Base value scaled by condition, never cached
 };
 
 #endif // PLAYINGCARD_H
\ No newline at end of file
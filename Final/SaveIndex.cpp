@@ -0,0 +1,417 @@
+#include "SaveIndex.h"
+#include "DeckStore.h"
+#include "GameCard.h"
+#include "VersionedDeck.h"
+#include "CardSerialization.h"
+#include "BitOps.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <unordered_set>
+
+namespace fs = std::filesystem;
+
+const char* const SaveIndex::INDEX_FILE = ".cards.idx";
+
+static const char INDEX_MAGIC[8] = {'C', 'G', 'N', 'A', 'M', 'E', 'S', '1'};
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    return x ^ (x >> 33);
+}
+
+static bool sameNameIgnoringCase(const string& a, const string& b) {
+    return a.size() == b.size() && equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return tolower(static_cast<unsigned char>(x)) == tolower(static_cast<unsigned char>(y));
+    });
+}
+
+// CardFilter constructors
+CardFilter::CardFilter() : words(1, 0) {}
+
+CardFilter::CardFilter(size_t keyCount) : words(1, 0) {
+    // A power of two lets probes pick a bit with a mask, and lets equal-sized
+    // filters be searched together
+    size_t needed = (keyCount * BITS_PER_KEY + 63) / 64;
+    size_t count = 1;
+    while (count < needed) count *= 2;
+    words.assign(count, 0);
+}
+
+CardFilter CardFilter::forDeck(const Deck& deck) {
+    vector<uint64_t> keys;
+    keys.reserve(deck.getCurrentSize());
+    for (int i = 0; i < deck.getCurrentSize(); i++) {
+        addKeys(*deck.getCard(i), keys);
+    }
+    return forKeys(keys);
+}
+
+CardFilter CardFilter::forDeck(const DeckSnapshot& deck) {
+    vector<uint64_t> keys;
+    keys.reserve(deck.getCurrentSize());
+    for (int i = 0; i < deck.getCurrentSize(); i++) {
+        addKeys(deck.getCard(i), keys);
+    }
+    return forKeys(keys);
+}
+
+void CardFilter::addKeys(const Card& card, vector<uint64_t>& keys) {
+    keys.push_back(nameKey(card.getName()));
+    const GameCard* game = dynamic_cast<const GameCard*>(&card);
+    if (game && game->getSerialNumber() > 0) {
+        keys.push_back(serialKey(game->getSerialNumber()));
+    }
+}
+
+CardFilter CardFilter::forKeys(vector<uint64_t>& keys) {
+    // Decks repeat names, so size the filter for the distinct keys only
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+    CardFilter filter(keys.size());
+    for (uint64_t key : keys) {
+        filter.insert(key);
+    }
+    return filter;
+}
+
+// CardFilter core functionality implementations
+void CardFilter::insert(uint64_t key) {
+    uint64_t bits = bitCount();
+    for (int i = 0; i < PROBES; i++) {
+        uint64_t bit = probeBit(key, i, bits);
+        words[bit / 64] |= 1ULL << (bit % 64);
+    }
+}
+
+bool CardFilter::mayContain(uint64_t key) const {
+    uint64_t bits = bitCount();
+    for (int i = 0; i < PROBES; i++) {
+        uint64_t bit = probeBit(key, i, bits);
+        if (!(words[bit / 64] & (1ULL << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t CardFilter::sizeInBytes() const {
+    return words.size() * sizeof(uint64_t);
+}
+
+uint64_t CardFilter::bitCount() const {
+    return words.size() * 64;
+}
+
+const vector<uint64_t>& CardFilter::getWords() const {
+    return words;
+}
+
+// Each probe hashes afresh. Deriving probes as h1 + i * h2 would be cheaper, but
+// in a filter of a few hundred bits two keys then share every probe about once
+// in bits^2 lookups, far above the rate the filter is sized for.
+uint64_t CardFilter::probeBit(uint64_t key, int i, uint64_t bits) {
+    uint64_t hash = i == 0 ? key : mix64(key + static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL);
+    return hash & (bits - 1);
+}
+
+uint64_t CardFilter::nameKey(const string& name) {
+    // FNV-1a over the lowercased name
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (char c : name) {
+        hash ^= static_cast<uint64_t>(tolower(static_cast<unsigned char>(c)));
+        hash *= 0x100000001B3ULL;
+    }
+    return mix64(hash);
+}
+
+uint64_t CardFilter::serialKey(int serial) {
+    // A different seed keeps serial keys apart from name keys
+    return mix64(static_cast<uint64_t>(static_cast<uint32_t>(serial)) ^ 0x53455249414C2323ULL);
+}
+
+void CardFilter::writeTo(ByteWriter& out) const {
+    out.write<uint32_t>(static_cast<uint32_t>(words.size()));
+    out.writeRaw(words.data(), words.size() * sizeof(uint64_t));
+}
+
+CardFilter CardFilter::readFrom(ByteReader& in) {
+    uint32_t count = in.read<uint32_t>();
+    if (count == 0 || (count & (count - 1)) != 0 || count > in.remaining() / sizeof(uint64_t)) {
+        throw runtime_error("Invalid card filter size");
+    }
+    CardFilter filter;
+    filter.words.resize(count);
+    in.readRaw(filter.words.data(), count * sizeof(uint64_t));
+    return filter;
+}
+
+// SaveIndex constructor
+SaveIndex::SaveIndex(const string& directory) : saveDirectory(directory), groupsCurrent(false) {
+    load();
+}
+
+// SaveIndex maintenance implementations
+SaveIndexRefresh SaveIndex::refresh(DeckStore* store) {
+    SaveIndexRefresh stats;
+    unordered_set<string> seen;
+    if (fs::is_directory(saveDirectory)) {
+        for (const auto& item : fs::directory_iterator(saveDirectory)) {
+            string filename = item.path().filename().string();
+            if (!item.is_regular_file() || !isDeckFile(filename)) {
+                continue;
+            }
+            stats.files++;
+            seen.insert(filename);
+
+            // Size and modification time say whether the filter is still current
+            string path = item.path().string();
+            uint64_t size = static_cast<uint64_t>(item.file_size());
+            int64_t modified = modifiedTicks(path);
+            auto it = entries.find(filename);
+            if (it != entries.end() && it->second.size == size && it->second.modified == modified) {
+                continue;
+            }
+            try {
+                Deck deck;
+                readDeck(path, deck, store);
+                entries[filename] = {size, modified, static_cast<uint32_t>(deck.getCurrentSize()),
+                                     CardFilter::forDeck(deck)};
+                stats.indexed++;
+            } catch (const exception&) {
+                // Left out rather than kept stale; the next refresh tries again
+                if (entries.erase(filename) > 0) stats.removed++;
+                stats.failed++;
+            }
+        }
+    }
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (seen.count(it->first) == 0) {
+            it = entries.erase(it);
+            stats.removed++;
+        } else {
+            ++it;
+        }
+    }
+    if (stats.indexed > 0 || stats.removed > 0) {
+        groupsCurrent = false;
+        save();
+    }
+    return stats;
+}
+
+void SaveIndex::update(const string& filename, const Deck& deck) {
+    update(filename, static_cast<uint32_t>(deck.getCurrentSize()), CardFilter::forDeck(deck));
+}
+
+void SaveIndex::update(const string& filename, const DeckSnapshot& deck) {
+    update(filename, static_cast<uint32_t>(deck.getCurrentSize()), CardFilter::forDeck(deck));
+}
+
+void SaveIndex::erase(const string& filename) {
+    if (entries.erase(filename) > 0) {
+        groupsCurrent = false;
+        save();
+    }
+}
+
+// SaveIndex lookup implementations
+vector<string> SaveIndex::candidatesForName(const string& cardName) const {
+    return candidates(CardFilter::nameKey(cardName));
+}
+
+vector<string> SaveIndex::candidatesForSerial(int serial) const {
+    return candidates(CardFilter::serialKey(serial));
+}
+
+CardSearchResult SaveIndex::findCard(const string& cardName, DeckStore* store) const {
+    CardSearchResult result;
+    vector<string> files = candidatesForName(cardName);
+    result.candidates = static_cast<int>(files.size());
+    for (const auto& filename : files) {
+        Deck deck;
+        try {
+            readDeck((fs::path(saveDirectory) / filename).string(), deck, store);
+        } catch (const exception&) {
+            result.falsePositives++;
+            continue;
+        }
+        bool found = false;
+        for (int i = 0; i < deck.getCurrentSize() && !found; i++) {
+            found = sameNameIgnoringCase(deck.getCard(i)->getName(), cardName);
+        }
+        if (found) {
+            result.files.push_back(filename);
+        } else {
+            result.falsePositives++;
+        }
+    }
+    return result;
+}
+
+size_t SaveIndex::size() const {
+    return entries.size();
+}
+
+size_t SaveIndex::filterBytes() const {
+    size_t bytes = 0;
+    for (const auto& item : entries) {
+        bytes += item.second.filter.sizeInBytes();
+    }
+    return bytes;
+}
+
+// Private helper implementations
+string SaveIndex::indexPath() const {
+    return (fs::path(saveDirectory) / INDEX_FILE).string();
+}
+
+void SaveIndex::load() {
+    entries.clear();
+    groupsCurrent = false;
+    ifstream file(indexPath(), ios::binary | ios::ate);
+    if (!file) {
+        return;
+    }
+    vector<char> bytes(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(bytes.data(), static_cast<streamsize>(bytes.size()));
+    try {
+        ByteReader in(bytes.data(), bytes.size());
+        char magic[sizeof(INDEX_MAGIC)];
+        in.readRaw(magic, sizeof(magic));
+        if (!file || memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0) {
+            throw runtime_error("Not a card index: " + indexPath());
+        }
+        uint32_t count = in.read<uint32_t>();
+        entries.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            string filename = in.read<string>();
+            Entry entry;
+            entry.size = in.read<uint64_t>();
+            entry.modified = in.read<int64_t>();
+            entry.cards = in.read<uint32_t>();
+            entry.filter = CardFilter::readFrom(in);
+            entries.emplace(move(filename), move(entry));
+        }
+    } catch (const exception&) {
+        // The index only caches what the deck files say, so a damaged one is
+        // dropped and the next refresh reads every deck again
+        entries.clear();
+    }
+}
+
+void SaveIndex::save() const {
+    ByteWriter out;
+    out.reserve(sizeof(INDEX_MAGIC) + 4 + entries.size() * 64);
+    out.writeRaw(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    out.write<uint32_t>(static_cast<uint32_t>(entries.size()));
+    for (const auto& item : entries) {
+        out.write(item.first);
+        out.write(item.second.size);
+        out.write(item.second.modified);
+        out.write(item.second.cards);
+        item.second.filter.writeTo(out);
+    }
+    // Written beside the index and renamed over it, so readers see the old or new file
+    string temporary = indexPath() + ".tmp";
+    out.saveToFile(temporary);
+    fs::rename(temporary, indexPath());
+}
+
+vector<string> SaveIndex::candidates(uint64_t key) const {
+    if (!groupsCurrent) {
+        buildGroups();
+    }
+    vector<string> files;
+    vector<uint64_t> matching;
+    for (const auto& group : groups) {
+        // Decks whose filter has every probed bit set
+        matching.assign(group.stride, ~0ULL);
+        bool any = true;
+        for (int i = 0; i < CardFilter::PROBES && any; i++) {
+            const uint64_t* column = &group.columns[CardFilter::probeBit(key, i, group.bits) * group.stride];
+            uint64_t seen = 0;
+            for (size_t w = 0; w < group.stride; w++) {
+                matching[w] &= column[w];
+                seen |= matching[w];
+            }
+            any = seen != 0;
+        }
+        for (size_t w = 0; any && w < group.stride; w++) {
+            for (uint64_t word = matching[w]; word != 0; word &= word - 1) {
+                files.push_back(group.files[w * 64 + static_cast<size_t>(lowestSetBit(word))]);
+            }
+        }
+    }
+    sort(files.begin(), files.end());
+    return files;
+}
+
+void SaveIndex::buildGroups() const {
+    groups.clear();
+    unordered_map<uint64_t, size_t> groupForBits;
+    for (const auto& item : entries) {
+        uint64_t bits = item.second.filter.bitCount();
+        auto found = groupForBits.emplace(bits, groups.size());
+        if (found.second) {
+            groups.push_back({bits, 0, {}, {}});
+        }
+        groups[found.first->second].files.push_back(item.first);
+    }
+    for (auto& group : groups) {
+        group.stride = (group.files.size() + 63) / 64;
+        group.columns.assign(group.bits * group.stride, 0);
+        for (size_t slot = 0; slot < group.files.size(); slot++) {
+            const vector<uint64_t>& words = entries.at(group.files[slot]).filter.getWords();
+            for (size_t w = 0; w < words.size(); w++) {
+                for (uint64_t word = words[w]; word != 0; word &= word - 1) {
+                    size_t bit = w * 64 + static_cast<size_t>(lowestSetBit(word));
+                    group.columns[bit * group.stride + slot / 64] |= 1ULL << (slot % 64);
+                }
+            }
+        }
+    }
+    groupsCurrent = true;
+}
+
+void SaveIndex::update(const string& filename, uint32_t cards, CardFilter filter) {
+    string path = (fs::path(saveDirectory) / filename).string();
+    entries[filename] = {static_cast<uint64_t>(fs::file_size(path)), modifiedTicks(path), cards, move(filter)};
+    groupsCurrent = false;
+    save();
+}
+
+bool SaveIndex::isDeckFile(const string& filename) {
+    // Same test as FileManager::isValidDeckFile, so the index covers the listed decks
+    if (DeckStore::isReference(filename)) {
+        return true;
+    }
+    if (filename.size() < 4) {
+        return false;
+    }
+    string extension = filename.substr(filename.size() - 4);
+    transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension == ".dat";
+}
+
+int64_t SaveIndex::modifiedTicks(const string& path) {
+    return static_cast<int64_t>(fs::last_write_time(path).time_since_epoch().count());
+}
+
+void SaveIndex::readDeck(const string& path, Deck& deck, DeckStore* store) {
+    if (DeckStore::isReference(path)) {
+        if (!store) {
+            throw runtime_error("A deck store is needed to read " + path);
+        }
+        vector<char> bytes = store->get(path);
+        deck.loadFromBuffer(bytes.data(), bytes.size());
+    } else {
+        deck.loadFromBinary(path);
+    }
+}
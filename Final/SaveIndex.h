@@ -0,0 +1,134 @@
+#ifndef SAVEINDEX_H
+#define SAVEINDEX_H
+
+#include "Deck.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+using namespace std;
+
+class ByteReader;
+class ByteWriter;
+class DeckStore;
+class DeckSnapshot;
+
+// Bloom filter over the card names (ignoring case) and game-card serial numbers
+// in one deck. At exactly 30 bits and 20 probes per key about one check in 1.8
+// million is a false positive, and rounding the size up to a power of two only
+// lowers that, so a card that is in no deck of a 50k-deck collection is expected
+// to cost one needless deck read in about 36 searches.
+class CardFilter {
+public:
+    static const int BITS_PER_KEY = 30;
+    static const int PROBES = 20;
+
+private:
+    vector<uint64_t> words;
+
+public:
+    // Constructors
+    CardFilter();
+    CardFilter(size_t keyCount);
+    static CardFilter forDeck(const Deck& deck);
+    static CardFilter forDeck(const DeckSnapshot& deck);
+
+    void insert(uint64_t key);
+    bool mayContain(uint64_t key) const;
+    size_t sizeInBytes() const;
+    uint64_t bitCount() const;
+    const vector<uint64_t>& getWords() const;
+
+    static uint64_t probeBit(uint64_t key, int i, uint64_t bits);   // Bit set by probe i
+
+    static uint64_t nameKey(const string& name);
+    static uint64_t serialKey(int serial);
+
+    void writeTo(ByteWriter& out) const;
+    static CardFilter readFrom(ByteReader& in);
+
+private:
+    static void addKeys(const Card& card, vector<uint64_t>& keys);
+    static CardFilter forKeys(vector<uint64_t>& keys);
+};
+
+struct SaveIndexRefresh {
+    int files = 0;         // Deck files in the directory
+    int indexed = 0;       // New or changed files read to rebuild their filter
+    int removed = 0;       // Entries dropped for files that are gone
+    int failed = 0;        // Files that could not be read; left out of the index
+};
+
+struct CardSearchResult {
+    vector<string> files;      // Deck files holding the card, sorted
+    int candidates = 0;        // Files whose filter matched, so were opened
+    int falsePositives = 0;    // Candidates that turned out not to hold it
+};
+
+// Answers "which saved decks contain this card" for a save directory without
+// opening deck files whose filter rules the card out. The index lives in one
+// file (.cards.idx) beside the decks and records, per deck file, its size,
+// modification time and a CardFilter. refresh() stats every deck file and
+// reads only those that are new or changed since they were indexed. Files
+// saved through update() are indexed from the deck in memory. Queries trust
+// the index as it stands, so a negative answer touches no deck file at all.
+// In memory, filters of the same size are also kept bit-sliced: column b holds
+// bit b of every filter, so a query ANDs one column per probe instead of
+// visiting each filter, and stops as soon as no deck is left.
+// Not safe for several processes updating the same directory.
+class SaveIndex {
+public:
+    static const char* const INDEX_FILE;
+
+private:
+    struct Entry {
+        uint64_t size;
+        int64_t modified;      // File clock ticks
+        uint32_t cards;
+        CardFilter filter;
+    };
+
+    struct FilterGroup {
+        uint64_t bits;
+        size_t stride;                 // Words per column
+        vector<string> files;          // Bit s of each column belongs to files[s]
+        vector<uint64_t> columns;
+    };
+
+    string saveDirectory;
+    unordered_map<string, Entry> entries;   // Keyed by file name within the directory
+    mutable vector<FilterGroup> groups;     // Rebuilt on the first query after a change
+    mutable bool groupsCurrent;
+
+public:
+    // Constructor; loads the directory's index if it has one
+    SaveIndex(const string& directory);
+
+    // Maintenance. store is needed to read .cgref decks; without one they are skipped.
+    SaveIndexRefresh refresh(DeckStore* store = nullptr);
+    void update(const string& filename, const Deck& deck);   // After saving deck as filename
+    void update(const string& filename, const DeckSnapshot& deck);
+    void erase(const string& filename);
+
+    // Lookups
+    vector<string> candidatesForName(const string& cardName) const;
+    vector<string> candidatesForSerial(int serial) const;
+    CardSearchResult findCard(const string& cardName, DeckStore* store = nullptr) const;
+
+    size_t size() const;
+    size_t filterBytes() const;
+
+private:
+    string indexPath() const;
+    void load();
+    void save() const;
+    vector<string> candidates(uint64_t key) const;
+    void buildGroups() const;
+    void update(const string& filename, uint32_t cards, CardFilter filter);
+    static bool isDeckFile(const string& filename);
+    static int64_t modifiedTicks(const string& path);
+    static void readDeck(const string& path, Deck& deck, DeckStore* store);
+};
+
+#endif // SAVEINDEX_H
@@ -0,0 +1,239 @@
+#include "SessionTrace.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+
+const char SessionRecorder::MAGIC[8] = {'C', 'G', 'T', 'R', 'A', 'C', 'E', '1'};
+
+// Constructor
+SessionRecorder::SessionRecorder(const string& traceFile, const VersionedDeck& deck)
+    : filename(traceFile), operations(0) {
+    out.open(traceFile, ios::binary | ios::trunc);
+    if (!out) {
+        throw runtime_error("Cannot open session trace " + traceFile);
+    }
+    ByteWriter header;
+    header.writeRaw(MAGIC, sizeof(MAGIC));
+    header.write(deck.getDeckName());
+    header.write(deck.getOwner());
+    header.write<int32_t>(deck.getMaxSize());
+    header.write<int32_t>(deck.getHistoryLimit());
+    writeRecord(header);
+    // Decks may start out with cards, so the first checkpoint pins the start state
+    checkpoint(deck);
+}
+
+// Core functionality implementations
+void SessionRecorder::recordAddCard(const Card& card) {
+    ByteWriter record = startRecord(OP_ADD_CARD);
+    CardTypeRegistry::instance().encode(card, record);
+    writeOperation(record);
+}
+
+void SessionRecorder::recordShuffle(uint64_t seed) {
+    ByteWriter record = startRecord(OP_SHUFFLE);
+    record.write(seed);
+    writeOperation(record);
+}
+
+void SessionRecorder::recordDraw() {
+    ByteWriter record = startRecord(OP_DRAW);
+    writeOperation(record);
+}
+
+void SessionRecorder::recordReturnDrawn() {
+    ByteWriter record = startRecord(OP_RETURN_DRAWN);
+    writeOperation(record);
+}
+
+void SessionRecorder::recordUndo() {
+    ByteWriter record = startRecord(OP_UNDO);
+    writeOperation(record);
+}
+
+void SessionRecorder::recordRedo() {
+    ByteWriter record = startRecord(OP_REDO);
+    writeOperation(record);
+}
+
+void SessionRecorder::recordSort(const vector<DeckSortKey>& keys) {
+    if (keys.empty() || keys.size() > 255) {
+        throw runtime_error("Sort must use between 1 and 255 keys");
+    }
+    ByteWriter record = startRecord(OP_SORT);
+    record.write<uint8_t>(static_cast<uint8_t>(keys.size()));
+    for (DeckSortKey key : keys) {
+        record.write<uint8_t>(static_cast<uint8_t>(key));
+    }
+    writeOperation(record);
+}
+
+void SessionRecorder::recordLoad(const VersionedDeck& deck) {
+    ByteWriter image;
+    deck.snapshot().writeTo(image);
+    ByteWriter record = startRecord(OP_LOAD);
+    record.reserve(image.size() + 16);
+    record.write<uint64_t>(image.size());
+    record.writeRaw(image.data(), image.size());
+    writeOperation(record);
+}
+
+void SessionRecorder::checkpoint(const VersionedDeck& deck) {
+    ByteWriter record = startRecord(OP_CHECKPOINT);
+    record.write(stateHash(deck.snapshot()));
+    writeRecord(record);
+}
+
+long long SessionRecorder::getOperationCount() const {
+    return operations;
+}
+
+string SessionRecorder::getFilename() const {
+    return filename;
+}
+
+uint64_t SessionRecorder::stateHash(const DeckSnapshot& deck) {
+    ByteWriter image;
+    deck.writeTo(image);
+    // FNV-1a over the deck file bytes
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(image.data());
+    for (size_t i = 0; i < image.size(); i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+uint64_t SessionRecorder::freshSeed() {
+    random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device()
+           ^ static_cast<uint64_t>(chrono::steady_clock::now().time_since_epoch().count());
+}
+
+// Private helper implementations
+ByteWriter SessionRecorder::startRecord(SessionOp op) {
+    ByteWriter record;
+    record.reserve(64);
+    record.write<uint8_t>(op);
+    return record;
+}
+
+void SessionRecorder::writeRecord(const ByteWriter& record) {
+    out.write(record.data(), static_cast<streamsize>(record.size()));
+    out.flush();
+    if (!out) {
+        throw runtime_error("Failed to write session trace " + filename);
+    }
+}
+
+void SessionRecorder::writeOperation(const ByteWriter& record) {
+    writeRecord(record);
+    operations++;
+}
+
+// Constructor implementations
+SessionReplayer::SessionReplayer(const string& traceFile) {
+    ifstream in(traceFile, ios::binary | ios::ate);
+    if (!in) {
+        throw runtime_error("Cannot open session trace " + traceFile);
+    }
+    trace.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(trace.data(), static_cast<streamsize>(trace.size()));
+    if (!in) {
+        throw runtime_error("Failed to read session trace " + traceFile);
+    }
+}
+
+SessionReplayer::SessionReplayer(vector<char> traceBytes) : trace(move(traceBytes)) {}
+
+// Core functionality implementations
+ReplayReport SessionReplayer::replay(bool verifyCheckpoints) const {
+    auto start = chrono::steady_clock::now();
+    ByteReader in(trace.data(), trace.size());
+    char magic[sizeof(SessionRecorder::MAGIC)];
+    in.readRaw(magic, sizeof(magic));
+    if (memcmp(magic, SessionRecorder::MAGIC, sizeof(magic)) != 0) {
+        throw runtime_error("Not a session trace");
+    }
+    string name = in.read<string>();
+    string owner = in.read<string>();
+    int32_t maxSize = in.read<int32_t>();
+    int32_t historyLimit = in.read<int32_t>();
+    VersionedDeck deck(maxSize, name, owner);
+    deck.setHistoryLimit(historyLimit);
+
+    const CardTypeRegistry& registry = CardTypeRegistry::instance();
+    ReplayReport report;
+    shared_ptr<Card> drawn;
+    while (in.remaining() > 0) {
+        uint8_t op = in.read<uint8_t>();
+        switch (op) {
+            case OP_ADD_CARD:
+                deck.addCard(registry.decode(in));
+                break;
+            case OP_SHUFFLE:
+                deck.shuffle(in.read<uint64_t>());
+                break;
+            case OP_DRAW:
+                drawn = deck.drawCard();
+                break;
+            case OP_RETURN_DRAWN:
+                if (!drawn) {
+                    throw runtime_error("Trace returns a card before drawing one");
+                }
+                deck.addCard(drawn);
+                drawn.reset();
+                break;
+            case OP_UNDO:
+                deck.undo();
+                break;
+            case OP_REDO:
+                deck.redo();
+                break;
+            case OP_SORT: {
+                vector<DeckSortKey> keys(in.read<uint8_t>());
+                for (auto& key : keys) {
+                    uint8_t raw = in.read<uint8_t>();
+                    if (raw > SORT_BY_NAME) {
+                        throw runtime_error("Invalid sort key in session trace");
+                    }
+                    key = static_cast<DeckSortKey>(raw);
+                }
+                deck.sortBy(keys);
+                break;
+            }
+            case OP_LOAD: {
+                uint64_t size = in.read<uint64_t>();
+                if (size > in.remaining()) {
+                    throw runtime_error("Unexpected end of session trace");
+                }
+                vector<char> image(static_cast<size_t>(size));
+                in.readRaw(image.data(), image.size());
+                Deck loaded;
+                loaded.loadFromBuffer(image.data(), image.size());
+                deck.adoptDeck(loaded);
+                break;
+            }
+            case OP_CHECKPOINT: {
+                uint64_t expected = in.read<uint64_t>();
+                if (verifyCheckpoints) {
+                    if (SessionRecorder::stateHash(deck.snapshot()) != expected) {
+                        throw runtime_error("Replay diverged from the recording after operation "
+                                            + to_string(report.operations));
+                    }
+                    report.checkpoints++;
+                }
+                continue;
+            }
+            default:
+                throw runtime_error("Unknown operation " + to_string(op) + " in session trace");
+        }
+        report.operations++;
+    }
+
+    report.finalHash = SessionRecorder::stateHash(deck.snapshot());
+    report.finalSize = deck.getCurrentSize();
+    report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return report;
+}
@@ -0,0 +1,88 @@
+#ifndef SESSIONTRACE_H
+#define SESSIONTRACE_H
+
+#include "VersionedDeck.h"
+#include "CardSerialization.h"
+#include <fstream>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Operations a session trace records, one byte each, followed by their data
+enum SessionOp : uint8_t {
+    OP_ADD_CARD = 1,     // Typed card encoding, as in deck files
+    OP_SHUFFLE,          // uint64 seed
+    OP_DRAW,
+    OP_RETURN_DRAWN,     // Puts the last drawn card back on top
+    OP_UNDO,
+    OP_REDO,
+    OP_SORT,             // Key count, then one byte per key
+    OP_LOAD,             // Byte count, then a whole deck file
+    OP_CHECKPOINT        // uint64 state hash of the deck at this point
+};
+
+struct ReplayReport {
+    long long operations = 0;
+    long long checkpoints = 0;   // Verified checkpoints
+    uint64_t finalHash = 0;
+    int finalSize = 0;
+    double seconds = 0.0;
+};
+
+// Records every change made to a VersionedDeck in a compact binary trace,
+// including the seeds shuffles used, so a session can be re-run exactly.
+// Each record is written and flushed as one piece, so a crash loses at most
+// the operation in progress. Calls must follow the deck operations they
+// describe, and only after those succeeded.
+class SessionRecorder {
+private:
+    ofstream out;
+    string filename;
+    long long operations;
+
+public:
+    static const char MAGIC[8];
+
+    // Constructor; the deck's settings become the trace header
+    SessionRecorder(const string& traceFile, const VersionedDeck& deck);
+
+    void recordAddCard(const Card& card);
+    void recordShuffle(uint64_t seed);
+    void recordDraw();
+    void recordReturnDrawn();
+    void recordUndo();
+    void recordRedo();
+    void recordSort(const vector<DeckSortKey>& keys);
+    void recordLoad(const VersionedDeck& deck);   // Deck as it is right after the load
+    void checkpoint(const VersionedDeck& deck);
+
+    long long getOperationCount() const;
+    string getFilename() const;
+
+    // Hash of everything saved about the deck: settings, card order and card data
+    static uint64_t stateHash(const DeckSnapshot& deck);
+    static uint64_t freshSeed();
+
+private:
+    static ByteWriter startRecord(SessionOp op);
+    void writeRecord(const ByteWriter& record);
+    void writeOperation(const ByteWriter& record);   // A record that changes the deck
+};
+
+// Re-runs a recorded session against a fresh deck with no prompts. The trace
+// is read into memory once, so replays run at full speed and can be repeated
+// as a load test.
+class SessionReplayer {
+private:
+    vector<char> trace;
+
+public:
+    // Constructors
+    SessionReplayer(const string& traceFile);
+    SessionReplayer(vector<char> traceBytes);
+
+    // With verification, a checkpoint whose hash differs throws naming the operation
+    ReplayReport replay(bool verifyCheckpoints = true) const;
+};
+
+#endif // SESSIONTRACE_H
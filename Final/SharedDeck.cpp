@@ -0,0 +1,293 @@
+#include "SharedDeck.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(SharedCard) == 64, "SharedCard must fill one cache line");
+static_assert(atomic<uint64_t>::is_always_lock_free, "Shared memory needs lock-free 64-bit atomics");
+
+namespace {
+    const char MAGIC[8] = {'C', 'G', 'S', 'H', 'D', 'E', 'C', 'K'};
+    const size_t NAME_BYTES = 64;
+
+    struct SegmentHeader {
+        char magic[8];
+        uint32_t capacity;          // Cards per slot
+        uint32_t recordSize;        // sizeof(SharedCard) of the writer
+        atomic<uint32_t> current;   // Slot readers should use
+    };
+
+    struct alignas(64) SlotHeader {
+        atomic<uint64_t> sequence;  // Odd while the slot is being written
+        uint64_t version;
+        int32_t count;
+        int32_t maxSize;
+        int64_t totalValue;
+        char deckName[NAME_BYTES];
+        char owner[NAME_BYTES];
+    };
+
+    const size_t SLOTS_OFFSET = 64;
+    const size_t CARDS_OFFSET = SLOTS_OFFSET + 2 * sizeof(SlotHeader);
+
+    size_t segmentSize(uint32_t capacity) {
+        return CARDS_OFFSET + 2 * static_cast<size_t>(capacity) * sizeof(SharedCard);
+    }
+
+    SegmentHeader* segmentOf(void* mapping) {
+        return static_cast<SegmentHeader*>(mapping);
+    }
+
+    SlotHeader* slotOf(void* mapping, uint32_t slot) {
+        return reinterpret_cast<SlotHeader*>(static_cast<char*>(mapping) + SLOTS_OFFSET) + slot;
+    }
+
+    SharedCard* cardsOfSlot(void* mapping, uint32_t capacity, uint32_t slot) {
+        return reinterpret_cast<SharedCard*>(static_cast<char*>(mapping) + CARDS_OFFSET) + slot * capacity;
+    }
+
+    void copyName(char* target, const string& name) {
+        memset(target, 0, NAME_BYTES);
+        memcpy(target, name.data(), min(name.size(), NAME_BYTES - 1));
+    }
+
+    runtime_error systemError(const string& what) {
+        return runtime_error(what + ": " + strerror(errno));
+    }
+}
+
+// Constructor
+SharedDeckWriter::SharedDeckWriter(const string& name, int cardCapacity)
+    : segmentName(name), mapping(nullptr), mappingSize(0), capacity(0), version(0) {
+    if (cardCapacity < 1) {
+        throw runtime_error("Shared deck capacity must be positive");
+    }
+    capacity = static_cast<uint32_t>(cardCapacity);
+    mappingSize = segmentSize(capacity);
+
+    // Start from a fresh segment; readers still attached to an old one keep it
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw systemError("Cannot create shared memory " + name);
+    }
+    if (ftruncate(fd, static_cast<off_t>(mappingSize)) < 0) {
+        runtime_error error = systemError("Cannot size shared memory " + name);
+        close(fd);
+        shm_unlink(name.c_str());
+        throw error;
+    }
+    mapping = mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw systemError("Cannot map shared memory " + name);
+    }
+
+    // The new segment is zero-filled, so both slots start empty at sequence 0
+    SegmentHeader* header = segmentOf(mapping);
+    header->capacity = capacity;
+    header->recordSize = sizeof(SharedCard);
+    header->current.store(0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(header->magic, MAGIC, sizeof(MAGIC));
+}
+
+// Destructor
+SharedDeckWriter::~SharedDeckWriter() {
+    munmap(mapping, mappingSize);
+    shm_unlink(segmentName.c_str());
+}
+
+// Core functionality implementations
+void SharedDeckWriter::publish(const Deck& deck) {
+    if (deck.getCurrentSize() > static_cast<int>(capacity)) {
+        throw runtime_error("Deck has more cards than the shared segment holds");
+    }
+    staging.resize(deck.getCurrentSize());
+    for (int i = 0; i < deck.getCurrentSize(); i++) {
+        staging[i] = toShared(*deck.getCard(i));
+    }
+    publish(staging, deck.getDeckName(), deck.getOwner(), deck.getMaxSize());
+}
+
+void SharedDeckWriter::publish(const vector<SharedCard>& cards, const string& deckName, const string& owner,
+                               int maxSize) {
+    if (cards.size() > capacity) {
+        throw runtime_error("Deck has more cards than the shared segment holds");
+    }
+    int64_t totalValue = 0;
+    for (const auto& card : cards) {
+        totalValue += card.value;
+    }
+
+    // Fill the slot readers are not using, then send them to it
+    SegmentHeader* header = segmentOf(mapping);
+    uint32_t target = 1 - header->current.load(memory_order_relaxed);
+    SlotHeader* slot = slotOf(mapping, target);
+    uint64_t sequence = slot->sequence.load(memory_order_relaxed);
+    slot->sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+
+    slot->version = ++version;
+    slot->count = static_cast<int32_t>(cards.size());
+    slot->maxSize = maxSize;
+    slot->totalValue = totalValue;
+    copyName(slot->deckName, deckName);
+    copyName(slot->owner, owner);
+    if (!cards.empty()) {
+        memcpy(cardsOfSlot(mapping, capacity, target), cards.data(), cards.size() * sizeof(SharedCard));
+    }
+
+    slot->sequence.store(sequence + 2, memory_order_release);
+    header->current.store(target, memory_order_release);
+}
+
+uint64_t SharedDeckWriter::getVersion() const {
+    return version;
+}
+
+int SharedDeckWriter::getCapacity() const {
+    return static_cast<int>(capacity);
+}
+
+string SharedDeckWriter::getName() const {
+    return segmentName;
+}
+
+SharedCard SharedDeckWriter::toShared(const Card& card) {
+    CardTraits traits = CardTraits::fromCard(card);
+    SharedCard shared = {};
+    shared.value = traits.value;
+    shared.baseValue = card.getBaseValue();
+    shared.kind = traits.kind;
+    shared.suit = traits.suit;
+    shared.condition = traits.condition;
+    shared.rarity = traits.rarity;
+    shared.faceCard = traits.faceCard;
+    shared.foiled = traits.foiled;
+    string name = card.getName();
+    shared.nameLength = static_cast<uint8_t>(min(name.size(), sizeof(shared.name)));
+    memcpy(shared.name, name.data(), shared.nameLength);
+    return shared;
+}
+
+// Constructor
+SharedDeckReader::SharedDeckReader(const string& name) : mapping(nullptr), mappingSize(0), capacity(0) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw systemError("No shared deck published as " + name);
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < CARDS_OFFSET) {
+        close(fd);
+        throw runtime_error(name + " is not a shared deck");
+    }
+    mappingSize = static_cast<size_t>(info.st_size);
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw systemError("Cannot map shared memory " + name);
+    }
+
+    // The writer fills in the magic last, so the fields behind it are ready once it matches
+    const SegmentHeader* header = segmentOf(mapping);
+    bool ready = memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0;
+    atomic_thread_fence(memory_order_acquire);
+    if (!ready || header->recordSize != sizeof(SharedCard)
+        || segmentSize(header->capacity) > mappingSize) {
+        munmap(mapping, mappingSize);
+        throw runtime_error(name + " is not a shared deck in this format");
+    }
+    capacity = header->capacity;
+}
+
+// Destructor
+SharedDeckReader::~SharedDeckReader() {
+    munmap(mapping, mappingSize);
+}
+
+// Core functionality implementations
+SharedDeckInfo SharedDeckReader::snapshot(vector<SharedCard>& cards) const {
+    while (true) {
+        uint64_t sequence;
+        const void* slot = beginRead(sequence);
+        SharedDeckInfo result = infoOf(slot);
+        cards.assign(cardsOf(slot), cardsOf(slot) + countOf(slot));
+        if (endRead(slot, sequence)) {
+            return result;
+        }
+    }
+}
+
+SharedDeckInfo SharedDeckReader::info() const {
+    while (true) {
+        uint64_t sequence;
+        const void* slot = beginRead(sequence);
+        SharedDeckInfo result = infoOf(slot);
+        if (endRead(slot, sequence)) {
+            return result;
+        }
+    }
+}
+
+bool SharedDeckReader::getCard(int index, SharedCard& card) const {
+    if (index < 0) {
+        return false;
+    }
+    bool found = false;
+    read([&](const SharedCard* published, int count) {
+        found = index < count;
+        if (found) {
+            card = published[index];
+        }
+    });
+    return found;
+}
+
+int SharedDeckReader::getCapacity() const {
+    return static_cast<int>(capacity);
+}
+
+// Private helper implementations
+const void* SharedDeckReader::beginRead(uint64_t& sequence) const {
+    const SegmentHeader* header = segmentOf(mapping);
+    while (true) {
+        uint32_t current = header->current.load(memory_order_acquire) & 1;
+        const SlotHeader* slot = slotOf(mapping, current);
+        sequence = slot->sequence.load(memory_order_acquire);
+        if ((sequence & 1) == 0) {
+            return slot;
+        }
+    }
+}
+
+bool SharedDeckReader::endRead(const void* slot, uint64_t sequence) const {
+    atomic_thread_fence(memory_order_acquire);
+    return static_cast<const SlotHeader*>(slot)->sequence.load(memory_order_relaxed) == sequence;
+}
+
+SharedDeckInfo SharedDeckReader::infoOf(const void* slot) const {
+    const SlotHeader* header = static_cast<const SlotHeader*>(slot);
+    SharedDeckInfo result;
+    result.version = header->version;
+    result.count = countOf(slot);
+    result.maxSize = header->maxSize;
+    result.totalValue = header->totalValue;
+    result.deckName.assign(header->deckName, strnlen(header->deckName, NAME_BYTES));
+    result.owner.assign(header->owner, strnlen(header->owner, NAME_BYTES));
+    return result;
+}
+
+int SharedDeckReader::countOf(const void* slot) const {
+    int32_t count = static_cast<const SlotHeader*>(slot)->count;
+    return count < 0 ? 0 : min(count, static_cast<int32_t>(capacity));
+}
+
+const SharedCard* SharedDeckReader::cardsOf(const void* slot) const {
+    uint32_t index = static_cast<uint32_t>(static_cast<const SlotHeader*>(slot) - slotOf(mapping, 0));
+    return cardsOfSlot(mapping, capacity, index);
+}
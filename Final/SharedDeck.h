@@ -0,0 +1,124 @@
+#ifndef SHAREDDECK_H
+#define SHAREDDECK_H
+
+#include "Deck.h"
+#include "CardTraits.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One card as published to shared memory: its traits plus a truncated name,
+// in exactly one cache line
+struct SharedCard {
+    int32_t value;
+    int32_t baseValue;
+    CardKind kind;
+    int8_t suit;            // Index into CardTraits::SUIT_NAMES, or -1
+    uint8_t condition;
+    uint8_t rarity;
+    bool faceCard;
+    bool foiled;
+    uint8_t nameLength;
+    char name[49];          // Not NUL-terminated; nameLength bytes are used
+
+    string getName() const { return string(name, nameLength); }
+};
+
+// Deck settings published alongside the cards of one slot
+struct SharedDeckInfo {
+    uint64_t version = 0;   // Bumped by every publish
+    int32_t count = 0;
+    int32_t maxSize = 0;
+    int64_t totalValue = 0;
+    string deckName;
+    string owner;
+};
+
+// Publishes a deck into POSIX shared memory for readers in other processes.
+// The segment holds two slots of card records. A publish fills the slot
+// readers are not using and then points them at it, so readers are never
+// waited for and almost never see a publish in progress. Each slot also has
+// a sequence lock: it is odd while the slot is being written, so a reader
+// that raced a writer can tell and read again. Only one writer per name.
+class SharedDeckWriter {
+private:
+    string segmentName;
+    void* mapping;
+    size_t mappingSize;
+    uint32_t capacity;
+    uint64_t version;
+    vector<SharedCard> staging;
+
+public:
+    // Constructor; creates (or takes over) the segment. Names look like "/cardgame_deck".
+    SharedDeckWriter(const string& name, int cardCapacity);
+
+    // Destructor; removes the name. Readers that are attached keep their mapping.
+    ~SharedDeckWriter();
+
+    SharedDeckWriter(const SharedDeckWriter&) = delete;
+    SharedDeckWriter& operator=(const SharedDeckWriter&) = delete;
+
+    void publish(const Deck& deck);
+    void publish(const vector<SharedCard>& cards, const string& deckName, const string& owner, int maxSize);
+
+    uint64_t getVersion() const;
+    int getCapacity() const;
+    string getName() const;
+
+    static SharedCard toShared(const Card& card);
+};
+
+// Read-only view of a deck published by a SharedDeckWriter. Reads never
+// write to the segment, so any number of readers cost the writer nothing.
+class SharedDeckReader {
+private:
+    void* mapping;
+    size_t mappingSize;
+    uint32_t capacity;
+
+public:
+    // Constructor; throws if no deck is published under the name
+    SharedDeckReader(const string& name);
+
+    // Destructor
+    ~SharedDeckReader();
+
+    SharedDeckReader(const SharedDeckReader&) = delete;
+    SharedDeckReader& operator=(const SharedDeckReader&) = delete;
+
+    // Consistent copy of the settings and every card
+    SharedDeckInfo snapshot(vector<SharedCard>& cards) const;
+    SharedDeckInfo info() const;
+
+    // One card from a consistent version; returns false if index is past the end
+    bool getCard(int index, SharedCard& card) const;
+
+    // Runs visit(cards, count) over the published cards in place, without
+    // copying them. If a publish overtook the read, what visit saw may be
+    // torn, so visit runs again on the newer version; it must only look, not
+    // act, until read returns.
+    template<typename Visitor>
+    void read(Visitor visit) const {
+        while (true) {
+            uint64_t sequence;
+            const void* slot = beginRead(sequence);
+            visit(cardsOf(slot), countOf(slot));
+            if (endRead(slot, sequence)) {
+                return;
+            }
+        }
+    }
+
+    int getCapacity() const;
+
+private:
+    const void* beginRead(uint64_t& sequence) const;   // Waits out a write in progress
+    bool endRead(const void* slot, uint64_t sequence) const;
+    SharedDeckInfo infoOf(const void* slot) const;
+    int countOf(const void* slot) const;               // Clamped to the capacity
+    const SharedCard* cardsOf(const void* slot) const;
+};
+
+#endif // SHAREDDECK_H
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <iomanip>
+#include <csignal>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include "Deck.h"
+#include "SharedDeck.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+void handleSignal(int) {
+    stopRequested = 1;
+}
+
+void printUsage() {
+    cout << "Usage: deck_shm publish NAME FILE [--capacity N] [--interval MS]\n"
+         << "       deck_shm show NAME [--cards N]\n"
+         << "publish loads a saved .dat deck into shared memory under NAME (for example\n"
+         << "/cardgame_deck) and republishes it whenever the file changes, until\n"
+         << "interrupted. show prints the published deck from any other process." << endl;
+}
+
+int publishDeck(const string& name, const string& file, int capacity, int intervalMs) {
+    SharedDeckWriter writer(name, capacity);
+    signal(SIGINT, handleSignal);
+    signal(SIGTERM, handleSignal);
+    fs::file_time_type published;
+    while (!stopRequested) {
+        error_code error;
+        fs::file_time_type modified = fs::last_write_time(file, error);
+        if (!error && (writer.getVersion() == 0 || modified != published)) {
+            try {
+                Deck deck(capacity);
+                deck.loadFromBinary(file);
+                writer.publish(deck);
+                published = modified;
+                cout << "Published " << deck.getCurrentSize() << " cards from " << file
+                     << " as " << name << " (version " << writer.getVersion() << ")" << endl;
+            } catch (const runtime_error& e) {
+                // A save may be half written; try again on the next change
+                cerr << "Skipped " << file << ": " << e.what() << endl;
+                published = modified;
+            }
+        }
+        this_thread::sleep_for(chrono::milliseconds(intervalMs));
+    }
+    return 0;
+}
+
+int showDeck(const string& name, int cardsShown) {
+    SharedDeckReader reader(name);
+    vector<SharedCard> cards;
+    SharedDeckInfo info = reader.snapshot(cards);
+    cout << "Deck: " << info.deckName << " (Owner: " << info.owner << ", Cards: " << info.count
+         << "/" << info.maxSize << ", Total value: " << info.totalValue << ", Version: " << info.version << ")" << endl;
+    for (int i = info.count - 1; i >= max(0, info.count - cardsShown); i--) {
+        const SharedCard& card = cards[i];
+        cout << setw(6) << i << "  " << card.getName() << " (Value: " << card.value;
+        if (card.suit >= 0) cout << ", " << CardTraits::SUIT_NAMES[card.suit];
+        if (card.kind == KIND_GAME) cout << ", Rarity: " << static_cast<int>(card.rarity);
+        cout << ")" << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        if (argc >= 4 && string(argv[1]) == "publish") {
+            int capacity = 100000;
+            int intervalMs = 500;
+            for (int i = 4; i < argc; i++) {
+                string arg = argv[i];
+                if (arg == "--capacity" && i + 1 < argc) {
+                    capacity = stoi(argv[++i]);
+                } else if (arg == "--interval" && i + 1 < argc) {
+                    intervalMs = stoi(argv[++i]);
+                } else {
+                    printUsage();
+                    return 1;
+                }
+            }
+            return publishDeck(argv[2], argv[3], capacity, intervalMs);
+        }
+        if (argc >= 3 && string(argv[1]) == "show") {
+            int cardsShown = 10;
+            if (argc == 5 && string(argv[3]) == "--cards") {
+                cardsShown = stoi(argv[4]);
+            } else if (argc != 3) {
+                printUsage();
+                return 1;
+            }
+            return showDeck(argv[2], cardsShown);
+        }
+        printUsage();
+        return argc == 2 && string(argv[1]) == "--help" ? 0 : 1;
+    } catch (const exception& e) {
+        cerr << "Shared deck error: " << e.what() << endl;
+        return 1;
+    }
+}
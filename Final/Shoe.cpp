@@ -0,0 +1,182 @@
+#include "Shoe.h"
+#include <algorithm>
+
+// Constructor
+Shoe::Shoe(int size, double penetrationLevel, uint64_t seed)
+    : mask(0), head(0), count(0), maxSize(0), penetration(0.75), rng(seed) {
+    if (size <= 0) {
+        throw runtime_error("Shoe size must be positive");
+    }
+    maxSize = size;
+    setPenetration(penetrationLevel);
+    size_t length = 1;
+    while (length < static_cast<size_t>(size)) {
+        length <<= 1;
+    }
+    ring.assign(length, nullptr);
+    mask = length - 1;
+    discards.reserve(size);
+}
+
+// Destructor
+Shoe::~Shoe() {
+    for (size_t i = 0; i < count; i++) {
+        delete ring[slot(i)];
+    }
+    for (auto card : discards) {
+        delete card;
+    }
+}
+
+// Core functionality implementations
+void Shoe::addCard(Card* card) {
+    if (!card) {
+        throw runtime_error("Cannot add a missing card");
+    }
+    checkRoom();
+    ring[slot(count)] = card;
+    count++;
+}
+
+void Shoe::addToBottom(Card* card) {
+    if (!card) {
+        throw runtime_error("Cannot add a missing card");
+    }
+    checkRoom();
+    head = (head + mask) & mask;
+    ring[head] = card;
+    count++;
+}
+
+Card* Shoe::drawTop() {
+    if (count == 0) {
+        throw runtime_error("Cannot draw from empty shoe");
+    }
+    count--;
+    return ring[slot(count)];
+}
+
+Card* Shoe::drawBottom() {
+    if (count == 0) {
+        throw runtime_error("Cannot draw from empty shoe");
+    }
+    Card* card = ring[head];
+    head = (head + 1) & mask;
+    count--;
+    return card;
+}
+
+Card* Shoe::peek(int depth) const {
+    if (depth < 0 || static_cast<size_t>(depth) >= count) {
+        throw runtime_error("Peek depth is outside the shoe");
+    }
+    return ring[slot(count - 1 - depth)];
+}
+
+vector<Card*> Shoe::peekTop(int cardCount) const {
+    if (cardCount < 0 || static_cast<size_t>(cardCount) > count) {
+        throw runtime_error("Cannot peek at more cards than the shoe holds");
+    }
+    vector<Card*> cards(cardCount);
+    for (int i = 0; i < cardCount; i++) {
+        cards[i] = ring[slot(count - 1 - i)];
+    }
+    return cards;
+}
+
+void Shoe::burn(int cardCount) {
+    if (cardCount < 0 || static_cast<size_t>(cardCount) > count) {
+        throw runtime_error("Cannot burn more cards than the shoe holds");
+    }
+    for (int i = 0; i < cardCount; i++) {
+        count--;
+        discards.push_back(ring[slot(count)]);
+    }
+}
+
+void Shoe::discard(Card* card) {
+    if (!card) {
+        throw runtime_error("Cannot discard a missing card");
+    }
+    checkRoom();
+    discards.push_back(card);
+}
+
+bool Shoe::needsReshuffle() const {
+    return !discards.empty() && getDealtFraction() >= penetration;
+}
+
+void Shoe::reshuffle() {
+    if (count + discards.size() == 0) {
+        throw runtime_error("Cannot shuffle empty shoe");
+    }
+    // Line the cards up from slot 0 so the whole shoe is one contiguous run
+    rotate(ring.begin(), ring.begin() + head, ring.end());
+    head = 0;
+    copy(discards.begin(), discards.end(), ring.begin() + count);
+    count += discards.size();
+    discards.clear();
+    std::shuffle(ring.begin(), ring.begin() + count, rng);
+}
+
+bool Shoe::reshuffleIfNeeded() {
+    if (!needsReshuffle()) {
+        return false;
+    }
+    reshuffle();
+    return true;
+}
+
+// Accessor and mutator implementations with validation
+int Shoe::getMaxSize() const {
+    return maxSize;
+}
+
+int Shoe::getCurrentSize() const {
+    return static_cast<int>(count);
+}
+
+int Shoe::getDiscardSize() const {
+    return static_cast<int>(discards.size());
+}
+
+bool Shoe::isEmpty() const {
+    return count == 0;
+}
+
+bool Shoe::isFull() const {
+    return count + discards.size() >= static_cast<size_t>(maxSize);
+}
+
+void Shoe::setPenetration(double level) {
+    if (!(level > 0.0 && level <= 1.0)) {
+        throw runtime_error("Penetration must be greater than 0 and at most 1");
+    }
+    penetration = level;
+}
+
+double Shoe::getPenetration() const {
+    return penetration;
+}
+
+double Shoe::getDealtFraction() const {
+    size_t total = count + discards.size();
+    return total == 0 ? 0.0 : static_cast<double>(discards.size()) / total;
+}
+
+ostream& operator<<(ostream& os, const Shoe& shoe) {
+    os << "Shoe: " << shoe.getCurrentSize() << "/" << shoe.getMaxSize() << " cards, "
+       << shoe.getDiscardSize() << " discarded";
+    return os;
+}
+
+// Private helper implementations
+size_t Shoe::slot(size_t fromBottom) const {
+    return (head + fromBottom) & mask;
+}
+
+void Shoe::checkRoom() const {
+    if (isFull()) {
+        throw runtime_error("Shoe is full");
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef SHOE_H
+#define SHOE_H
+
+#include "Card.h"
+#include <vector>
+#include <cstdint>
+#include <random>
+
+// Casino-style dealing shoe. Cards sit in a ring buffer sized once at
+// construction, so drawing from or returning to either end is O(1) and never
+// reallocates. Dealt and burned cards go to an attached discard pile; once the
+// share of cards dealt reaches the penetration, reshuffle() folds the pile
+// back in. The shoe owns every card in it and in its discard pile.
+class Shoe {
+private:
+    vector<Card*> ring;        // Power-of-two length; slot (head + i) & mask is i-th from the bottom
+    size_t mask;
+    size_t head;
+    size_t count;
+    vector<Card*> discards;    // Reserved to the capacity, so discarding never allocates
+    int maxSize;
+    double penetration;        // Fraction of the cards dealt before a reshuffle is due
+    mt19937_64 rng;
+
+public:
+    // Constructor
+    Shoe(int size = 312, double penetrationLevel = 0.75, uint64_t seed = random_device{}());
+
+    // Destructor
+    ~Shoe();
+
+    Shoe(const Shoe&) = delete;
+    Shoe& operator=(const Shoe&) = delete;
+
+    // Core functionality
+    void addCard(Card* card);          // Onto the top
+    void addToBottom(Card* card);
+    Card* drawTop();
+    Card* drawBottom();
+    Card* peek(int depth) const;       // 0 is the top card; the shoe keeps it
+    vector<Card*> peekTop(int count) const;
+    void burn(int count);              // Top cards go straight to the discard pile
+    void discard(Card* card);          // A played card leaves the table
+    bool needsReshuffle() const;
+    void reshuffle();                  // Discards back in, then shuffle everything
+    bool reshuffleIfNeeded();
+
+    // Accessors and mutators with validation
+    int getMaxSize() const;
+    int getCurrentSize() const;
+    int getDiscardSize() const;
+    bool isEmpty() const;
+    bool isFull() const;
+    void setPenetration(double level);
+    double getPenetration() const;
+    double getDealtFraction() const;   // Share of all cards currently in the discard pile
+
+    friend ostream& operator<<(ostream& os, const Shoe& shoe);
+
+private:
+    size_t slot(size_t fromBottom) const;
+    void checkRoom() const;
+};
+
+#endif // SHOE_H
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <string>
+#include "PlayingCard.h"
+#include "Deck.h"
+#include "GameSimulator.h"
+
+using namespace std;
+
+// Builds the standard 52-card deck: 2-10 at face value, J/Q/K/A as 11-14
+void buildStandardDeck(Deck& deck) {
+    const string suits[] = {"Hearts", "Diamonds", "Clubs", "Spades"};
+    const string ranks[] = {"2", "3", "4", "5", "6", "7", "8", "9", "10", "Jack", "Queen", "King", "Ace"};
+    for (const auto& suit : suits) {
+        for (int r = 0; r < 13; r++) {
+            bool face = r >= 9 && r <= 11;
+            deck.addCard(new PlayingCard(ranks[r] + " of " + suit, r + 2, suit, face));
+        }
+    }
+}
+
+void printUsage() {
+    cout << "Usage: game_sim [--games N] [--threads T] [--seed S] [--deck FILE]\n"
+         << "Plays N independent high-card games (default 1000000) across T threads\n"
+         << "(default: all cores) and reports games/sec, outcomes and per-card win rates.\n"
+         << "--deck simulates with a saved .dat deck instead of a standard 52-card deck." << endl;
+}
+
+int main(int argc, char* argv[]) {
+    long long games = 1000000;
+    int threads = 0;
+    uint64_t seed = 2024;
+    string deckFile;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--games" && hasValue) {
+                games = stoll(argv[++i]);
+            } else if (arg == "--threads" && hasValue) {
+                threads = stoi(argv[++i]);
+            } else if (arg == "--seed" && hasValue) {
+                seed = stoull(argv[++i]);
+            } else if (arg == "--deck" && hasValue) {
+                deckFile = argv[++i];
+            } else {
+                printUsage();
+                return arg == "--help" ? 0 : 1;
+            }
+        }
+
+        Deck deck(100000, "Simulation Deck", "Simulator");
+        if (deckFile.empty()) {
+            buildStandardDeck(deck);
+        } else {
+            deck.loadFromBinary(deckFile);
+        }
+
+        GameSimulator simulator(deck);
+        SimulationStats stats = simulator.run(games, seed, threads);
+        simulator.printReport(stats, cout);
+    } catch (const exception& e) {
+        cerr << "Simulation error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -2,36 +2,36 @@
 #define SPECIALCARD_H
 
 #include "Card.h"
+#include "MemoryReport.h"
 #include <sstream>
+#include <type_traits>
 
-template<typename T>
-class SpecialCard : public Card {
-private:
-    T specialEffect;
+// State every special card has regardless of its effect type. Kept outside
+// the template so code such as EffectTicker can update durability and power
+// of any SpecialCard<T> through one pointer type.
+class SpecialCardBase : public Card {
+protected:
     int durability;
     string cardType;     // Type of special card
     double powerLevel;   // Power level of the effect
 
 public:
     // Constructor
-    SpecialCard(string name = "", int value = 0, T effect = T(), int dur = 1, 
-                string type = "Magic", double power = 1.0)
-        : Card(name, value), specialEffect(effect), durability(dur), 
-          cardType(type), powerLevel(power) {
+    SpecialCardBase(string name, int value, int dur, string type, double power)
+        : Card(name, value), durability(dur), cardType(type), powerLevel(power) {
         setDurability(dur);
         setPowerLevel(power);
         setCardType(type);
     }
 
-    // Virtual function implementations
-    void display() const override {
-        cout << getName() << " (" << cardType << " Card)" << endl;
-        cout << "Special Effect: " << specialEffect << endl;
-        cout << "Durability: " << durability << ", Power Level: " << powerLevel << endl;
+    int getValue() const override {
+        return cachedValueOr([this] { return static_cast<int>(cardValue * durability * powerLevel); });
     }
 
-    int getValue() const override {
-        return static_cast<int>(cardValue * durability * powerLevel);
+    void addMemoryUsage(CardMemory& usage) const override {
+        Card::addMemoryUsage(usage);
+        usage.objectBytes = sizeof(SpecialCardBase);
+        usage.addString(cardType);
     }
 
     // Accessors and mutators with validation
@@ -40,10 +40,7 @@ public:
             throw runtime_error("Durability must be positive");
         }
         durability = dur;
-    }
-
-    void setSpecialEffect(const T& effect) {
-        specialEffect = effect;
+        invalidateValue();
     }
 
     void setCardType(string type) {
@@ -58,12 +55,57 @@ public:
             throw runtime_error("Power level must be between 0.1 and 10.0");
         }
         powerLevel = power;
+        invalidateValue();
     }
 
-    T getSpecialEffect() const { return specialEffect; }
     int getDurability() const { return durability; }
     string getCardType() const { return cardType; }
     double getPowerLevel() const { return powerLevel; }
+};
+
+// Heap owned by a special effect; effects that own heap data beyond a string
+// can add an overload so memory reports count it
+inline void addEffectMemory(CardMemory& usage, const string& effect) {
+    usage.addString(effect);
+}
+
+template<typename T>
+void addEffectMemory(CardMemory&, const T&) {}
+
+template<typename T>
+class SpecialCard : public SpecialCardBase {
+private:
+    T specialEffect;
+
+public:
+    // Constructor
+    SpecialCard(string name = "", int value = 0, T effect = T(), int dur = 1, 
+                string type = "Magic", double power = 1.0)
+        : SpecialCardBase(name, value, dur, type, power), specialEffect(effect) {}
+
+    // Virtual function implementations
+    void display() const override {
+        cout << getName() << " (" << cardType << " Card)" << endl;
+        cout << "Special Effect: " << specialEffect << endl;
+        cout << "Durability: " << durability << ", Power Level: " << powerLevel << endl;
+    }
+
+    Card* clone() const override {
+        return new SpecialCard<T>(*this);
+    }
+
+    void addMemoryUsage(CardMemory& usage) const override {
+        SpecialCardBase::addMemoryUsage(usage);
+        usage.objectBytes = sizeof(SpecialCard<T>);
+        addEffectMemory(usage, specialEffect);
+    }
+
+    // Accessors and mutators
+    void setSpecialEffect(const T& effect) {
+        specialEffect = effect;
+    }
+
+    T getSpecialEffect() const { return specialEffect; }
 
     // Operator overloading (BOTH required)
     friend ostream& operator<<(ostream& os, const SpecialCard<T>& card) {
@@ -87,7 +129,11 @@ public:
         is >> value;
         cout << "Enter special effect: ";
         is.ignore();
-        getline(is, reinterpret_cast<string&>(effect));
+        if constexpr (is_same<T, string>::value) {
+            getline(is, effect);    // Effects may contain spaces
+        } else {
+            is >> effect;
+        }
         cout << "Enter durability: ";
         is >> dur;
         cout << "Enter card type: ";
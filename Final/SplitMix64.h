@@ -0,0 +1,37 @@
+#ifndef SPLITMIX64_H
+#define SPLITMIX64_H
+
+#include <cstdint>
+
+// Small, fast generator for per-task randomness (SplitMix64). Seeding it from
+// the run seed and a game or trial number makes results reproducible no matter
+// which worker thread does the work.
+class SplitMix64 {
+private:
+    uint64_t state;
+
+public:
+    explicit SplitMix64(uint64_t seed = 0) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform integer in [0, bound): the high half of the 128-bit product
+    uint64_t nextBelow(uint64_t bound) {
+#if defined(__SIZEOF_INT128__)
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+#else
+        uint64_t value = next();
+        uint64_t lowProduct = (value & 0xFFFFFFFFULL) * (bound & 0xFFFFFFFFULL);
+        uint64_t cross1 = (value >> 32) * (bound & 0xFFFFFFFFULL);
+        uint64_t cross2 = (value & 0xFFFFFFFFULL) * (bound >> 32) + (cross1 & 0xFFFFFFFFULL) + (lowProduct >> 32);
+        return (value >> 32) * (bound >> 32) + (cross1 >> 32) + (cross2 >> 32);
+#endif
+    }
+};
+
+#endif // SPLITMIX64_H
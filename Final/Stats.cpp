@@ -0,0 +1,209 @@
+#include "Stats.h"
+#include <iomanip>
+#include <algorithm>
+
+static const char* STAT_TIMER_NAMES[STAT_TIMER_COUNT] = {
+    "deck_addCard",
+    "deck_drawCard",
+    "deck_shuffle",
+    "deck_displayAllCards",
+    "deck_saveToBinary",
+    "deck_loadFromBinary",
+    "filemanager_refreshFileList",
+    "effectticker_tick"
+};
+
+static const bool STAT_TIMER_SAMPLED[STAT_TIMER_COUNT] = {
+    true, true, false, false, false, false, false, false
+};
+
+static const char* STAT_COUNTER_NAMES[STAT_COUNTER_COUNT] = {
+    "bytes_written",
+    "bytes_read",
+    "files_scanned"
+};
+
+// Constructor
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds, uint64_t weight) {
+    buckets[bucketIndex(nanoseconds)] += weight;
+    count += weight;
+    total += nanoseconds * weight;
+    minValue = min(minValue, nanoseconds);
+    maxValue = max(maxValue, nanoseconds);
+}
+
+void LatencyHistogram::reset() {
+    fill(begin(buckets), end(buckets), 0);
+    count = 0;
+    total = 0;
+    minValue = UINT64_MAX;
+    maxValue = 0;
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return count;
+}
+
+uint64_t LatencyHistogram::getMin() const {
+    return count == 0 ? 0 : minValue;
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return maxValue;
+}
+
+double LatencyHistogram::getMean() const {
+    return count == 0 ? 0.0 : static_cast<double>(total) / static_cast<double>(count);
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+    double target = percentile / 100.0 * static_cast<double>(count);
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i];
+        if (buckets[i] > 0 && static_cast<double>(seen) >= target) {
+            // Bucket midpoints can fall outside the observed range at the extremes
+            return min(max(bucketMidpoint(i), getMin()), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < 32) {
+        return static_cast<int>(value);
+    }
+    value = min<uint64_t>(value, (1ULL << 48) - 1);
+    int msb = highestSetBit(value);
+    int exponent = msb - 4;
+    int mantissa = static_cast<int>(value >> exponent);   // 16..31
+    return 32 + (exponent - 1) * 16 + (mantissa - 16);
+}
+
+uint64_t LatencyHistogram::bucketMidpoint(int index) {
+    if (index < 32) {
+        return static_cast<uint64_t>(index);
+    }
+    int exponent = (index - 32) / 16 + 1;
+    uint64_t mantissa = static_cast<uint64_t>((index - 32) % 16 + 16);
+    return (mantissa << exponent) + (1ULL << (exponent - 1));
+}
+
+// Registry implementations
+StatsRegistry::StatsRegistry() {
+    fill(begin(calls), end(calls), 0);
+    for (auto& counter : counters) {
+        counter.store(0);
+    }
+}
+
+StatsRegistry& StatsRegistry::instance() {
+    static StatsRegistry registry;
+    return registry;
+}
+
+bool StatsRegistry::isEnabled() {
+#ifdef CARDGAME_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void StatsRegistry::recordTime(StatTimer timer, uint64_t nanoseconds, uint64_t weight) {
+    lock_guard<mutex> guard(lock);
+    timers[timer].record(nanoseconds);
+    calls[timer] += weight;
+}
+
+void StatsRegistry::addCount(StatCounter counter, uint64_t amount) {
+    counters[counter].fetch_add(amount, memory_order_relaxed);
+}
+
+void StatsRegistry::reset() {
+    lock_guard<mutex> guard(lock);
+    for (int i = 0; i < STAT_TIMER_COUNT; i++) {
+        timers[i].reset();
+        calls[i] = 0;
+    }
+    for (auto& counter : counters) {
+        counter.store(0);
+    }
+}
+
+__attribute__((noinline, cold)) int64_t StatsRegistry::nowNanoseconds() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+__attribute__((noinline, cold)) void StatsRegistry::finishSample(StatTimer timer, int64_t startNanoseconds, uint64_t weight) {
+    instance().recordTime(timer, nowNanoseconds() - startNanoseconds, weight);
+}
+
+// Reporting implementations
+void StatsRegistry::printReport(ostream& os) const {
+    if (!isEnabled()) {
+        os << "Statistics are disabled in this build (configure with -DCARDGAME_STATS=ON)." << endl;
+        return;
+    }
+
+    lock_guard<mutex> guard(lock);
+    os << left << setw(30) << "Operation" << right << setw(10) << "Calls"
+       << setw(12) << "Mean us" << setw(12) << "p50 us" << setw(12) << "p99 us"
+       << setw(12) << "Max us" << endl;
+    os << string(88, '-') << endl;
+    for (int i = 0; i < STAT_TIMER_COUNT; i++) {
+        const LatencyHistogram& h = timers[i];
+        string name = STAT_TIMER_NAMES[i];
+        if (STAT_TIMER_SAMPLED[i]) name += " *";
+        os << left << setw(30) << name << right << setw(10) << calls[i]
+           << fixed << setprecision(3)
+           << setw(12) << h.getMean() / 1e3
+           << setw(12) << h.getPercentile(50) / 1e3
+           << setw(12) << h.getPercentile(99) / 1e3
+           << setw(12) << h.getMax() / 1e3 << endl;
+    }
+    os << "* timed on the first call and then once every " << SAMPLE_PERIOD
+       << " calls per thread; calls are counted up to the last sample" << endl;
+
+    os << endl;
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+        os << left << setw(30) << STAT_COUNTER_NAMES[i] << right << setw(10)
+           << counters[i].load(memory_order_relaxed) << endl;
+    }
+}
+
+void StatsRegistry::writeJson(ostream& os) const {
+    lock_guard<mutex> guard(lock);
+    os << "{\n  \"enabled\": " << (isEnabled() ? "true" : "false") << ",\n";
+    os << "  \"sample_period\": " << SAMPLE_PERIOD << ",\n";
+    os << "  \"timers\": [\n";
+    for (int i = 0; i < STAT_TIMER_COUNT; i++) {
+        const LatencyHistogram& h = timers[i];
+        os << "    {\"name\": \"" << STAT_TIMER_NAMES[i] << "\""
+           << ", \"sampled\": " << (STAT_TIMER_SAMPLED[i] ? "true" : "false")
+           << ", \"calls\": " << calls[i]
+           << ", \"samples\": " << h.getCount()
+           << ", \"min_ns\": " << h.getMin()
+           << ", \"mean_ns\": " << fixed << setprecision(1) << h.getMean()
+           << ", \"p50_ns\": " << h.getPercentile(50)
+           << ", \"p90_ns\": " << h.getPercentile(90)
+           << ", \"p99_ns\": " << h.getPercentile(99)
+           << ", \"p999_ns\": " << h.getPercentile(99.9)
+           << ", \"max_ns\": " << h.getMax() << "}";
+        os << (i + 1 < STAT_TIMER_COUNT ? ",\n" : "\n");
+    }
+    os << "  ],\n  \"counters\": {";
+    for (int i = 0; i < STAT_COUNTER_COUNT; i++) {
+        os << (i == 0 ? "" : ", ") << "\"" << STAT_COUNTER_NAMES[i] << "\": "
+           << counters[i].load(memory_order_relaxed);
+    }
+    os << "}\n}\n";
+}
@@ -0,0 +1,151 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "BitOps.h"
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// Timed operations. Keep STAT_TIMER_NAMES in Stats.cpp in the same order.
+enum StatTimer {
+    TIMER_DECK_ADD,
+    TIMER_DECK_DRAW,
+    TIMER_DECK_SHUFFLE,
+    TIMER_DECK_DISPLAY,
+    TIMER_DECK_SAVE,
+    TIMER_DECK_LOAD,
+    TIMER_FILE_SCAN,
+    TIMER_EFFECT_TICK,
+    STAT_TIMER_COUNT
+};
+
+// Plain event/byte counters. Keep STAT_COUNTER_NAMES in Stats.cpp in the same order.
+enum StatCounter {
+    COUNTER_BYTES_WRITTEN,
+    COUNTER_BYTES_READ,
+    COUNTER_FILES_SCANNED,
+    STAT_COUNTER_COUNT
+};
+
+// Log-linear latency histogram in the style of HdrHistogram: every power of two
+// is split into 16 linear sub-buckets, giving ~6% worst-case relative error.
+class LatencyHistogram {
+public:
+    static const int BUCKET_COUNT = 32 + 44 * 16;
+
+private:
+    uint64_t buckets[BUCKET_COUNT];
+    uint64_t count;
+    uint64_t total;
+    uint64_t minValue;
+    uint64_t maxValue;
+
+public:
+    // Constructor
+    LatencyHistogram();
+
+    void record(uint64_t nanoseconds, uint64_t weight = 1);
+    void reset();
+
+    uint64_t getCount() const;
+    uint64_t getMin() const;
+    uint64_t getMax() const;
+    double getMean() const;
+    uint64_t getPercentile(double percentile) const;
+
+private:
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketMidpoint(int index);
+};
+
+class StatsRegistry {
+public:
+    // Cheap per-call operations are only timed on the first call and then once
+    // every SAMPLE_PERIOD calls, counted per thread
+    static const uint32_t SAMPLE_PERIOD = 4096;
+
+    // Per-thread call counts for SampledTimer; no sharing, so no atomics
+    inline static thread_local uint64_t sampledCalls[STAT_TIMER_COUNT] = {};
+
+private:
+    mutable mutex lock;
+    LatencyHistogram timers[STAT_TIMER_COUNT];
+    uint64_t calls[STAT_TIMER_COUNT];
+    atomic<uint64_t> counters[STAT_COUNTER_COUNT];
+
+    StatsRegistry();
+
+public:
+    static StatsRegistry& instance();
+    static bool isEnabled();
+
+    // Records one call (or weight calls, when sampled) that took the given time
+    void recordTime(StatTimer timer, uint64_t nanoseconds, uint64_t weight = 1);
+    void addCount(StatCounter counter, uint64_t amount);
+    void reset();
+
+    // Out-of-line helpers for SampledTimer so its fast path stays a single test
+    static int64_t nowNanoseconds();
+    static void finishSample(StatTimer timer, int64_t startNanoseconds, uint64_t weight);
+
+    // Reporting
+    void printReport(ostream& os) const;
+    void writeJson(ostream& os) const;
+};
+
+// Times the enclosing scope on every call
+class ScopedTimer {
+private:
+    StatTimer timer;
+    chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(StatTimer t) : timer(t), start(chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto elapsed = chrono::steady_clock::now() - start;
+        StatsRegistry::instance().recordTime(timer,
+            chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+    }
+};
+
+// Times the first call on each thread and then one in every SAMPLE_PERIOD. The
+// call counter is thread-local, so deciding whether to sample costs an increment
+// and a test. Each sample stands for the calls since the previous one.
+class SampledTimer {
+private:
+    StatTimer timer;
+    int64_t startNs;     // Zero when this call is not being sampled
+    uint64_t call;       // This thread's call number for the timer, from zero
+
+public:
+    explicit SampledTimer(StatTimer t)
+        : timer(t), call(StatsRegistry::sampledCalls[t]++) {
+        startNs = CARDGAME_UNLIKELY(call % StatsRegistry::SAMPLE_PERIOD == 0)
+                  ? StatsRegistry::nowNanoseconds() : 0;
+    }
+    ~SampledTimer() {
+        if (CARDGAME_UNLIKELY(startNs != 0)) {
+            StatsRegistry::finishSample(timer, startNs, call == 0 ? 1 : StatsRegistry::SAMPLE_PERIOD);
+        }
+    }
+};
+
+// Instrumentation macros; they compile to nothing unless CARDGAME_STATS is defined
+#ifdef CARDGAME_STATS
+#define STATS_JOIN_(a, b) a##b
+#define STATS_JOIN(a, b) STATS_JOIN_(a, b)
+#define STATS_TIMER(t) ScopedTimer STATS_JOIN(statsTimer_, __LINE__)(t)
+#define STATS_SAMPLED_TIMER(t) SampledTimer STATS_JOIN(statsTimer_, __LINE__)(t)
+#define STATS_COUNT(c, n) StatsRegistry::instance().addCount((c), (n))
+#else
+#define STATS_TIMER(t) ((void)0)
+#define STATS_SAMPLED_TIMER(t) ((void)0)
+#define STATS_COUNT(c, n) ((void)0)
+#endif
+
+#endif // STATS_H
@@ -0,0 +1,353 @@
+#include "VersionedDeck.h"
+#include "SplitMix64.h"
+#include "Stats.h"
+#include "CardSerialization.h"
+#include <ctime>
+#include <algorithm>
+
+// DeckSnapshot implementations
+DeckSnapshot::DeckSnapshot(const CardTrie& trie, int size, string name, string ownr)
+    : cards(trie), maxSize(size), deckName(name), owner(ownr) {}
+
+int DeckSnapshot::getMaxSize() const {
+    return maxSize;
+}
+
+string DeckSnapshot::getDeckName() const {
+    return deckName;
+}
+
+string DeckSnapshot::getOwner() const {
+    return owner;
+}
+
+int DeckSnapshot::getCurrentSize() const {
+    return cards.size();
+}
+
+bool DeckSnapshot::isEmpty() const {
+    return cards.empty();
+}
+
+const Card& DeckSnapshot::getCard(int index) const {
+    return *cards.get(index);
+}
+
+void DeckSnapshot::saveToBinary(const string& filename) const {
+    STATS_TIMER(TIMER_DECK_SAVE);
+    if (filename.empty()) {
+        throw runtime_error("Filename cannot be empty");
+    }
+
+    ByteWriter out;
+    writeTo(out);
+    out.saveToFile(filename);
+}
+
+void DeckSnapshot::writeTo(ByteWriter& out) const {
+    const CardTypeRegistry& registry = CardTypeRegistry::instance();
+    out.reserve(out.size() + 64 + cards.size() * 48);
+    DeckFormat::writeHeader(out, deckName, owner, maxSize, getCurrentSize());
+    for (const auto& card : cards.toVector()) {
+        registry.encode(*card, out);
+    }
+}
+
+// Constructor implementation with validation
+VersionedDeck::VersionedDeck(int size, string name, string ownr)
+    : maxSize(size), deckName(name), owner(ownr), historyLimit(DEFAULT_HISTORY_LIMIT), revision(0),
+      cachedTotalValue(0), totalValueGeneration(UINT64_MAX) {
+    if (size < 1) {
+        throw runtime_error("Deck size must be positive");
+    }
+    if (name.empty()) {
+        throw runtime_error("Deck name cannot be empty");
+    }
+    if (ownr.empty()) {
+        throw runtime_error("Owner name cannot be empty");
+    }
+}
+
+// Core functionality implementations
+void VersionedDeck::addCard(Card* card) {
+    if (!card) {
+        throw runtime_error("Cannot add null card to deck");
+    }
+    if (isFull()) {
+        throw runtime_error("Deck is full - cannot add more cards");
+    }
+    addCard(shared_ptr<Card>(card));
+}
+
+void VersionedDeck::addCard(shared_ptr<Card> card) {
+    if (isFull()) {
+        throw runtime_error("Deck is full - cannot add more cards");
+    }
+    if (!card) {
+        throw runtime_error("Cannot add null card to deck");
+    }
+    STATS_SAMPLED_TIMER(TIMER_DECK_ADD);
+    recordVersion();
+    cards.pushBack(move(card));
+}
+
+void VersionedDeck::shuffle() {
+    shuffle(static_cast<uint64_t>(time(0)) ^ reinterpret_cast<uintptr_t>(this));
+}
+
+void VersionedDeck::shuffle(uint64_t seed) {
+    STATS_TIMER(TIMER_DECK_SHUFFLE);
+    if (isEmpty()) {
+        throw runtime_error("Cannot shuffle empty deck");
+    }
+    recordVersion();
+    vector<CardTrie::CardPtr> order = cards.toVector();
+    SplitMix64 rng(seed);
+    for (size_t i = order.size() - 1; i > 0; i--) {
+        swap(order[i], order[rng.nextBelow(i + 1)]);
+    }
+    cards = CardTrie::fromVector(order);
+}
+
+void VersionedDeck::sortBy(const vector<DeckSortKey>& keys) {
+    vector<CardTrie::CardPtr> current = cards.toVector();
+    vector<Card*> raw(current.size());
+    for (size_t i = 0; i < current.size(); i++) {
+        raw[i] = current[i].get();
+    }
+    vector<uint32_t> order = DeckSorter::sortedOrder(raw, keys);
+
+    recordVersion();
+    vector<CardTrie::CardPtr> sorted(current.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        sorted[i] = current[order[i]];
+    }
+    cards = CardTrie::fromVector(sorted);
+}
+
+void VersionedDeck::displayAllCards() const {
+    STATS_TIMER(TIMER_DECK_DISPLAY);
+    if (isEmpty()) {
+        cout << "Deck is empty." << endl;
+        return;
+    }
+
+    cout << "\n=== " << deckName << " (Owner: " << owner << ") ===" << endl;
+    cout << "Cards in deck (" << getCurrentSize() << "/" << maxSize << "):\n" << endl;
+
+    vector<CardTrie::CardPtr> order = cards.toVector();
+    for (size_t i = 0; i < order.size(); i++) {
+        cout << "Card " << (i + 1) << ": ";
+        order[i]->display();
+        cout << "Value: " << order[i]->getValue() << endl;
+        cout << "-------------------" << endl;
+    }
+}
+
+shared_ptr<Card> VersionedDeck::drawCard() {
+    if (isEmpty()) {
+        throw runtime_error("Cannot draw from empty deck");
+    }
+    STATS_SAMPLED_TIMER(TIMER_DECK_DRAW);
+    recordVersion();
+    return cards.popBack();
+}
+
+// Versioning implementations
+DeckSnapshot VersionedDeck::snapshot() const {
+    return DeckSnapshot(cards, maxSize, deckName, owner);
+}
+
+void VersionedDeck::restore(const DeckSnapshot& version) {
+    recordVersion();
+    apply(version);
+}
+
+bool VersionedDeck::undo() {
+    if (undoHistory.empty()) {
+        return false;
+    }
+    redoHistory.push_back(snapshot());
+    apply(undoHistory.back());
+    undoHistory.pop_back();
+    return true;
+}
+
+bool VersionedDeck::redo() {
+    if (redoHistory.empty()) {
+        return false;
+    }
+    undoHistory.push_back(snapshot());
+    apply(redoHistory.back());
+    redoHistory.pop_back();
+    return true;
+}
+
+bool VersionedDeck::canUndo() const {
+    return !undoHistory.empty();
+}
+
+bool VersionedDeck::canRedo() const {
+    return !redoHistory.empty();
+}
+
+void VersionedDeck::clearHistory() {
+    undoHistory.clear();
+    redoHistory.clear();
+}
+
+void VersionedDeck::setHistoryLimit(int limit) {
+    if (limit < 0) {
+        throw runtime_error("History limit cannot be negative");
+    }
+    historyLimit = limit;
+    while (static_cast<int>(undoHistory.size()) > historyLimit) {
+        undoHistory.pop_front();
+    }
+}
+
+int VersionedDeck::getHistoryLimit() const {
+    return historyLimit;
+}
+
+long long VersionedDeck::getRevision() const {
+    return revision;
+}
+
+long long VersionedDeck::getTotalValue() const {
+    // Cards can also change through shared_ptrs handed out by drawCard(), so
+    // the card value epoch counts as well as the deck's own revision
+    uint64_t generation = static_cast<uint64_t>(revision) + Card::getValueEpoch();
+    if (generation != totalValueGeneration) {
+        long long total = 0;
+        for (const auto& card : cards.toVector()) {
+            total += card->getValue();
+        }
+        cachedTotalValue = total;
+        totalValueGeneration = generation;
+    }
+    return cachedTotalValue;
+}
+
+// Conversion implementations
+void VersionedDeck::adoptDeck(Deck& deck) {
+    vector<CardTrie::CardPtr> order(deck.getCurrentSize());
+    for (size_t i = order.size(); i > 0; i--) {
+        order[i - 1] = shared_ptr<Card>(deck.drawCard());
+    }
+    recordVersion();
+    cards = CardTrie::fromVector(order);
+    maxSize = max(deck.getMaxSize(), getCurrentSize());
+    deckName = deck.getDeckName();
+    owner = deck.getOwner();
+}
+
+void VersionedDeck::copyTo(Deck& deck) const {
+    if (!deck.isEmpty()) {
+        throw runtime_error("Target deck must be empty");
+    }
+    deck.setMaxSize(maxSize);
+    deck.setDeckName(deckName);
+    deck.setOwner(owner);
+    for (const auto& card : cards.toVector()) {
+        deck.addCard(card->clone());
+    }
+}
+
+// Accessor and mutator implementations with validation
+void VersionedDeck::setMaxSize(int size) {
+    if (size < 1) {
+        throw runtime_error("Deck size must be positive");
+    }
+    if (size < getCurrentSize()) {
+        throw runtime_error("New max size cannot be less than current number of cards");
+    }
+    recordVersion();
+    maxSize = size;
+}
+
+int VersionedDeck::getMaxSize() const {
+    return maxSize;
+}
+
+void VersionedDeck::setDeckName(string name) {
+    if (name.empty()) {
+        throw runtime_error("Deck name cannot be empty");
+    }
+    recordVersion();
+    deckName = name;
+}
+
+string VersionedDeck::getDeckName() const {
+    return deckName;
+}
+
+void VersionedDeck::setOwner(string ownr) {
+    if (ownr.empty()) {
+        throw runtime_error("Owner name cannot be empty");
+    }
+    recordVersion();
+    owner = ownr;
+}
+
+string VersionedDeck::getOwner() const {
+    return owner;
+}
+
+int VersionedDeck::getCurrentSize() const {
+    return cards.size();
+}
+
+bool VersionedDeck::isEmpty() const {
+    return cards.empty();
+}
+
+bool VersionedDeck::isFull() const {
+    return cards.size() >= maxSize;
+}
+
+const Card& VersionedDeck::getCard(int index) const {
+    return *cards.get(index);
+}
+
+// File operation implementations
+void VersionedDeck::saveToBinary(const string& filename) const {
+    snapshot().saveToBinary(filename);
+}
+
+void VersionedDeck::loadFromBinary(const string& filename) {
+    // Load into a scratch deck first so a bad file leaves this one untouched
+    Deck loaded;
+    loaded.loadFromBinary(filename);
+    adoptDeck(loaded);
+}
+
+// Operator overloading implementations
+ostream& operator<<(ostream& os, const VersionedDeck& deck) {
+    os << "Deck: " << deck.deckName
+       << " (Owner: " << deck.owner
+       << ", Cards: " << deck.getCurrentSize()
+       << "/" << deck.maxSize << ")";
+    return os;
+}
+
+// Private helper implementations
+void VersionedDeck::recordVersion() {
+    revision++;
+    redoHistory.clear();
+    if (historyLimit == 0) {
+        return;
+    }
+    if (static_cast<int>(undoHistory.size()) >= historyLimit) {
+        undoHistory.pop_front();
+    }
+    undoHistory.push_back(snapshot());
+}
+
+void VersionedDeck::apply(const DeckSnapshot& version) {
+    revision++;
+    cards = version.cards;
+    maxSize = version.maxSize;
+    deckName = version.deckName;
+    owner = version.owner;
+}
@@ -0,0 +1,117 @@
+#ifndef VERSIONEDDECK_H
+#define VERSIONEDDECK_H
+
+#include "Card.h"
+#include "CardTrie.h"
+#include "Deck.h"
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+
+class ByteWriter;
+
+// Immutable view of a VersionedDeck at one moment. Taking one is O(1) and it
+// shares every card and trie node with the live deck, so it can be handed to
+// another thread to read or save while the deck keeps changing.
+class DeckSnapshot {
+private:
+    CardTrie cards;
+    int maxSize;
+    string deckName;
+    string owner;
+
+public:
+    // Constructor
+    DeckSnapshot(const CardTrie& trie, int size, string name, string ownr);
+
+    // Accessors
+    int getMaxSize() const;
+    string getDeckName() const;
+    string getOwner() const;
+    int getCurrentSize() const;
+    bool isEmpty() const;
+    const Card& getCard(int index) const;
+
+    // Writes the same format as Deck::saveToBinary
+    void saveToBinary(const string& filename) const;
+    void writeTo(ByteWriter& out) const;      // Same bytes, appended to out
+
+    friend class VersionedDeck;
+};
+
+// Deck with copy-on-write storage and undo/redo. Cards are shared between the
+// live deck and its snapshots and must not be modified once added. Every
+// change records the previous version, which costs O(1) because versions share
+// structure; a change only copies the trie path it touches.
+class VersionedDeck {
+public:
+    static const int DEFAULT_HISTORY_LIMIT = 100;
+
+private:
+    CardTrie cards;
+    int maxSize;
+    string deckName;
+    string owner;
+    deque<DeckSnapshot> undoHistory;
+    vector<DeckSnapshot> redoHistory;
+    int historyLimit;
+    long long revision;     // Bumped on every change, undo and redo
+    mutable long long cachedTotalValue;
+    mutable uint64_t totalValueGeneration;
+
+public:
+    // Constructor
+    VersionedDeck(int size = 52, string name = "Standard Deck", string ownr = "Player");
+
+    // Core functionality
+    void addCard(Card* card);               // Takes ownership
+    void addCard(shared_ptr<Card> card);
+    void shuffle();
+    void shuffle(uint64_t seed);            // Same seed and cards give the same order
+    void sortBy(const vector<DeckSortKey>& keys);   // Stable; smallest card first
+    void displayAllCards() const;
+    shared_ptr<Card> drawCard();            // Remove and return top card
+
+    // Versioning
+    DeckSnapshot snapshot() const;
+    void restore(const DeckSnapshot& version);   // Undoable
+    bool undo();
+    bool redo();
+    bool canUndo() const;
+    bool canRedo() const;
+    void clearHistory();
+    void setHistoryLimit(int limit);
+    int getHistoryLimit() const;
+    long long getRevision() const;
+
+    // Conversion to and from plain decks
+    void adoptDeck(Deck& deck);             // Moves every card out of deck; undoable
+    void copyTo(Deck& deck) const;          // Fills an empty deck with copies
+
+    // Accessors and mutators with validation
+    void setMaxSize(int size);
+    int getMaxSize() const;
+    void setDeckName(string name);
+    string getDeckName() const;
+    void setOwner(string ownr);
+    string getOwner() const;
+    int getCurrentSize() const;
+    bool isEmpty() const;
+    bool isFull() const;
+    const Card& getCard(int index) const;
+    long long getTotalValue() const;        // Sum of getValue(); recomputed only after changes
+
+    // File operations
+    void saveToBinary(const string& filename) const;
+    void loadFromBinary(const string& filename);   // Leaves the deck unchanged on failure
+
+    // Operator overloading
+    friend ostream& operator<<(ostream& os, const VersionedDeck& deck);
+
+private:
+    void recordVersion();
+    void apply(const DeckSnapshot& version);
+};
+
+#endif // VERSIONEDDECK_H
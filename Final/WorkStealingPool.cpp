@@ -0,0 +1,222 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <map>
+
+// Constructor implementation with validation
+WorkStealingPool::WorkStealingPool(int threads)
+    : jobNumber(0), jobBody(nullptr), jobGrain(1), busyWorkers(0), stopping(false),
+      remaining(0), queued(0), parked(0) {
+    if (threads < 0) {
+        throw runtime_error("Thread count cannot be negative");
+    }
+    if (threads == 0) {
+        threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    threadCount = threads;
+    for (int i = 0; i < threadCount; i++) {
+        queues.push_back(make_unique<WorkerQueue>());
+    }
+    for (int i = 1; i < threadCount; i++) {
+        workers.emplace_back(&WorkStealingPool::threadMain, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        lock_guard<mutex> guard(jobLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+WorkStealingPool& WorkStealingPool::shared(int threads) {
+    static mutex poolsLock;
+    static map<int, unique_ptr<WorkStealingPool>> pools;
+    if (threads < 0) {
+        throw runtime_error("Thread count cannot be negative");
+    }
+    lock_guard<mutex> guard(poolsLock);
+    unique_ptr<WorkStealingPool>& pool = pools[threads];
+    if (!pool) {
+        pool.reset(new WorkStealingPool(threads));
+    }
+    return *pool;
+}
+
+// Core functionality implementation
+void WorkStealingPool::parallelFor(long long count, long long grain, const RangeBody& body) {
+    if (count < 0) {
+        throw runtime_error("Range count cannot be negative");
+    }
+    if (grain < 1) {
+        throw runtime_error("Grain size must be positive");
+    }
+    if (count == 0) {
+        return;
+    }
+    if (threadCount == 1) {
+        // Nothing to share out, and no reason to make other callers wait
+        for (long long begin = 0; begin < count; begin += grain) {
+            body(0, begin, min(count, begin + grain));
+        }
+        return;
+    }
+    lock_guard<mutex> call(callLock);
+
+    // Seed every worker with one contiguous slice; stealing evens out the rest.
+    // Every worker has left the previous job, so nobody else touches the deques.
+    long long slice = (count + threadCount - 1) / threadCount;
+    long long seeded = 0;
+    for (int i = 0; i < threadCount; i++) {
+        long long begin = min(count, slice * i);
+        long long end = min(count, begin + slice);
+        queues[i]->ranges.clear();
+        if (begin < end) {
+            queues[i]->ranges.push_back({begin, end});
+            seeded++;
+        }
+    }
+    queued.store(seeded);
+    remaining.store(count);
+
+    {
+        lock_guard<mutex> guard(jobLock);
+        jobBody = &body;
+        jobGrain = grain;
+        failure = nullptr;
+        busyWorkers = threadCount - 1;
+        jobNumber++;
+    }
+    wake.notify_all();
+
+    runWorker(0);
+
+    exception_ptr thrown;
+    {
+        unique_lock<mutex> guard(jobLock);
+        idle.wait(guard, [this]() { return busyWorkers == 0; });
+        jobBody = nullptr;
+        thrown = failure;
+        failure = nullptr;
+    }
+    if (thrown) {
+        rethrow_exception(thrown);
+    }
+}
+
+int WorkStealingPool::getThreadCount() const {
+    return threadCount;
+}
+
+// Private helper implementations
+void WorkStealingPool::threadMain(int worker) {
+    uint64_t seenJob = 0;
+    unique_lock<mutex> guard(jobLock);
+    while (true) {
+        wake.wait(guard, [&]() { return stopping || jobNumber != seenJob; });
+        if (stopping) {
+            return;
+        }
+        seenJob = jobNumber;
+        guard.unlock();
+        runWorker(worker);
+        guard.lock();
+        if (--busyWorkers == 0) {
+            idle.notify_one();
+        }
+    }
+}
+
+void WorkStealingPool::runWorker(int worker) {
+    try {
+        workerLoop(worker);
+    } catch (...) {
+        {
+            lock_guard<mutex> guard(jobLock);
+            if (!failure) failure = current_exception();
+        }
+        // Let everyone else stop instead of waiting for work that will never finish
+        remaining.store(0);
+        wakeParked();
+    }
+}
+
+void WorkStealingPool::workerLoop(int worker) {
+    Range range;
+    while (remaining.load(memory_order_acquire) > 0) {
+        if (!popLocal(worker, range) && !steal(worker, range)) {
+            waitForWork();
+            continue;
+        }
+        // Keep the first half, publish the rest for thieves
+        while (range.end - range.begin > jobGrain) {
+            long long mid = range.begin + (range.end - range.begin) / 2;
+            pushLocal(worker, {mid, range.end});
+            range.end = mid;
+        }
+        (*jobBody)(worker, range.begin, range.end);
+        long long done = range.end - range.begin;
+        if (remaining.fetch_sub(done, memory_order_acq_rel) == done) {
+            wakeParked();
+        }
+    }
+}
+
+void WorkStealingPool::waitForWork() {
+    // parked and queued are both sequentially consistent: either a pusher sees
+    // this worker parked and notifies under the lock, or the test below sees its range
+    unique_lock<mutex> guard(jobLock);
+    parked.fetch_add(1);
+    work.wait(guard, [this]() { return queued.load() > 0 || remaining.load() <= 0; });
+    parked.fetch_sub(1);
+}
+
+void WorkStealingPool::wakeParked() {
+    {
+        lock_guard<mutex> guard(jobLock);
+    }
+    work.notify_all();
+}
+
+bool WorkStealingPool::popLocal(int worker, Range& range) {
+    WorkerQueue& queue = *queues[worker];
+    lock_guard<mutex> guard(queue.lock);
+    if (queue.ranges.empty()) {
+        return false;
+    }
+    range = queue.ranges.back();
+    queue.ranges.pop_back();
+    queued.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingPool::steal(int thief, Range& range) {
+    for (int offset = 1; offset < threadCount; offset++) {
+        WorkerQueue& victim = *queues[(thief + offset) % threadCount];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.ranges.empty()) {
+            range = victim.ranges.front();
+            victim.ranges.pop_front();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::pushLocal(int worker, const Range& range) {
+    WorkerQueue& queue = *queues[worker];
+    {
+        lock_guard<mutex> guard(queue.lock);
+        queue.ranges.push_back(range);
+    }
+    queued.fetch_add(1);
+    if (parked.load() > 0) {
+        lock_guard<mutex> guard(jobLock);
+        work.notify_one();
+    }
+}
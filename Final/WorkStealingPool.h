@@ -0,0 +1,86 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <deque>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <memory>
+#include <functional>
+#include <exception>
+
+using namespace std;
+
+// Runs index ranges across worker threads. Each worker owns a deque of ranges:
+// it splits its current range down to the grain size, pushing the other halves
+// onto the back of its own deque, and idle workers steal the largest pending
+// range from the front of someone else's. The threads are started once and
+// park on a condition variable between jobs and while there is nothing to
+// steal; the calling thread works as worker 0.
+class WorkStealingPool {
+public:
+    // Body receives the worker number (0..threads-1) and a half-open index range
+    using RangeBody = function<void(int worker, long long begin, long long end)>;
+
+private:
+    struct Range {
+        long long begin;
+        long long end;
+    };
+
+    struct WorkerQueue {
+        mutex lock;
+        deque<Range> ranges;
+    };
+
+    int threadCount;
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> workers;              // Workers 1..threadCount-1
+
+    mutex callLock;                      // One parallelFor at a time
+    mutex jobLock;                       // Guards the job fields and the parking below
+    condition_variable wake;             // New job or stopping
+    condition_variable work;             // New stealable range, or the job is done
+    condition_variable idle;             // Every worker has left the current job
+    uint64_t jobNumber;
+    const RangeBody* jobBody;
+    long long jobGrain;
+    int busyWorkers;
+    bool stopping;
+    exception_ptr failure;
+
+    atomic<long long> remaining;         // Indices not yet run in the current job
+    atomic<long long> queued;            // Ranges sitting in the deques
+    atomic<int> parked;                  // Workers waiting for something to steal
+
+public:
+    // Constructor; zero threads means one per hardware thread
+    WorkStealingPool(int threads = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Process-wide pool for the given thread count, started on first use
+    static WorkStealingPool& shared(int threads = 0);
+
+    // Calls body over [0, count) in chunks of at most grain indices; returns when all are done.
+    // Concurrent calls take turns unless the pool has one thread; body must not call back into it.
+    void parallelFor(long long count, long long grain, const RangeBody& body);
+
+    int getThreadCount() const;
+
+private:
+    void threadMain(int worker);
+    void runWorker(int worker);
+    void workerLoop(int worker);
+    void waitForWork();
+    void wakeParked();
+    bool popLocal(int worker, Range& range);
+    bool steal(int thief, Range& range);
+    void pushLocal(int worker, const Range& range);
+};
+
+#endif // WORKSTEALINGPOOL_H